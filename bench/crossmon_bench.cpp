@@ -0,0 +1,374 @@
+// Microbenchmarks for the sampling path: collectors, statistics and summary
+// formatters. Results are written as JSON so runs of two builds can be diffed:
+//
+//   crossmon_bench -o before.json
+//   crossmon_bench -o after.json --filter stats
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "cpu_monitor.hpp"
+#include "memory_monitor.hpp"
+#include "gpu_monitor.hpp"
+#include "utils/console_line.hpp"
+#include "utils/host_info.hpp"
+#include "utils/output_formatter.hpp"
+#include "utils/self_usage.hpp"
+#include "utils/statistics.hpp"
+#ifdef __linux__
+#include "process_monitor.hpp"
+#include "utils/process_table.hpp"
+#include "utils/process_tree.hpp"
+#include <unistd.h>
+#endif
+
+#ifndef CROSSMON_BUILD_TYPE
+#define CROSSMON_BUILD_TYPE ""
+#endif
+
+ICpuMonitor* createCpuMonitor();
+IMemoryMonitor* createMemoryMonitor();
+IGpuMonitor* createGpuMonitor();
+
+namespace {
+// Keeps a result alive so the optimizer cannot drop the call that produced it
+template <typename T>
+void keep(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchResult {
+    std::string group;
+    std::string name;
+    std::size_t size = 0;        // Samples per call for the statistics benchmarks, else 0
+    std::size_t iterations = 0;  // Calls per repetition
+    double nsPerOp = 0.0;        // Median over the repetitions
+    double minNsPerOp = 0.0;
+};
+
+/**
+ * Times fn in repetitions long enough to span minTime each and reports the
+ * median and fastest per-call cost. Calls that take longer than minTime on
+ * their own run once per repetition.
+ */
+class Harness {
+public:
+    Harness(std::chrono::nanoseconds minTime, std::string filter)
+        : minTime_(minTime), filter_(std::move(filter)) {}
+
+    template <typename Fn>
+    void run(const std::string& group, const std::string& name, std::size_t size, Fn&& fn) {
+        if (!filter_.empty() && (group + "/" + name).find(filter_) == std::string::npos) return;
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        fn(); // Warm-up, also sizes the repetitions
+        double once = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::size_t iterations = std::max<std::size_t>(1, static_cast<std::size_t>(minTime_.count() / std::max(once, 1.0)));
+        int repetitions = iterations == 1 ? 3 : 5;
+
+        std::vector<double> perOp;
+        for (int r = 0; r < repetitions; ++r) {
+            start = Clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) fn();
+            double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            perOp.push_back(elapsed / static_cast<double>(iterations));
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        BenchResult result;
+        result.group = group;
+        result.name = name;
+        result.size = size;
+        result.iterations = iterations;
+        result.nsPerOp = perOp[perOp.size() / 2];
+        result.minNsPerOp = perOp.front();
+        std::cerr << group << "/" << name;
+        if (size > 0) std::cerr << "[" << size << "]";
+        std::cerr << ": " << result.nsPerOp << " ns/op" << std::endl;
+        results_.push_back(std::move(result));
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+private:
+    std::chrono::nanoseconds minTime_;
+    std::string filter_;
+    std::vector<BenchResult> results_;
+};
+
+// Swallows std::cout while the console formatters are timed
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Deterministic utilization-like values in [0, 100)
+std::vector<double> makeSeries(std::size_t n, uint64_t seed) {
+    std::vector<double> values(n);
+    uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (double& value : values) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        value = static_cast<double>(state % 10000) / 100.0;
+    }
+    return values;
+}
+
+void benchCollectors(Harness& harness) {
+    ICpuMonitor* cpu = createCpuMonitor();
+    IMemoryMonitor* memory = createMemoryMonitor();
+    IGpuMonitor* gpu = createGpuMonitor();
+    std::vector<double> cores(cpu->getCoreCount());
+
+    harness.run("collectors", "cpu.getCpuBusy", 0, [&] { keep(cpu->getCpuBusy()); });
+    harness.run("collectors", "cpu.getPerCoreBusy", 0, [&] { keep(cpu->getPerCoreBusy(cores.data(), cores.size())); });
+    harness.run("collectors", "memory.getMemoryUsage", 0, [&] { keep(memory->getMemoryUsage()); });
+    harness.run("collectors", "gpu.getGpuUsage", 0, [&] { keep(gpu->getGpuUsage()); });
+    // Per-tick cost of the overhead accounting itself
+    SelfUsageReader self;
+    SelfUsage usage;
+    harness.run("collectors", "self.threadCpuTimeNs", 0, [&] { keep(threadCpuTimeNs()); });
+    harness.run("collectors", "self.SelfUsageReader.read", 0, [&] { keep(self.read(usage)); });
+#ifdef __linux__
+    IProcessMonitor* process = createLinuxProcessMonitor("/proc");
+    process->track({static_cast<int>(getpid())});
+    harness.run("collectors", "process.getProcessUsage", 0, [&] { keep(process->getProcessUsage()); });
+    ProcessTree tree;
+    std::vector<int> roots{static_cast<int>(getpid())};
+    harness.run("collectors", "process_tree.refresh", 0, [&] { keep(tree.refresh(roots)); });
+    ProcessTable table;
+    std::vector<TopProcess> top;
+    harness.run("collectors", "process_table.refresh_top10", 0, [&] {
+        table.refresh();
+        table.topByCpu(10, top);
+        table.topByRss(10, top);
+        keep(top.data());
+    });
+    delete process;
+#endif
+    delete cpu;
+    delete memory;
+    delete gpu;
+}
+
+void benchStatistics(Harness& harness, std::size_t maxSamples) {
+    for (std::size_t n : {std::size_t(1000), std::size_t(1000000), std::size_t(10000000)}) {
+        if (n > maxSamples) break;
+        std::vector<double> values = makeSeries(n, 1);
+        std::vector<uint64_t> usedMB(n);
+        for (std::size_t i = 0; i < n; ++i) usedMB[i] = 4096 + static_cast<uint64_t>(values[i] * 40.0);
+
+        harness.run("stats", "computeCpuStats", n, [&] { keep(computeCpuStats(values)); });
+        harness.run("stats", "computeMemoryStats", n, [&] { keep(computeMemoryStats(usedMB, values)); });
+        harness.run("stats", "computeGpuStats", n, [&] { keep(computeGpuStats(values, 1)); });
+        harness.run("stats", "computeNpuStats", n, [&] { keep(computeNpuStats(values, "NPU")); });
+        // What a live run pays instead: one accumulator update per sample
+        harness.run("stats", "RunningStats+QuantileSketch.add", n, [&] {
+            RunningStats running;
+            QuantileSketch sketch;
+            for (double value : values) {
+                running.add(value);
+                sketch.add(value);
+            }
+            keep(computePercentiles(sketch));
+            keep(computeCpuStats(running));
+        });
+    }
+}
+
+// A summary the size of a one-hour, 1 Hz run on a 16-core host with two GPUs
+SystemStats makeSummary() {
+    std::vector<double> values = makeSeries(3600, 2);
+    RunningStats running;
+    QuantileSketch sketch;
+    for (double value : values) {
+        running.add(value);
+        sketch.add(value);
+    }
+    SystemStats stats;
+    stats.cpu = computeCpuStats(running);
+    stats.cpu.percentiles = computePercentiles(sketch);
+    stats.cpu.corePeak.assign(16, 97.5);
+    stats.cpu.coreAverage.assign(16, 41.25);
+    stats.memory = computeMemoryStats(running, running);
+    stats.gpu = computeGpuStats(running, 2);
+    stats.gpu.devicePeak = {88.0, 12.5};
+    stats.gpu.deviceAverage = {40.0, 3.5};
+    stats.process.name = "firefox";
+    stats.process.samples = 3600;
+    stats.process.peakProcesses = 12;
+    stats.process.peakCpu = 180.5;
+    stats.process.avgCpu = 35.25;
+    stats.process.peakRssKB = 2097152;
+    stats.process.avgRssKB = 1572864;
+    stats.latency.samples = 3600;
+    stats.timing.ticks = 3600;
+    stats.timing.intervalMs = 1000.0;
+    return stats;
+}
+
+void benchFormatters(Harness& harness) {
+    SystemStats stats = makeSummary();
+    NullBuffer null;
+    std::streambuf* saved = std::cout.rdbuf(&null);
+    harness.run("formatters", "console.printSystemStatsToConsole", 0, [&] { printSystemStatsToConsole(stats); });
+    std::cout.rdbuf(saved);
+
+    LineBuffer line;
+    MemoryUsage memory = {};
+    memory.usedPhysicalMB = 8192;
+    memory.totalPhysicalMB = 16384;
+    memory.usedPercentage = 50.0;
+    GpuUsage gpu;
+    gpu.gpus.resize(2);
+    gpu.averageUtilization = 12.5;
+    double cpu = 42.5;
+    harness.run("formatters", "console.formatTickLine", 0, [&] {
+        line.clear();
+        formatTickLine(line, &cpu, &memory, &gpu, nullptr);
+        keep(line.size());
+    });
+
+    SummaryBuffer buffer;
+    const std::pair<const char*, OutputFormat> formats[] = {
+        {"buffer.text", OutputFormat::Text}, {"buffer.json", OutputFormat::Json},
+        {"buffer.csv", OutputFormat::Csv}, {"buffer.kv", OutputFormat::Kv}};
+    for (const auto& format : formats) {
+        harness.run("formatters", format.first, 0, [&] {
+            formatSystemStats(stats, format.second, buffer);
+            keep(buffer.size());
+        });
+    }
+
+    // The file writers also confirm on std::cout
+    std::string path = (std::filesystem::temp_directory_path() / "crossmon_bench_summary").string();
+    saved = std::cout.rdbuf(&null);
+    harness.run("formatters", "file.writeSystemStatsToFile.text", 0,
+                [&] { writeSystemStatsToFile(stats, path, OutputFormat::Text); });
+    harness.run("formatters", "file.writeSystemStatsToFile.json", 0,
+                [&] { writeSystemStatsToFile(stats, path, OutputFormat::Json); });
+    std::cout.rdbuf(saved);
+    std::filesystem::remove(path);
+}
+
+void appendJsonString(SummaryBuffer& out, const std::string& text) {
+    out.append("\"");
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            char escaped[2] = {'\\', c};
+            out.append(escaped, 2);
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            out.append(&c, 1);
+        }
+    }
+    out.append("\"");
+}
+
+void formatResults(const std::vector<BenchResult>& results, SummaryBuffer& out) {
+    HostInfo host = queryHostInfo();
+    out.append("{\n  \"schema_version\": 1,\n  \"host\": {\"name\": ");
+    appendJsonString(out, host.hostName);
+    out.append(", \"kernel\": ");
+    appendJsonString(out, host.kernel);
+    out.append(", \"cpu_model\": ");
+    appendJsonString(out, host.cpuModel);
+    out.append("},\n  \"build\": {\"type\": ");
+    appendJsonString(out, CROSSMON_BUILD_TYPE);
+    out.append(", \"compiler\": ");
+#if defined(__clang__)
+    appendJsonString(out, std::string("clang ") + __clang_version__);
+#elif defined(__GNUC__)
+    appendJsonString(out, std::string("gcc ") + __VERSION__);
+#elif defined(_MSC_VER)
+    appendJsonString(out, "msvc " + std::to_string(_MSC_VER));
+#else
+    appendJsonString(out, "unknown");
+#endif
+    out.append("},\n  \"benchmarks\": [");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out.append(i == 0 ? "\n    {\"group\": " : ",\n    {\"group\": ");
+        appendJsonString(out, r.group);
+        out.append(", \"name\": ");
+        appendJsonString(out, r.name);
+        out.append(", \"size\": ");
+        out.appendUint(r.size);
+        out.append(", \"iterations\": ");
+        out.appendUint(r.iterations);
+        out.append(", \"ns_per_op\": ");
+        out.appendDouble(r.nsPerOp);
+        out.append(", \"min_ns_per_op\": ");
+        out.appendDouble(r.minNsPerOp);
+        out.append("}");
+    }
+    out.append("\n  ]\n}\n");
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  -o FILE               Write the JSON results to FILE (default: stdout)\n";
+    std::cout << "  --filter TEXT         Only run benchmarks whose group/name contains TEXT\n";
+    std::cout << "  --max-samples N       Largest statistics input, of 1000, 1000000 and 10000000\n";
+    std::cout << "                        (default: 10000000)\n";
+    std::cout << "  --min-time-ms N       Minimum length of each timed repetition (default: 50)\n";
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::string outputPath;
+    std::string filter;
+    std::size_t maxSamples = 10000000;
+    long minTimeMs = 50;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--max-samples") == 0 && i + 1 < argc) {
+            maxSamples = static_cast<std::size_t>(std::stoull(argv[++i]));
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            minTimeMs = std::stol(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Error: unknown or incomplete option " << argv[i] << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Harness harness(std::chrono::milliseconds(minTimeMs), filter);
+    benchCollectors(harness);
+    benchStatistics(harness, maxSamples);
+    benchFormatters(harness);
+
+    SummaryBuffer out;
+    formatResults(harness.results(), out);
+    if (outputPath.empty()) {
+        std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+        return 0;
+    }
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        std::cerr << "Failed to write " << outputPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,6 +1,10 @@
 #pragma once
 #include <cstdint>
 #include <chrono>
+#include <cstddef>
+#ifdef __linux__
+#include <string>
+#endif
 
 class ICpuMonitor {
 public:
@@ -9,4 +13,20 @@ public:
     virtual double getCpuBusy() = 0;
     // Returns true if this monitor is supported on the current platform
     virtual bool isSupported() const = 0;
-}; 
\ No newline at end of file
+
+    // Returns the number of logical cores reported by getPerCoreBusy (0 if unsupported)
+    virtual std::size_t getCoreCount() const { return 0; }
+    // Writes per-core busy percentages (0.0 - 100.0) into out[0..n) without allocating,
+    // where n = min(capacity, getCoreCount()), and returns n
+    virtual std::size_t getPerCoreBusy(double* out, std::size_t capacity) {
+        (void)out;
+        (void)capacity;
+        return 0;
+    }
+};
+
+#ifdef __linux__
+// Linux monitor reading <procRoot>/stat; procRoot is "/proc" in production and
+// may point at a fixture tree in tests
+ICpuMonitor* createLinuxCpuMonitor(const std::string& procRoot);
+#endif
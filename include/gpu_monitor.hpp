@@ -36,6 +36,7 @@ public:
  * of the IGpuMonitor interface. The actual implementation depends on the target platform:
  * - Windows: Uses WMI (Windows Management Instrumentation) and DXGI for GPU monitoring
  * - macOS: Uses IOKit framework for GPU information access
+ * - Linux: Uses DRM sysfs attributes and per-client fdinfo engine counters
  * 
  * The caller is responsible for managing the lifetime of the returned monitor instance.
  * 
@@ -43,3 +44,14 @@ public:
  *         GPU monitoring is not supported on the current platform
  */
 IGpuMonitor* createGpuMonitor();
+
+#ifdef __linux__
+// Linux monitor for the DRM cards under <sysRoot>/class/drm. Utilization comes
+// from gpu_busy_percent where the driver has it and otherwise from the
+// drm-engine-* counters of the clients in <procRoot>/PID/fdinfo; temperature
+// and power come from the card's hwmon. Both roots may point at a fixture
+// tree; clockNs (monotonic nanoseconds, steady_clock when null) lets tests
+// drive the interval the engine and energy deltas are divided by.
+IGpuMonitor* createLinuxGpuMonitor(const std::string& sysRoot, const std::string& procRoot,
+                                   uint64_t (*clockNs)() = nullptr);
+#endif
@@ -1,5 +1,9 @@
 #pragma once
 #include <cstdint>
+#ifdef __linux__
+#include <cstddef>
+#include <string>
+#endif
 
 struct MemoryUsage {
     uint64_t totalPhysicalMB;    // Total physical RAM in MB
@@ -10,6 +14,13 @@ struct MemoryUsage {
     uint64_t totalVirtualMB;     // Total virtual memory in MB
     uint64_t availableVirtualMB; // Available virtual memory in MB
     uint64_t usedVirtualMB;      // Used virtual memory in MB
+
+    // Kernel memory breakdown (0 where the platform does not report it)
+    uint64_t pageCacheMB;        // File-backed page cache in MB
+    uint64_t buffersMB;          // Block device buffers in MB
+    uint64_t dirtyMB;            // Dirty pages waiting for writeback in MB
+    uint64_t writebackMB;        // Pages under active writeback in MB
+    uint64_t shmemMB;            // Shared memory and tmpfs in MB
 };
 
 class IMemoryMonitor {
@@ -22,3 +33,11 @@ public:
     // Returns true if this monitor is supported on the current platform
     virtual bool isSupported() const = 0;
 };
+
+#ifdef __linux__
+// Linux monitor reading <procRoot>/meminfo; procRoot may point at a fixture tree
+IMemoryMonitor* createLinuxMemoryMonitor(const std::string& procRoot);
+
+// Parses /proc/meminfo text in a single pass. Returns false if MemTotal is missing.
+bool parseMeminfo(const char* text, std::size_t length, MemoryUsage& usage);
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#ifdef __linux__
+#include <string>
+#endif
+
+// Resource use of the monitored application, summed over all of its processes
+struct ProcessUsage {
+    std::size_t processes = 0;   // Tracked processes still alive
+    double cpuPercent = 0.0;     // user + system time over the interval; 100% is one fully busy core
+    uint64_t rssKB = 0;          // Resident set size
+    uint64_t pssKB = 0;          // Proportional set size (shared pages split between sharers)
+    uint64_t minorFaults = 0;    // Faults during the interval
+    uint64_t majorFaults = 0;
+    uint64_t readBytes = 0;      // Storage I/O during the interval
+    uint64_t writeBytes = 0;
+};
+
+class IProcessMonitor {
+public:
+    virtual ~IProcessMonitor() = default;
+
+    // Replaces the set of tracked process IDs; processes that stay tracked keep
+    // their baselines, new ones are counted from the next sample
+    virtual void track(const std::vector<int>& pids) = 0;
+
+    // Samples every tracked process; ones that have exited are dropped
+    virtual ProcessUsage getProcessUsage() = 0;
+
+    // Returns true if this monitor is supported on the current platform
+    virtual bool isSupported() const = 0;
+};
+
+#ifdef __linux__
+// Linux monitor reading <procRoot>/stat and <procRoot>/PID/{stat,smaps_rollup,io};
+// procRoot is "/proc" in production and may point at a fixture tree in tests
+IProcessMonitor* createLinuxProcessMonitor(const std::string& procRoot);
+#endif
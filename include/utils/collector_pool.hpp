@@ -0,0 +1,56 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs a fixed set of collector jobs concurrently on persistent threads.
+ *
+ * Job 0 runs on the calling thread and every other job owns one worker thread,
+ * so runAll() costs roughly the slowest job instead of the sum of all of them.
+ * Each job is only ever executed by one thread, so collectors need no locking
+ * of their own. runAll() is a barrier: it returns once every job has finished.
+ */
+class CollectorPool {
+public:
+    CollectorPool() = default;
+    ~CollectorPool();
+
+    CollectorPool(const CollectorPool&) = delete;
+    CollectorPool& operator=(const CollectorPool&) = delete;
+
+    // Registers a job and returns its index; only valid before the first runAll()
+    std::size_t addJob(std::function<void()> job);
+
+    // Runs every job once and waits for all of them to complete
+    void runAll();
+
+    std::size_t jobCount() const { return jobs_.size(); }
+
+    // Wall time of the given job during the last runAll(), in milliseconds
+    double lastLatencyMs(std::size_t job) const { return latencyMs_[job]; }
+    // CPU time the job's thread spent on it during the last runAll(), in milliseconds
+    double lastCpuMs(std::size_t job) const { return cpuMs_[job]; }
+
+private:
+    void start();
+    void workerLoop(std::size_t job);
+    void runTimed(std::size_t job);
+
+    std::vector<std::function<void()>> jobs_;
+    std::vector<double> latencyMs_;
+    std::vector<double> cpuMs_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    uint64_t generation_ = 0;
+    std::size_t pending_ = 0;
+    bool started_ = false;
+    bool stopping_ = false;
+};
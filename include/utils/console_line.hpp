@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "memory_monitor.hpp"
+#include "gpu_monitor.hpp"
+
+/**
+ * Fixed-capacity text buffer for the per-sample status line.
+ *
+ * Numbers are rendered with std::to_chars, so formatting never allocates,
+ * never consults the locale and never flushes. Appends past the capacity are
+ * truncated rather than overflowing.
+ */
+class LineBuffer {
+public:
+    static constexpr std::size_t kCapacity = 512;
+
+    void clear() { size_ = 0; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    void append(const char* text, std::size_t length);
+    template <std::size_t N>
+    void append(const char (&literal)[N]) { append(literal, N - 1); }
+    void appendUint(uint64_t value);
+    // Fixed notation with one decimal, matching std::fixed << std::setprecision(1)
+    void appendFixed1(double value);
+
+private:
+    char data_[kCapacity];
+    std::size_t size_ = 0;
+};
+
+// Renders "CPU: x% | Memory: y MB (z%) | GPU: w% | NPU: v%\n"; a null part is left out
+void formatTickLine(LineBuffer& line, const double* cpu, const MemoryUsage* memory, const GpuUsage* gpu,
+                    const double* npu);
+
+// Writes the whole buffer to stdout with a single write call
+void writeConsoleLine(const LineBuffer& line);
+
+// Lets at most maxPerSecond lines through; 0 shows every sample
+class DisplayThrottle {
+public:
+    explicit DisplayThrottle(double maxPerSecond = 0.0);
+    bool shouldDisplay(std::chrono::steady_clock::time_point now);
+
+private:
+    std::chrono::steady_clock::duration minGap_;
+    std::chrono::steady_clock::time_point lastShown_;
+    bool shownAny_ = false;
+};
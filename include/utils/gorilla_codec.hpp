@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+    #include <stdlib.h>
+#endif
+
+// Bit-level building blocks for Gorilla-style time-series compression
+// (Pelkonen et al., "Gorilla: A Fast, Scalable, In-Memory Time Series
+// Database", VLDB 2015). Bits are packed MSB-first. Decoding sits on the
+// replay hot path, so the decoders are defined inline here.
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    // Appends the low n bits of value, 1 <= n <= 64
+    void writeBits(uint64_t value, int n) {
+        if (n < 64) value &= (uint64_t(1) << n) - 1;
+        int space = 64 - used_;
+        if (n < space) {
+            acc_ |= value << (space - n);
+            used_ += n;
+            return;
+        }
+        int rest = n - space;
+        acc_ |= value >> rest;
+        flushWord();
+        if (rest > 0) {
+            acc_ = value << (64 - rest);
+            used_ = rest;
+        }
+    }
+
+    void writeBit(bool bit) { writeBits(bit ? 1 : 0, 1); }
+
+    // Pads the final partial byte with zeros
+    void flush() {
+        int bytes = (used_ + 7) / 8;
+        for (int i = 0; i < bytes; ++i) out_.push_back(static_cast<uint8_t>(acc_ >> (56 - 8 * i)));
+        acc_ = 0;
+        used_ = 0;
+    }
+
+private:
+    void flushWord() {
+        for (int shift = 56; shift >= 0; shift -= 8) out_.push_back(static_cast<uint8_t>(acc_ >> shift));
+        acc_ = 0;
+        used_ = 0;
+    }
+
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    int used_ = 0;
+};
+
+// Bytes that must stay readable past the end of a BitReader buffer
+constexpr std::size_t kBitReaderPadding = 8;
+
+class BitReader {
+public:
+    BitReader() = default;
+    // data must be followed by kBitReaderPadding readable bytes, so every peek
+    // is a single unaligned 64-bit load with no end-of-buffer branch
+    BitReader(const uint8_t* data, std::size_t size) : data_(data), size_(size), endBits_(uint64_t(size) * 8) {}
+
+    // The next 57 or more bits, MSB-aligned. Past the end the load is clamped
+    // onto the zero padding instead of branching.
+    uint64_t peek() const {
+        uint64_t byte = pos_ >> 3;
+        byte = byte < size_ ? byte : size_;
+        uint64_t word;
+        std::memcpy(&word, data_ + byte, sizeof(word));
+#if defined(_MSC_VER)
+        word = _byteswap_uint64(word); // MSVC targets are all little-endian
+#elif __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return word << (pos_ & 7);
+    }
+
+    void skip(int n) { pos_ += static_cast<uint64_t>(n); }
+
+    // Reads n bits, 1 <= n <= 64
+    uint64_t readBits(int n) {
+        if (n > 56) {
+            uint64_t high = readBits(32);
+            return (high << (n - 32)) | readBits(n - 32);
+        }
+        uint64_t value = peek() >> (64 - n);
+        pos_ += static_cast<uint64_t>(n);
+        return value;
+    }
+
+    bool readBit() { return readBits(1) != 0; }
+
+    // True once more bits were consumed than the buffer holds
+    bool overrun() const { return pos_ > endBits_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    uint64_t size_ = 0;
+    uint64_t endBits_ = 0;
+    uint64_t pos_ = 0;
+};
+
+// Delta-of-delta timestamps: a regular series costs one bit per sample, and
+// nanosecond scheduling jitter typically fits the 16 or 24 bit buckets
+class TimestampColumnCodec {
+public:
+    void reset(int64_t first) { prev_ = first; prevDelta_ = 0; }
+    void encode(BitWriter& out, int64_t timestamp);
+    int64_t decode(BitReader& in) {
+        // Control prefix 0, 10, 110, 1110 or 1111 selects the dod width
+        uint64_t head = in.peek() >> 60;
+        int ones = head == 0xF ? 4 : (head >= 0xE ? 3 : (head >= 0xC ? 2 : (head >= 0x8 ? 1 : 0)));
+        in.skip(ones == 4 ? 4 : ones + 1);
+        static const int widths[] = {0, 16, 24, 32, 64};
+        uint64_t dod = ones == 0 ? 0 : in.readBits(widths[ones]);
+        uint64_t delta = static_cast<uint64_t>(prevDelta_) + ((dod >> 1) ^ (0 - (dod & 1)));
+        prevDelta_ = static_cast<int64_t>(delta);
+        prev_ = static_cast<int64_t>(static_cast<uint64_t>(prev_) + delta);
+        return prev_;
+    }
+
+private:
+    int64_t prev_ = 0;
+    int64_t prevDelta_ = 0;
+};
+
+// XOR of consecutive IEEE doubles; repeats cost one bit, and values that share
+// sign, exponent and high mantissa bits only store the differing window
+class FloatColumnCodec {
+public:
+    void reset() { first_ = true; prevLeading_ = 65; prevTrailing_ = 0; }
+    void encode(BitWriter& out, double value);
+    double decode(BitReader& in) {
+        if (first_) {
+            prev_ = in.readBits(64);
+            first_ = false;
+        } else {
+            uint64_t head = in.peek();
+            if (!(head >> 63)) {
+                in.skip(1);
+            } else {
+                if (head & (uint64_t(1) << 62)) {
+                    prevLeading_ = static_cast<int>((head >> 56) & 0x3F);
+                    prevTrailing_ = 64 - prevLeading_ - (static_cast<int>((head >> 50) & 0x3F) + 1);
+                    in.skip(14);
+                } else {
+                    in.skip(2);
+                }
+                prev_ ^= in.readBits(64 - prevLeading_ - prevTrailing_) << prevTrailing_;
+            }
+        }
+        double value;
+        std::memcpy(&value, &prev_, sizeof(value));
+        return value;
+    }
+
+private:
+    uint64_t prev_ = 0;
+    bool first_ = true;
+    int prevLeading_ = 65;
+    int prevTrailing_ = 0;
+};
+
+// Zig-zag varint deltas for slowly moving integer counters; unchanged values cost one bit
+class UintColumnCodec {
+public:
+    void reset() { prev_ = 0; }
+    void encode(BitWriter& out, uint64_t value);
+    uint64_t decode(BitReader& in) {
+        if (in.readBit()) {
+            uint64_t delta = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint64_t byte = in.readBits(8);
+                delta |= (byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            prev_ += (delta >> 1) ^ (0 - (delta & 1));
+        }
+        return prev_;
+    }
+
+private:
+    uint64_t prev_ = 0;
+};
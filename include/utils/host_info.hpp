@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+// Identifies the machine a recording was taken on
+struct HostInfo {
+    std::string hostName;
+    std::string kernel;   // e.g. "Linux 6.8.0-45-generic"
+    std::string cpuModel;
+};
+
+HostInfo queryHostInfo();
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "memory_monitor.hpp"
+#include "gpu_monitor.hpp"
+#include "process_monitor.hpp"
+#include "monitor_args.hpp"
+#include "process_manager.hpp"
+#include "process_table.hpp"
+#include "statistics.hpp"
+
+// Snapshot fields a source writes; every registered source owns exactly one
+enum class MetricSlot : uint8_t { Cpu, Memory, Gpu, Npu, Process, Top, Count };
+
+enum class MetricType : uint8_t {
+    Gauge,   // Level at the sample instant, or a utilization over the interval
+    Counter, // Events counted over the interval (faults, bytes)
+    Table    // Ranked rows rather than one value
+};
+
+// Rough price of one sample, so --metrics can leave out the costly ones
+enum class CostClass : uint8_t {
+    Cheap,     // One kept-open read or system call
+    Moderate,  // A handful of reads, or a driver query
+    Expensive  // Scans every process, or goes through WMI/PDH
+};
+
+// Static description of a source; the registry holds one per source
+struct MetricDescriptor {
+    const char* name;  // As given to --metrics
+    const char* unit;
+    MetricType type;
+    CostClass cost;
+    MetricSlot slot;
+    const char* description;
+};
+
+const char* metricTypeName(MetricType type);
+const char* costClassName(CostClass cost);
+
+// Everything one tick produces. Sources size their per-core and per-device
+// slots once when opened and then only overwrite them; each source runs on its
+// own collector thread and writes only its own slot
+struct TickSnapshot {
+    int64_t timestampNs = 0;  // Wall clock, so history buckets align to real minutes and hours
+    uint32_t present = 0;     // One bit per MetricSlot whose source was opened for this run
+
+    double cpu = 0.0;
+    std::vector<double> coreBusy;  // One column per logical core
+    MemoryUsage mem = {};
+    GpuUsage gpu;
+    std::vector<double> gpuBusy;   // One column per GPU
+    double npu = 0.0;
+    std::string npuName;
+    ProcessUsage process;          // Summed over the application's descendant tree
+    std::string processName;
+    std::vector<TopProcess> topByCpu;
+    std::vector<TopProcess> topByRss;
+
+    bool has(MetricSlot slot) const { return (present >> static_cast<unsigned>(slot)) & 1u; }
+    void setPresent(MetricSlot slot) { present |= 1u << static_cast<unsigned>(slot); }
+};
+
+// Run state a source may need besides its own configuration
+struct MetricSourceContext {
+    const MonitorArgs& args;
+    const ChildProcess& child; // Root of the process tree while a command runs
+    AppWatcher& watcher;       // Otherwise the application's PIDs
+};
+
+class IMetricSource {
+public:
+    virtual ~IMetricSource() = default;
+
+    virtual const MetricDescriptor& descriptor() const = 0;
+
+    // Acquires the source's handles and sizes its slots; false if it is not
+    // available on this host, in which case the source is dropped
+    virtual bool open(TickSnapshot& snapshot) = 0;
+
+    // Samples once into the source's own slot
+    virtual void collect(TickSnapshot& snapshot) = 0;
+};
+
+// Sources compiled in for this platform, in collection order
+std::size_t metricSourceCount();
+const MetricDescriptor& metricDescriptor(std::size_t index);
+// nullptr if no such source exists on this platform
+const MetricDescriptor* findMetricDescriptor(const std::string& name);
+// "cpu, mem, ..." for messages
+std::string metricSourceNames();
+// Table of every source's descriptor, for --metrics list
+void printMetricSources();
+
+// Collector latency or CPU time indexed by MetricSlot, folded into the fixed
+// per-collector record kept by statistics and recordings
+CollectorLatency collectorLatencyFromSlots(const double* bySlot);
+
+/**
+ * The sources selected for one run.
+ *
+ * Only the sources named with --metrics (every plain system source when none
+ * are named) are constructed, plus those implied by other options: process
+ * usage for an application or command, the process table for --top. A source
+ * that is not selected is never constructed, and one that fails to open is
+ * dropped (with a notice if it was named).
+ */
+class MetricSourceSet {
+public:
+    MetricSourceSet() = default;
+    ~MetricSourceSet();
+
+    MetricSourceSet(const MetricSourceSet&) = delete;
+    MetricSourceSet& operator=(const MetricSourceSet&) = delete;
+
+    // False with error() set if a name is not a source on this platform
+    bool open(const MetricSourceContext& context, TickSnapshot& snapshot);
+
+    std::size_t size() const { return sources_.size(); }
+    IMetricSource& operator[](std::size_t index) const { return *sources_[index]; }
+    const std::string& error() const { return error_; }
+
+private:
+    std::vector<IMetricSource*> sources_;
+    std::string error_;
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "output_formatter.hpp"
+#include "statistics.hpp"
+
+// Latest values published by the sampling loop for --serve
+struct MetricsSnapshot {
+    int64_t timestampMs = 0;          // Wall clock of the sample
+    // Families of a source that is not sampled are left out of the exposition
+    bool cpuAvailable = true;
+    bool memoryAvailable = true;
+    bool gpuAvailable = true;
+    double cpuPercent = 0.0;
+    std::vector<double> corePercent;  // Empty without per-core counters
+    uint64_t memoryUsedMB = 0;
+    uint64_t memoryTotalMB = 0;
+    double memoryUsedPercent = 0.0;
+    double gpuPercent = 0.0;          // Average across GPUs
+    std::vector<double> gpuPercentPerDevice;
+    bool npuAvailable = false;
+    double npuPercent = 0.0;
+    CollectorLatency latency;
+    uint64_t samples = 0;
+    uint64_t overruns = 0;
+    uint64_t skippedTicks = 0;
+};
+
+// Renders snapshot in the OpenMetrics text exposition format; out is cleared
+// first and, once it has grown to fit, is reused without allocating
+void renderOpenMetrics(const MetricsSnapshot& snapshot, SummaryBuffer& out);
+
+/**
+ * Minimal HTTP/1.1 server answering GET /metrics for --serve.
+ *
+ * A single background thread runs a non-blocking event loop (epoll on Linux,
+ * poll elsewhere) over the listening socket and a fixed table of keep-alive
+ * connections, each owning a response buffer that is reused across scrapes.
+ * The sampling thread hands over values with publish(), which only ever
+ * try-locks: if a scrape is copying the previous snapshot at that moment the
+ * update is skipped, and the next tick publishes newer values anyway.
+ * Not available on Windows.
+ */
+class MetricsServer {
+public:
+    MetricsServer();
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Binds "host:port" (port 0 picks a free one) and starts the server thread;
+    // on failure error() says why
+    bool start(const std::string& address);
+    void stop();
+    bool isRunning() const { return running_; }
+    const std::string& error() const { return error_; }
+
+    // Port actually bound, useful after binding port 0
+    uint16_t port() const { return port_; }
+
+    // Never blocks the caller
+    void publish(const MetricsSnapshot& snapshot);
+
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t kMaxConnections = 16;
+    static constexpr std::size_t kRequestBytes = 4096;
+
+private:
+    struct Connection {
+        int fd = -1;
+        char request[kRequestBytes];
+        std::size_t requestSize = 0;
+        char head[256];
+        std::size_t headSize = 0;
+        SummaryBuffer body{8 * 1024};
+        std::size_t sent = 0;       // Bytes of head + body already written
+        bool closeAfterSend = false;
+        bool writing = false;       // A response is being sent; reads wait until it is done
+        bool writeWatched = false;  // Registered for writability after a short write
+    };
+
+    void serveLoop();
+    void acceptConnections();
+    void onReadable(Connection& conn);
+    // Answers the buffered request once its header block is complete
+    void handleRequest(Connection& conn);
+    void onWritable(Connection& conn);
+    void respond(Connection& conn, std::size_t length);
+    void closeConnection(Connection& conn);
+    // Registers or updates fd with the epoll instance; poll() rebuilds its set every pass instead
+    void watch(int fd, uint64_t tag, bool writable, bool add);
+
+    std::string error_;
+    uint16_t port_ = 0;
+    bool running_ = false;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> scrapes_{0};
+    std::thread thread_;
+
+    int listenFd_ = -1;
+    int wakeFds_[2] = {-1, -1}; // stop() writes to [1] to interrupt the wait
+    int pollFd_ = -1;           // epoll instance on Linux
+    Connection connections_[kMaxConnections];
+
+    std::mutex snapshotMutex_;
+    MetricsSnapshot latest_;    // Guarded by snapshotMutex_
+    MetricsSnapshot scratch_;   // Server thread only
+};
@@ -1,10 +1,29 @@
 #pragma once
 #include <string>
+#include <vector>
 
 struct MonitorArgs {
     int interval = 1000;
     std::string resultPath;
+    std::string outputFormat = "text"; // Layout of the -o file: text, json, csv or kv
     std::string appName; // May be empty if not provided
+    std::vector<std::string> command; // "-- CMD ARGS...": run this command and stop when it exits
+    std::string recordPath; // Binary sample log written alongside live monitoring
+    bool compressRecording = false; // Gorilla-encode the recording instead of fixed-width records
+    bool lossyRecording = false; // --compress=lossy: round values before encoding for smaller files
+    std::string replayPath; // "replay FILE": recompute statistics from a recording instead of sampling
+    std::string serveAddress; // HOST:PORT for the OpenMetrics /metrics endpoint; empty disables it
+    bool realtime = false; // Pace a replay at the recorded sample times instead of as fast as possible
+    bool keepHistory = false; // Keep every raw per-core and latency sample, not just running statistics
+    int historyMinutes = 10; // Window kept at full resolution before only rollups remain
+    double displayRate = 0.0; // Console lines per second at most; 0 prints every sample
+    int adaptiveMaxInterval = 0; // --adaptive MSEC: let the interval stretch from -i up to this while metrics are flat; 0 keeps it fixed
+    double adaptiveStep = 5.0; // Change in percentage points between samples that snaps the interval back to -i
+    bool catchUp = false; // Run missed ticks back to back instead of skipping them
+    int top = 0; // Rank the N heaviest processes by CPU and by RSS each tick (Linux); 0 disables it
+    std::vector<std::string> metrics; // Sources named with --metrics; empty selects every system source
+    bool listMetrics = false; // "--metrics list": print the available sources and exit
+    double overheadBudget = 0.0; // Warn when one tick costs crossmon more than this % of a core; 0 disables it
     bool showHelp = false;
     bool hasError = false;
     std::string errorMessage;
@@ -3,19 +3,59 @@
 #include <vector>
 #include "monitor_args.hpp"
 #include "statistics.hpp"
+#include "output_formatter.hpp"
+#include "timeseries_store.hpp"
 
 struct SystemSamples {
-    std::vector<double> cpuUsage;
-    std::vector<uint64_t> memoryUsedMB;
-    std::vector<double> memoryUsedPercent;
-    std::vector<double> gpuUtilization;
-    std::vector<double> npuUtilization;
+    // Which sources were sampled; set once the run's sources are known
+    SummarySections sections;
+
+    // Streaming accumulators, updated on every sample in constant memory
+    RunningStats cpu;
+    PerCoreAccumulator perCore;
+    PerCoreAccumulator perGpu; // Same peak/average bookkeeping, one column per GPU
+    RunningStats memoryUsedMBStats;
+    RunningStats memoryUsedPercentStats;
+    RunningStats gpu;
+    RunningStats npu;
+    // Fixed-size percentile sketches; memory in MB up to 16 TB at 1 MB resolution
+    QuantileSketch cpuSketch;
+    QuantileSketch memoryUsedMBSketch{1.0, 16.0 * 1024 * 1024};
+    QuantileSketch memoryUsedPercentSketch;
+    QuantileSketch gpuSketch;
+    QuantileSketch npuSketch;
+    LatencyStats latency;
+    TimingStats timing;
+    OverheadStats overhead; // crossmon's own cost; only live monitoring fills it
+
+    // Application given with --app (Linux); processTotals carries the name,
+    // peak process count and the fault and I/O totals
+    RunningStats processCpu;
+    RunningStats processRssKB;
+    RunningStats processPssKB;
+    ProcessStats processTotals;
+
+    // Exact wait4 totals of the command run with --, filled once it has exited
+    CommandStats command;
+
+    // Bounded multi-resolution history; sized once from the arguments
+    TimeSeriesStore history;
+
+    // Raw per-core and latency series; grow without bound, so only kept when requested
+    bool keepHistory = false;
+    PerCoreSeries perCoreUsage;
+    std::vector<CollectorLatency> collectorLatency;
+
     std::size_t gpuCount = 0;
     std::string npuName = "";
 };
 
-void monitorSystemUsage(const MonitorArgs& args, SystemSamples& samples);
-void outputSystemStatistics(const SystemSamples& samples, const std::string& resultPath);
+// False if the --serve endpoint could not be started or the command after -- could not be run
+bool monitorSystemUsage(const MonitorArgs& args, SystemSamples& samples);
+// Feeds a --record file through the same statistics as live monitoring; false if it cannot be read
+bool replaySystemUsage(const MonitorArgs& args, SystemSamples& samples);
+void outputSystemStatistics(const SystemSamples& samples, const std::string& resultPath,
+                            OutputFormat format = OutputFormat::Text);
 
 // Legacy functions for backward compatibility
 void monitorCpuUsage(const MonitorArgs& args, std::vector<double>& samples);
@@ -1,7 +1,42 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "statistics.hpp"
 
+// Layout of the -o summary file
+enum class OutputFormat {
+    Text, // Human-readable sections, as printed to the console
+    Json, // One object with a section per subsystem
+    Csv,  // "key,value" rows using the same dotted keys as Kv
+    Kv    // "key=value" lines, e.g. cpu.p99=42.5 or gpu.devices.1.average=3.2
+};
+
+// Maps "text", "json", "csv" or "kv"; false for anything else
+bool parseOutputFormat(const std::string& name, OutputFormat& format);
+
+// Output buffer reserved once up front and filled with std::to_chars
+class SummaryBuffer {
+public:
+    explicit SummaryBuffer(std::size_t reserveBytes = 4096) { data_.reserve(reserveBytes); }
+
+    void clear() { data_.clear(); }
+    const char* data() const { return data_.data(); }
+    std::size_t size() const { return data_.size(); }
+
+    void append(const char* text, std::size_t length) { data_.insert(data_.end(), text, text + length); }
+    void append(const std::string& text) { append(text.data(), text.size()); }
+    template <std::size_t N>
+    void append(const char (&literal)[N]) { append(literal, N - 1); }
+    void appendUint(uint64_t value);
+    // Shortest representation that reads back as the same double
+    void appendDouble(double value);
+
+private:
+    std::vector<char> data_;
+};
+
 void printCpuStatsToConsole(const CpuStats& stats);
 void writeCpuStatsToFile(const CpuStats& stats, const std::string& path);
 
@@ -14,5 +49,29 @@ void writeGpuStatsToFile(const GpuStats& stats, const std::string& path);
 void printNpuStatsToConsole(const NpuStats& stats);
 void writeNpuStatsToFile(const NpuStats& stats, const std::string& path);
 
+void printProcessStatsToConsole(const ProcessStats& stats);
+void writeProcessStatsToFile(const ProcessStats& stats, const std::string& path);
+
+void printCommandStatsToConsole(const CommandStats& stats);
+void writeCommandStatsToFile(const CommandStats& stats, const std::string& path);
+
+void printLatencyStatsToConsole(const LatencyStats& stats);
+void writeLatencyStatsToFile(const LatencyStats& stats, const std::string& path);
+
+void printTimingStatsToConsole(const TimingStats& stats);
+void writeTimingStatsToFile(const TimingStats& stats, const std::string& path);
+
+void printOverheadStatsToConsole(const OverheadStats& stats);
+void writeOverheadStatsToFile(const OverheadStats& stats, const std::string& path);
+
+void printHistoryStatsToConsole(const HistoryStats& stats);
+void writeHistoryStatsToFile(const HistoryStats& stats, const std::string& path);
+
+// Serializes the whole summary in one pass; out is cleared first
+void formatSystemStats(const SystemStats& stats, OutputFormat format, SummaryBuffer& out);
+
 void printSystemStatsToConsole(const SystemStats& stats);
-void writeSystemStatsToFile(const SystemStats& stats, const std::string& path); 
\ No newline at end of file
+// Writes every section at once through a temporary file renamed over path,
+// so readers never see a partially written summary
+void writeSystemStatsToFile(const SystemStats& stats, const std::string& path,
+                            OutputFormat format = OutputFormat::Text);
@@ -0,0 +1,157 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Persistent read-only handle on a procfs/sysfs file.
+ *
+ * The file is opened once and re-read from offset 0 with pread() on every
+ * sample, so a sample costs one syscall and no allocation. Kernel pseudo-files
+ * regenerate their contents on each read, so a kept-open descriptor always
+ * observes fresh counters.
+ */
+class ProcFile {
+public:
+    ProcFile() = default;
+    explicit ProcFile(const std::string& path) { open(path); }
+    ~ProcFile() { close(); }
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+    ProcFile(ProcFile&& other) noexcept : fd_(other.fd_) { other.fd_ = -1; }
+    ProcFile& operator=(ProcFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    // Reads the file from offset 0 into buf (at most size - 1 bytes), NUL-terminates
+    // it and returns the number of bytes read, or -1 on error.
+    long readAll(char* buf, std::size_t size) const;
+    // Same, growing buf until the whole file fits; for files of unknown length
+    long readAll(std::vector<char>& buf) const;
+
+private:
+    int fd_ = -1;
+};
+
+#ifdef __linux__
+/**
+ * Persistent handle on a procfs directory for listing process IDs.
+ *
+ * The directory is opened once; each listing rewinds the descriptor and reads
+ * the entries with getdents64 into a fixed buffer, so no DIR stream is
+ * allocated per scan. fd() can anchor openat() for per-process files.
+ */
+class ProcDirectory {
+public:
+    ProcDirectory() = default;
+    ~ProcDirectory() { close(); }
+
+    ProcDirectory(const ProcDirectory&) = delete;
+    ProcDirectory& operator=(const ProcDirectory&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+    // Replaces pids with the numeric entries in directory order; false on error
+    bool listPids(std::vector<int>& pids);
+
+private:
+    int fd_ = -1;
+    alignas(8) char buffer_[32 * 1024];
+};
+
+/**
+ * Detects process creation from the last field of <procRoot>/loadavg, the
+ * most recently allocated PID. While it stays the same no process can have
+ * been created (and no PID reused), so cached per-process state only shrinks.
+ */
+class PidAllocationWatch {
+public:
+    bool open(const std::string& procRoot) { return loadavg_.open(procRoot + "/loadavg"); }
+
+    // True if a PID was allocated since the previous call, or if it cannot tell
+    bool allocatedSinceLastCheck();
+
+    // Whether pid lies in the range the last check saw allocated: after the
+    // previous last PID up to the current one, wrapping past pid_max. False
+    // when the range is unknown (first check, or loadavg unreadable)
+    bool mayHaveAllocated(int pid) const;
+
+private:
+    ProcFile loadavg_;
+    uint64_t lastPid_ = 0;
+    uint64_t previousPid_ = 0;
+    bool rangeKnown_ = false;
+    char buffer_[128];
+};
+#endif
+
+// Fields of /proc/PID/stat the collectors use
+struct PidStat {
+    char state = '?';
+    int parent = 0;
+    uint64_t minorFaults = 0;
+    uint64_t majorFaults = 0;
+    uint64_t userTicks = 0;
+    uint64_t systemTicks = 0;
+    uint64_t startTime = 0;  // Clock ticks after boot; with the PID it identifies a process
+    uint64_t rssPages = 0;
+    const char* name = nullptr;  // comm, pointing into the parsed buffer (not terminated)
+    std::size_t nameLength = 0;
+};
+
+// Parses a /proc/PID/stat line. The process name may contain spaces and ')',
+// so fields are counted from the last ')'.
+bool parsePidStat(const char* p, const char* end, PidStat& stat);
+
+// Sums user, nice, system, idle, iowait, irq, softirq and steal of the aggregate
+// "cpu " line that starts /proc/stat
+bool parseAggregateCpuTicks(const char* p, const char* end, uint64_t& total);
+
+// Counts the per-CPU "cpuN" lines of /proc/stat
+std::size_t countCpuLines(const char* p, const char* end);
+
+// Minimal allocation-free scanners for the whitespace separated text that
+// procfs and sysfs produce. All functions take a [p, end) range and never
+// read past end.
+namespace procscan {
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char* skipToNextLine(const char* p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+// Parses an unsigned decimal after optional leading blanks. On success returns the
+// position after the last digit; if no digit is found returns nullptr.
+inline const char* parseUint64(const char* p, const char* end, uint64_t& value) {
+    p = skipSpaces(p, end);
+    if (p >= end || *p < '0' || *p > '9') return nullptr;
+    uint64_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    value = v;
+    return p;
+}
+
+inline bool startsWith(const char* p, const char* end, const char* prefix, std::size_t len) {
+    if (static_cast<std::size_t>(end - p) < len) return false;
+    for (std::size_t i = 0; i < len; ++i) {
+        if (p[i] != prefix[i]) return false;
+    }
+    return true;
+}
+
+} // namespace procscan
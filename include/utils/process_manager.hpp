@@ -1,5 +1,86 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
+#include "statistics.hpp"
 
 void launchApp(const std::string& appName);
-bool isAppRunning(const std::string& appName); 
\ No newline at end of file
+bool isAppRunning(const std::string& appName);
+
+// IDs of the live (non-zombie) processes whose name matches appName exactly, as
+// pgrep -x would report them; procRoot allows fixture trees in tests. Linux only,
+// empty elsewhere.
+std::vector<int> findProcessIds(const std::string& appName, const std::string& procRoot = "/proc");
+
+/**
+ * Per-tick liveness check for the monitored application.
+ *
+ * On Linux the name is resolved to PIDs with a single /proc scan. Each tracked
+ * PID then gets a pidfd (pidfd_open, Linux 5.3+) and a tick is one zero-timeout
+ * poll() over them, or kill(pid, 0) per PID where pidfds are unavailable.
+ * /proc is scanned again only after a tracked process exits, to pick up
+ * siblings or a restarted instance. Other platforms fall back to isAppRunning().
+ */
+class AppWatcher {
+public:
+    explicit AppWatcher(const std::string& appName);
+    ~AppWatcher();
+
+    AppWatcher(const AppWatcher&) = delete;
+    AppWatcher& operator=(const AppWatcher&) = delete;
+
+    bool isRunning();
+
+    // Tracked PIDs, sorted; refreshed by the scans isRunning() triggers (Linux only)
+    const std::vector<int>& pids() const { return pids_; }
+    // Incremented on every /proc scan, so callers can tell when pids() changed
+    uint64_t generation() const { return generation_; }
+
+private:
+    void rescan();
+    void closePidfds();
+
+    std::string appName_;
+    std::vector<int> pids_;
+    std::vector<int> pidfds_; // Parallel to pids_; -1 where pidfd_open failed
+    uint64_t generation_ = 0;
+};
+
+/**
+ * Command run and owned by crossmon -- CMD ARGS (not available on Windows).
+ *
+ * The command is started with posix_spawnp, so its PID is known from its
+ * first instruction. exitFd() becomes readable the moment it exits: a pidfd on
+ * Linux 5.3+, otherwise a pipe written by a SIGCHLD handler. wait() reaps it
+ * with wait4 and reports the kernel's exact resource totals for the run.
+ */
+class ChildProcess {
+public:
+    ChildProcess() = default;
+    ~ChildProcess();
+
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    // Starts command[0] (searched in PATH) with the remaining arguments; on failure error() says why
+    bool start(const std::vector<std::string>& command);
+    const std::string& error() const { return error_; }
+
+    int pid() const { return pid_; }
+    int exitFd() const { return exitFd_; }
+    bool isRunning() const { return pid_ > 0 && !reaped_; }
+
+    // Blocks until the command exits and returns its totals; later calls return the same totals.
+    // If the exit status cannot be collected, exitCode is 1 and error() says why
+    const CommandStats& wait();
+
+private:
+    int pid_ = -1;
+    int exitFd_ = -1;
+    bool ownsExitFd_ = false; // The SIGCHLD pipe is shared and stays open
+    bool reaped_ = false;
+    std::chrono::steady_clock::time_point started_;
+    CommandStats stats_;
+    std::string error_;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+
+// One row of a --top ranking
+struct TopProcess {
+    int pid = 0;
+    char name[16] = {};      // comm, NUL-terminated (the kernel keeps 15 characters)
+    double cpuPercent = 0.0; // Since the previous refresh; 100% is one fully busy core
+    uint64_t rssKB = 0;
+};
+
+#ifdef __linux__
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "proc_reader.hpp"
+
+/**
+ * Every process on the host with its CPU% and RSS, for --top (Linux).
+ *
+ * A refresh lists /proc with getdents64 through a kept-open directory
+ * descriptor (skipped while no PID was allocated since the last one) and reads each process's stat through a descriptor opened with
+ * openat() relative to it and kept for the life of the process, up to a file
+ * budget (processes beyond it are opened and closed on every refresh).
+ * Previous-tick counters live in a flat open-addressing table keyed by PID;
+ * the start time read alongside tells a reused PID apart from the process it
+ * replaced, and a kept descriptor of an exited process fails instead of
+ * reading its successor. Rankings use partial selection, so nothing sorts
+ * the whole table.
+ */
+class ProcessTable {
+public:
+    // maxOpenFiles 0 keeps up to half of RLIMIT_NOFILE open
+    explicit ProcessTable(const std::string& procRoot = "/proc", std::size_t maxOpenFiles = 0);
+    ~ProcessTable();
+
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+
+    // Samples every process; false if /proc cannot be listed
+    bool refresh();
+
+    // Replaces out with the n heaviest processes, heaviest first
+    void topByCpu(std::size_t n, std::vector<TopProcess>& out);
+    void topByRss(std::size_t n, std::vector<TopProcess>& out);
+
+    std::size_t size() const { return size_; }
+    std::size_t openFiles() const { return openFiles_; }
+
+private:
+    struct Slot {
+        int pid = 0;  // 0 marks an empty slot
+        int fd = -1;
+        uint32_t epoch = 0;  // Refresh that last saw the process
+        uint64_t startTime = 0;
+        uint64_t cpuTicks = 0;
+        double cpuPercent = 0.0;
+        uint64_t rssKB = 0;
+        char name[16] = {};
+    };
+
+    std::size_t indexOf(int pid) const { return (static_cast<uint32_t>(pid) * 2654435761u) & mask_; }
+    std::size_t findOrInsert(int pid);
+    void erase(std::size_t index);
+    void grow();
+    bool sample(Slot& slot, uint64_t elapsedTicks);
+    template <typename Heavier>
+    void top(std::size_t n, std::vector<TopProcess>& out, Heavier heavier);
+
+    ProcDirectory dir_;
+    ProcFile statFile_;
+    PidAllocationWatch allocations_;
+    std::vector<Slot> slots_;  // Power-of-two capacity, at most half full
+    std::size_t mask_ = 0;
+    std::size_t size_ = 0;
+    std::size_t openFiles_ = 0;
+    std::size_t maxOpenFiles_;
+    uint32_t epoch_ = 0;
+    uint64_t lastSystemTicks_ = 0;
+    uint64_t pageKB_;
+    std::size_t cores_ = 0;
+    std::vector<int> pids_;
+    std::vector<uint32_t> order_;  // Scratch for the rankings
+    char buffer_[1024];
+};
+#endif
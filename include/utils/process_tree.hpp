@@ -0,0 +1,67 @@
+#pragma once
+#ifdef __linux__
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "proc_reader.hpp"
+
+/**
+ * A set of root processes plus all of their descendants, kept current
+ * incrementally (Linux).
+ *
+ * Every process on the host is cached as PID -> (parent, start time, member).
+ * <procRoot>/loadavg ends with the most recently allocated PID; while it stays
+ * the same no process can have been created, so a refresh is one small read.
+ * Otherwise /proc is listed once through a kept-open directory descriptor and
+ * the sorted listing is merged into the cache. Only PIDs that are new to the
+ * listing have their stat read, and their membership follows from their
+ * parent's. A PID that disappeared and came back is a different process and
+ * is read again. So is a cached PID inside the range loadavg says was
+ * allocated since the last refresh, which catches a PID reused between two
+ * listings; if its start time changed, its membership is resolved afresh.
+ * Membership is sticky: a descendant re-parented to init after its parent
+ * exited keeps counting until it exits. Exits are picked up at the next
+ * listing; samplers drop exited processes on their own.
+ */
+class ProcessTree {
+public:
+    explicit ProcessTree(const std::string& procRoot = "/proc");
+
+    // Brings the cache up to date and returns true if members() changed
+    bool refresh(const std::vector<int>& roots);
+
+    // Live roots and their descendants, sorted
+    const std::vector<int>& members() const { return members_; }
+    std::size_t knownProcesses() const { return entries_.size(); }
+    // Whether the last refresh listed /proc, and how many stat files it read
+    bool lastListed() const { return listed_; }
+    std::size_t lastStatReads() const { return statReads_; }
+
+private:
+    struct Entry {
+        int pid;
+        int parent;
+        uint64_t startTime;
+        bool member;
+    };
+
+    bool readEntry(int pid, Entry& entry);
+    Entry* find(int pid);
+    // Marks entries reachable from the roots; the full pass runs only when the roots change
+    bool recomputeMembership();
+    bool resolveNewEntries();
+
+    ProcDirectory dir_;
+    PidAllocationWatch allocations_;
+    bool listed_ = false;
+    std::vector<Entry> entries_;  // Sorted by PID
+    std::vector<Entry> merged_;   // Scratch for the merge, swapped with entries_
+    std::vector<int> pids_;
+    std::vector<std::size_t> added_;
+    std::vector<int> roots_;
+    std::vector<int> members_;
+    std::size_t statReads_ = 0;
+    char buffer_[512];
+};
+#endif
@@ -0,0 +1,284 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gorilla_codec.hpp"
+
+// Binary sample log written by --record.
+//
+// A file is a fixed kRecordingHeaderBytes header followed by fixed-width
+// records. Each record is a SampleRecord (column groups time | cpu | memory |
+// gpu | npu | collector latency) followed by coreCount per-core and gpuCount
+// per-GPU utilization doubles. Values are stored in host byte order. The tail
+// of the last chunk is zero-filled until the writer trims it on close, so a
+// reader stops at the first record whose timestamp is 0.
+//
+// With the Gorilla encoding the same records are instead stored as a sequence
+// of self-contained compressed blocks of up to blockSamples samples each. The
+// blocks decode to the exact recorded values unless the header says they were
+// quantized first.
+
+constexpr char kRecordingMagic[8] = {'C', 'R', 'O', 'S', 'S', 'R', 'E', 'C'};
+// Version 2 added sampledSlots and version 3 quantized; older files are still read
+constexpr uint32_t kRecordingVersion = 3;
+constexpr std::size_t kRecordingHeaderBytes = 1024;
+
+constexpr uint32_t kRecordingBlockSamples = 256;
+
+enum class RecordingEncoding : uint32_t {
+    Raw = 0,
+    Gorilla = 1
+};
+
+struct RecordingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t recordBytes;
+    uint32_t encoding;      // RecordingEncoding
+    uint32_t intervalMs;
+    uint32_t coreCount;
+    uint32_t gpuCount;
+    uint32_t blockSamples;  // Samples per compressed block; 0 for raw recordings
+    int64_t startTimeNs;    // Wall clock, nanoseconds since the Unix epoch
+    char host[64];
+    char kernel[128];
+    char cpuModel[128];
+    char npuName[64];
+    uint32_t maxIntervalMs; // Longest adaptive interval; 0 when samples were taken at a fixed interval
+    uint32_t sampledSlots;  // One bit per MetricSlot sampled in the run; columns of the others hold zeros
+    uint32_t quantized;     // 1 when Gorilla values were rounded before encoding (always so before version 3)
+};
+static_assert(sizeof(RecordingHeader) <= kRecordingHeaderBytes, "recording header must fit its reserved block");
+
+struct SampleRecord {
+    int64_t timestampNs = 0;        // Wall clock, nanoseconds since the Unix epoch
+    double cpuPercent = 0.0;
+    uint64_t memoryUsedMB = 0;
+    uint64_t memoryTotalMB = 0;
+    double memoryUsedPercent = 0.0;
+    double gpuPercent = 0.0;        // Average across GPUs
+    double npuPercent = 0.0;
+    float cpuLatencyMs = 0.0f;
+    float memoryLatencyMs = 0.0f;
+    float gpuLatencyMs = 0.0f;
+    float npuLatencyMs = 0.0f;
+};
+static_assert(sizeof(SampleRecord) == 72, "SampleRecord is part of the on-disk format");
+
+inline std::size_t recordingRecordBytes(std::size_t coreCount, std::size_t gpuCount) {
+    return sizeof(SampleRecord) + (coreCount + gpuCount) * sizeof(double);
+}
+
+// Header for this machine, with the layout fields filled in for the given counts
+RecordingHeader makeRecordingHeader(uint32_t intervalMs, std::size_t coreCount, std::size_t gpuCount,
+                                    const std::string& npuName,
+                                    RecordingEncoding encoding = RecordingEncoding::Raw);
+
+// Precedes every Gorilla block. Columns restart from raw values at each block,
+// so any block decodes on its own and the timestamps allow seeking by time.
+struct RecordingBlockHeader {
+    char magic[4];
+    uint32_t sampleCount;
+    uint32_t payloadBytes;
+    uint32_t reserved;
+    int64_t firstTimestampNs;
+    int64_t lastTimestampNs;
+};
+static_assert(sizeof(RecordingBlockHeader) == 32, "RecordingBlockHeader is part of the on-disk format");
+
+constexpr char kRecordingBlockMagic[4] = {'C', 'M', 'B', 'K'};
+
+/**
+ * Packs raw records into Gorilla blocks: delta-of-delta timestamps, XOR-ed
+ * doubles and varint deltas for the memory MB columns. Within a block each
+ * column is stored contiguously, so decoding runs one tight loop per column
+ * whose branches follow that column's own rhythm. Values are stored exactly
+ * unless lossy is set: utilization columns are then rounded to 1/128 of a
+ * percentage point and latencies to 1/1024 ms first, which turns the noise in
+ * the low mantissa bits into the zero runs the XOR encoding depends on.
+ */
+class SampleBlockEncoder {
+public:
+    void reset(std::size_t coreCount, std::size_t gpuCount, bool lossy = false);
+    // record uses the raw on-disk layout (SampleRecord, cores, gpus)
+    void add(const char* record);
+    std::size_t sampleCount() const { return count_; }
+    // Returns the finished block (header and payload) and starts a new one
+    const std::vector<uint8_t>& finish();
+
+private:
+    std::size_t recordBytes_ = 0;
+    std::size_t count_ = 0;
+    bool quantize_ = false;
+    std::vector<char> pending_; // Raw records of the block being filled
+    std::vector<uint8_t> block_;
+};
+
+// Decodes a whole block at once back into the raw record layout
+class SampleBlockDecoder {
+public:
+    void reset(std::size_t coreCount, std::size_t gpuCount);
+    // False if the payload is shorter than its sample count requires
+    bool decode(const RecordingBlockHeader& header, const uint8_t* payload);
+    std::size_t sampleCount() const { return count_; }
+    const char* record(std::size_t i) const { return decoded_.data() + i * recordBytes_; }
+
+private:
+    std::size_t recordBytes_ = 0;
+    std::size_t count_ = 0;
+    std::vector<uint8_t> payload_; // Copy of the block with reader padding
+    std::vector<char> decoded_;
+};
+
+/**
+ * Appends samples to a memory-mapped recording without blocking the caller.
+ *
+ * append() only copies the record into a preallocated single-producer queue;
+ * a background thread moves records into the mapping, grows the file one
+ * chunk at a time and syncs each chunk to disk once it is full. A crash
+ * therefore loses at most the chunk currently being filled. If the writer
+ * falls a whole queue behind, new samples are dropped and counted rather than
+ * stalling the sampling loop. On Windows the chunks are written with stdio
+ * instead of a mapping. Compressed recordings are encoded on the writer
+ * thread as well; a crash additionally loses the block still being filled.
+ */
+class RecordingWriter {
+public:
+    explicit RecordingWriter(std::size_t chunkBytes = 1 << 20, std::size_t queueRecords = 1024);
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    // Creates (or truncates) path, writes the header and starts the writer thread
+    bool open(const std::string& path, const RecordingHeader& header);
+    bool isOpen() const { return running_; }
+
+    // cores and gpus must hold the coreCount and gpuCount values given in the header
+    bool append(const SampleRecord& record, const double* cores, const double* gpus);
+
+    // Drains the queue, syncs everything and trims the zero-filled tail
+    void close();
+
+    uint64_t recordsWritten() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t recordsDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void writerLoop();
+    void writeRecord(const char* record);
+    void writeBlock();
+    bool writeAt(std::size_t offset, const void* data, std::size_t size);
+    void syncChunk(bool final);
+    void closeFile();
+
+    std::size_t chunkBytes_;
+    std::size_t queueRecords_;
+    std::size_t recordBytes_ = 0;
+    std::size_t coreCount_ = 0;
+    std::size_t gpuCount_ = 0;
+    std::size_t blockSamples_ = 0; // Non-zero when compressing
+    SampleBlockEncoder encoder_;
+
+    // Single-producer / single-consumer hand-off between sampling and writer threads
+    std::vector<char> queue_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    std::atomic<bool> stopping_{false};
+    bool running_ = false;
+
+    // Owned by the writer thread once running
+    std::size_t writePos_ = 0;
+    std::size_t syncedPos_ = 0;
+    std::size_t fileSize_ = 0;
+#ifdef _WIN32
+    std::FILE* file_ = nullptr;
+#else
+    int fd_ = -1;
+    char* map_ = nullptr;
+#endif
+};
+
+/**
+ * Sequential reader for recordings produced by RecordingWriter.
+ *
+ * The file is mapped read-only (read into memory on Windows) and raw records
+ * are decoded in place, so reading a sample costs a couple of memcpy calls.
+ * Gorilla blocks are decoded one block ahead on a helper thread, so replay
+ * pays for decoding or for statistics, whichever is slower, not both. Files
+ * cut short by a crash are read up to the last complete record or block.
+ */
+class RecordingReader {
+public:
+    RecordingReader() = default;
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    // Maps path and validates its header; on failure error() says why
+    bool open(const std::string& path);
+    void close();
+
+    const RecordingHeader& header() const { return header_; }
+    const std::string& error() const { return error_; }
+
+    // Decodes the next sample into record, cores and gpus (sized from the
+    // header); returns false once the recording is exhausted
+    bool next(SampleRecord& record, double* cores, double* gpus);
+
+    // Restarts from the first sample
+    void rewind();
+
+    // Block-level random access into Gorilla recordings (raw recordings have no blocks)
+    std::size_t blockCount() const { return blocks_.size(); }
+    bool seekBlock(std::size_t block);
+    // Positions at the start of the first block that ends at or after timestampNs
+    bool seekTime(int64_t timestampNs);
+
+private:
+    bool fail(const std::string& message);
+    void indexBlocks();
+    bool nextBlock();
+    void startDecoding();
+    void stopDecoding();
+    void decodeLoop(std::size_t firstBlock);
+
+    RecordingHeader header_ = {};
+    std::string error_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t pos_ = 0;
+    std::vector<std::size_t> blocks_; // File offsets of complete blocks
+    std::size_t nextBlock_ = 0;       // Where decoding (re)starts after a seek
+
+    // Two decoded blocks: the consumer reads one while the helper fills the other
+    SampleBlockDecoder decoders_[2];
+    const SampleBlockDecoder* current_ = nullptr;
+    std::size_t blockPos_ = 0; // Next sample within *current_
+    std::thread decodeThread_;
+    std::mutex decodeMutex_;
+    std::condition_variable decodeCv_;
+    std::size_t produced_ = 0;
+    std::size_t consumed_ = 0;
+    bool decodeDone_ = false;
+    bool decodeStop_ = false;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+#else
+    void* map_ = nullptr;
+#endif
+};
+
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// One-pass min/max/sum/sum-of-squares over a contiguous array. Sums are taken
+// over (value - shift); shifting by a representative value (e.g. the first
+// sample) keeps the variance numerically stable for large offsets.
+struct ReduceResult {
+    std::size_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;         // sum of (value - shift)
+    double sumSquares = 0.0;  // sum of (value - shift)^2
+    double shift = 0.0;
+
+    double mean() const { return count ? shift + sum / count : 0.0; }
+    double variance() const;
+};
+
+enum class ReduceIsa {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+// Widest instruction set supported by the running CPU (checked once)
+ReduceIsa detectReduceIsa();
+bool isReduceIsaSupported(ReduceIsa isa);
+const char* reduceIsaName(ReduceIsa isa);
+
+// Runtime-dispatched fused reduction
+ReduceResult reduceFused(const double* values, std::size_t count, double shift);
+// Reduction with an explicit kernel; isa must be supported (for tests and benchmarks)
+ReduceResult reduceFusedWith(ReduceIsa isa, const double* values, std::size_t count, double shift);
+// Integer series: exact integer min/max/sum in one scalar pass, squares in double
+ReduceResult reduceFused(const uint64_t* values, std::size_t count, double shift, uint64_t& exactSum);
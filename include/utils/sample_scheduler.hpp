@@ -0,0 +1,121 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "statistics.hpp"
+
+// Time source for SampleScheduler; tests inject a fake clock to drive
+// sub-millisecond schedules deterministically.
+class ISchedulerClock {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    virtual ~ISchedulerClock() = default;
+    virtual time_point now() = 0;
+    // Blocks until deadline. Returns false if woken early by an external event.
+    virtual bool sleepUntil(time_point deadline) = 0;
+};
+
+class SteadySchedulerClock : public ISchedulerClock {
+public:
+    time_point now() override;
+    bool sleepUntil(time_point deadline) override;
+};
+
+#ifndef _WIN32
+// Steady clock whose sleeps also end as soon as wakeFd becomes readable (e.g. a
+// pidfd when the child exits); with wakeFd < 0 it behaves like SteadySchedulerClock
+class WakeableSchedulerClock : public SteadySchedulerClock {
+public:
+    explicit WakeableSchedulerClock(int wakeFd) : wakeFd_(wakeFd) {}
+    void setWakeFd(int wakeFd) { wakeFd_ = wakeFd; }
+    bool sleepUntil(time_point deadline) override;
+
+private:
+    int wakeFd_;
+};
+#endif
+
+// What to do with deadlines that passed while a tick was still running
+enum class OverrunPolicy {
+    Skip,    // Drop the missed deadlines and run the most recent one immediately
+    CatchUp  // Run every missed deadline back to back until on schedule again
+};
+
+/**
+ * Fires ticks on absolute deadlines (start + k * interval) so collection and
+ * console time never accumulate into drift. Wake-up lateness is recorded as
+ * jitter and late ticks as overruns in a TimingStats.
+ */
+class SampleScheduler {
+public:
+    SampleScheduler(std::chrono::nanoseconds interval, OverrunPolicy policy, ISchedulerClock& clock);
+
+    // Sleeps until the next deadline. Returns false if the sleep was interrupted.
+    bool waitNext();
+
+    // Places the next deadline interval after the current one; ticks keep
+    // their absolute grid from there on
+    void setInterval(std::chrono::nanoseconds interval);
+
+    // Deadline of the tick most recently released by waitNext()
+    ISchedulerClock::time_point currentDeadline() const { return current_; }
+    const TimingStats& stats() const { return stats_; }
+
+private:
+    std::chrono::nanoseconds interval_;
+    OverrunPolicy policy_;
+    ISchedulerClock& clock_;
+    ISchedulerClock::time_point next_;
+    ISchedulerClock::time_point current_;
+    double jitterSumUs_ = 0.0;
+    TimingStats stats_;
+};
+
+/**
+ * Chooses the next sampling interval from the samples just taken.
+ *
+ * Each signal (a utilization or usage percentage) is tracked with an
+ * exponentially weighted mean and variance. A tick where any signal moved by
+ * at least the step since the previous sample, or strayed more than three
+ * standard deviations from its recent mean, snaps the interval to the
+ * minimum and holds it there for a few ticks; once every signal is flat
+ * the interval doubles each tick up to the maximum.
+ */
+class AdaptiveInterval {
+public:
+    AdaptiveInterval(std::chrono::nanoseconds minInterval, std::chrono::nanoseconds maxInterval, double step,
+                     std::size_t signalCount);
+
+    // Feeds one tick's signals (signalCount values) and returns the interval
+    // until the next sample
+    std::chrono::nanoseconds observe(const double* signals);
+
+    std::chrono::nanoseconds current() const { return interval_; }
+    std::size_t tightenings() const { return tightenings_; }
+
+    // Ticks kept at the minimum after movement, so a burst is followed closely
+    static constexpr int kHoldTicks = 5;
+
+private:
+    struct Signal {
+        double last = 0.0;
+        double mean = 0.0;
+        double variance = 0.0;
+    };
+
+    std::chrono::nanoseconds min_;
+    std::chrono::nanoseconds max_;
+    double step_;
+    std::vector<Signal> signals_;
+    bool primed_ = false;
+    int hold_ = kHoldTicks; // The first ticks also stay at the minimum while the variance settles
+    std::size_t tightenings_ = 0;
+    std::chrono::nanoseconds interval_;
+};
+
+// Statistics weight of a sample taken at timestampNs when the previous one was
+// taken at previousNs: the time it covers in units of the shortest interval,
+// so a sample after a long flat stretch counts for the whole stretch
+double sampleWeight(int64_t previousNs, int64_t timestampNs, std::chrono::nanoseconds minInterval);
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#ifdef __linux__
+#include "proc_reader.hpp"
+#endif
+
+// CPU time the calling thread has consumed, user plus system, in nanoseconds;
+// 0 where the platform cannot report it
+uint64_t threadCpuTimeNs();
+
+// CPU time of the whole crossmon process, every thread included
+uint64_t processCpuTimeNs();
+
+// crossmon's own footprint at one instant
+struct SelfUsage {
+    uint64_t rssKB = 0;
+    uint64_t syscalls = 0; // Read- and write-class syscalls since start (Linux); 0 elsewhere
+};
+
+/**
+ * Reads crossmon's resident set and syscall counters once per tick.
+ *
+ * On Linux both come from /proc/self (statm and io) through descriptors opened
+ * once, so a read is two preads; macOS asks task_info and Windows
+ * GetProcessMemoryInfo, neither of which counts syscalls.
+ */
+class SelfUsageReader {
+public:
+    SelfUsageReader();
+
+    // False if the resident set could not be read
+    bool read(SelfUsage& usage);
+
+private:
+#ifdef __linux__
+    ProcFile statm_;
+    ProcFile io_; // Unreadable under some sandboxes; syscalls then stay 0
+    uint64_t pageKB_ = 4;
+    char buffer_[512];
+#endif
+};
@@ -4,12 +4,146 @@
 #include <cstdint>
 #include <string>
 
+// Online count/min/max/mean/variance (Welford) in O(1) memory, so statistics
+// can be kept for unbounded sessions without storing the samples
+class RunningStats {
+public:
+    void add(double value) { add(value, 1.0); }
+    // Counts as one sample whose mean and variance share is weight (e.g. the
+    // time it covers); a weight of 1 for every sample is the plain statistics
+    void add(double value, double weight);
+    // Combines two accumulators as if all samples had been added to one
+    void merge(const RunningStats& other);
+
+    std::size_t count() const { return count_; }
+    double min() const { return count_ ? min_ : 0.0; }
+    double max() const { return count_ ? max_ : 0.0; }
+    double mean() const { return mean_; }
+    // Population variance of the samples seen so far
+    double variance() const { return weight_ > 0.0 ? m2_ / weight_ : 0.0; }
+    double stddev() const;
+
+private:
+    std::size_t count_ = 0;
+    double weight_ = 0.0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+/**
+ * Fixed-size log-linear histogram (HDR style) for streaming percentiles.
+ *
+ * Values are quantised to `resolution` units; below 2^(precisionBits+1) units
+ * every unit has its own bucket, above that each power of two is split into
+ * 2^precisionBits buckets, bounding the relative error to 2^-precisionBits
+ * (0.8% at the default 7 bits). The bucket array is sized once from maxValue.
+ * Sketches with the same configuration merge losslessly by adding counts, so
+ * runs can be rolled up without the raw samples.
+ */
+class QuantileSketch {
+public:
+    explicit QuantileSketch(double resolution = 0.01, double maxValue = 100.0, int precisionBits = 7);
+
+    // Values below zero count as zero and values above maxValue as maxValue
+    void add(double value) { add(value, 1); }
+    // Adds value as if it had been seen count times
+    void add(double value, uint64_t count);
+    // Returns false (and changes nothing) if the configurations differ
+    bool merge(const QuantileSketch& other);
+    void clear();
+
+    // Nearest-rank quantile for q in [0, 1]; 0.0 when empty. Bucket midpoints
+    // are clamped to the exact extremes, so a quantile never leaves [min, max]
+    double quantile(double q) const;
+    std::size_t count() const { return total_; }
+    // Exact extremes of the (clamped) values added; 0.0 when empty
+    double min() const { return total_ ? min_ : 0.0; }
+    double max() const { return total_ ? max_ : 0.0; }
+    std::size_t bucketCount() const { return counts_.size(); }
+
+private:
+    std::size_t indexOf(uint64_t units) const;
+    double valueAt(std::size_t index) const;
+
+    double resolution_;
+    int precisionBits_;
+    uint64_t maxUnits_;
+    std::vector<uint64_t> counts_;
+    std::size_t total_ = 0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+// Streaming per-core peak/average plus the per-sample imbalance, kept as one
+// array per quantity so a 256-core row updates a few contiguous arrays
+class PerCoreAccumulator {
+public:
+    void reset(std::size_t coreCount);
+    // Folds in one sample per core; row must hold coreCount() values
+    void add(const double* row) { add(row, 1.0); }
+    // Same, with the sample's share of the averages scaled by weight
+    void add(const double* row, double weight);
+
+    std::size_t coreCount() const { return peak_.size(); }
+    std::size_t sampleCount() const { return samples_; }
+    double peak(std::size_t core) const { return peak_[core]; }
+    double average(std::size_t core) const { return weight_ > 0.0 ? sum_[core] / weight_ : 0.0; }
+    double averageImbalance() const { return weight_ > 0.0 ? imbalanceSum_ / weight_ : 0.0; }
+
+private:
+    std::vector<double> peak_;
+    std::vector<double> sum_;
+    std::size_t samples_ = 0;
+    double weight_ = 0.0;
+    double imbalanceSum_ = 0.0;
+};
+
+// Per-core utilization history stored column-major: each core's samples are
+// contiguous, so per-core reductions stream through memory instead of chasing
+// one small vector per core. Columns share a capacity that doubles as needed.
+class PerCoreSeries {
+public:
+    void reset(std::size_t coreCount);
+    // Appends one sample per core; row must hold coreCount() values
+    void append(const double* row);
+
+    std::size_t coreCount() const { return cores_; }
+    std::size_t sampleCount() const { return samples_; }
+    bool empty() const { return samples_ == 0; }
+    const double* column(std::size_t core) const { return data_.data() + core * capacity_; }
+
+private:
+    std::vector<double> data_;
+    std::size_t cores_ = 0;
+    std::size_t samples_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+struct Percentiles {
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+};
+
+// Stats structs below carry percentiles only when filled from a QuantileSketch;
+// the vector-based compute functions leave them at zero.
 struct CpuStats {
     std::size_t samples = 0;
     double peak = 0.0;
     double average = 0.0;
     double min = 0.0;
     double max = 0.0;
+    double stddev = 0.0;
+    Percentiles percentiles;
+
+    // Per-core breakdown, empty when the platform has no per-core counters
+    std::vector<double> corePeak;
+    std::vector<double> coreAverage;
+    std::size_t busiestCore = 0;   // Core with the highest average
+    double imbalance = 0.0;        // Mean of (busiest core - mean of all cores) per sample, in percentage points
 };
 
 struct MemoryStats {
@@ -22,6 +156,10 @@ struct MemoryStats {
     double avgUsedPercent = 0.0;
     double minUsedPercent = 0.0;
     double maxUsedPercent = 0.0;
+    double stddevUsedMB = 0.0;
+    double stddevUsedPercent = 0.0;
+    Percentiles usedMBPercentiles;
+    Percentiles usedPercentPercentiles;
 };
 
 struct GpuStats {
@@ -30,7 +168,13 @@ struct GpuStats {
     double avgUtilization = 0.0;
     double minUtilization = 0.0;
     double maxUtilization = 0.0;
+    double stddevUtilization = 0.0;
+    Percentiles percentiles;
     std::size_t gpuCount = 0;
+
+    // Per-GPU breakdown, empty when only the combined utilization was sampled
+    std::vector<double> devicePeak;
+    std::vector<double> deviceAverage;
 };
 
 struct NpuStats {
@@ -39,20 +183,170 @@ struct NpuStats {
     double avgUtilization = 0.0;
     double minUtilization = 0.0;
     double maxUtilization = 0.0;
+    double stddevUtilization = 0.0;
+    Percentiles percentiles;
     std::string npuName = "";
 };
 
+// Resource use of the application given with --app, summed over its processes;
+// samples stays 0 when no application was tracked
+struct ProcessStats {
+    std::string name = "";
+    std::size_t samples = 0;
+    std::size_t peakProcesses = 0;
+    double peakCpu = 0.0;      // 100% is one fully busy core
+    double avgCpu = 0.0;
+    uint64_t peakRssKB = 0;
+    uint64_t avgRssKB = 0;
+    uint64_t peakPssKB = 0;
+    uint64_t avgPssKB = 0;
+    uint64_t minorFaults = 0;  // Totals over the run
+    uint64_t majorFaults = 0;
+    uint64_t readBytes = 0;
+    uint64_t writeBytes = 0;
+};
+
+// Exact totals for the command run with crossmon -- CMD, from wait4 rusage;
+// command stays empty when no command was run
+struct CommandStats {
+    std::string command = "";
+    int exitCode = 0;                  // 128 + signal number when killed by a signal
+    double wallSeconds = 0.0;
+    double userSeconds = 0.0;
+    double systemSeconds = 0.0;
+    uint64_t maxRssKB = 0;
+    uint64_t minorFaults = 0;
+    uint64_t majorFaults = 0;
+    uint64_t voluntarySwitches = 0;    // Context switches while waiting for a resource
+    uint64_t involuntarySwitches = 0;  // Context switches forced by preemption
+    uint64_t blockInputOps = 0;        // File system block reads and writes
+    uint64_t blockOutputOps = 0;
+};
+
+// Wall time each collector spent producing one sample, in milliseconds
+struct CollectorLatency {
+    double cpuMs = 0.0;
+    double memoryMs = 0.0;
+    double gpuMs = 0.0;
+    double npuMs = 0.0;
+};
+
+struct LatencyStats {
+    std::size_t samples = 0;
+    CollectorLatency average;
+    CollectorLatency max;
+};
+
+// Sampling schedule accounting; jitter is how late each tick woke up
+struct TimingStats {
+    std::size_t ticks = 0;
+    std::size_t overruns = 0;      // Ticks that started after their deadline had passed
+    std::size_t skippedTicks = 0;  // Deadlines dropped by the skip policy
+    double intervalMs = 0.0;
+    double meanJitterUs = 0.0;
+    double maxJitterUs = 0.0;
+    // Adaptive sampling: intervalMs is then the shortest interval and the
+    // interval stretched up to maxIntervalMs; 0 when the interval was fixed
+    double maxIntervalMs = 0.0;
+    double meanIntervalMs = 0.0;   // Average time between consecutive samples
+    double samplesPerHour = 0.0;
+    std::size_t tightenings = 0;   // Times movement snapped the interval back to the shortest
+};
+
+// crossmon's own cost during one tick. CPU figures are thread CPU time, so a
+// collector blocked in a syscall or waiting on a lock costs nothing here
+struct TickOverhead {
+    CollectorLatency collectorCpu; // Per collector, in milliseconds
+    double collectCpuMs = 0.0;     // Every collector job, process tracking and --top included
+    double outputWallMs = 0.0;     // Statistics, recording, serving and the console line
+    double outputCpuMs = 0.0;
+    uint64_t rssKB = 0;
+    uint64_t syscalls = 0;         // Since the previous tick; 0 where not counted
+};
+
+struct OverheadStats {
+    std::size_t ticks = 0;
+    double intervalMs = 0.0;       // With --adaptive, the current interval per tick and the mean one at the end
+    CollectorLatency averageCollectorCpu;
+    double averageTickCpuMs = 0.0; // Collection plus output
+    double maxTickCpuMs = 0.0;
+    double averageCollectCpuMs = 0.0;
+    double averageOutputWallMs = 0.0;
+    double maxOutputWallMs = 0.0;
+    double averageOutputCpuMs = 0.0;
+    double averageRssKB = 0.0;
+    uint64_t peakRssKB = 0;
+    double averageSyscalls = 0.0;  // Per tick
+    double processCpuSeconds = 0.0; // Whole process over the run, writer and server threads included
+    double wallSeconds = 0.0;
+    double budgetPercent = 0.0;     // Tick CPU limit as a percentage of one core; 0 disables it
+    std::size_t overBudgetTicks = 0;
+
+    // Share of one core a tick used, given its CPU time
+    double tickCpuPercent(double tickCpuMs) const { return intervalMs > 0.0 ? 100.0 * tickCpuMs / intervalMs : 0.0; }
+    double processCpuPercent() const { return wallSeconds > 0.0 ? 100.0 * processCpuSeconds / wallSeconds : 0.0; }
+};
+
+struct HistoryTierStats {
+    double bucketSeconds = 0.0;
+    std::size_t buckets = 0;   // Closed buckets currently retained
+    std::size_t capacity = 0;
+};
+
+// Occupancy of the bounded multi-resolution history
+struct HistoryStats {
+    std::size_t rawSamples = 0;
+    std::size_t rawCapacity = 0;
+    std::vector<HistoryTierStats> tiers;
+    std::size_t footprintBytes = 0;
+};
+
+// Sections of a summary whose source was sampled; one left out with --metrics
+// (or unavailable on the host) is left out of every output format rather than
+// reported as zeros
+struct SummarySections {
+    bool cpu = true;
+    bool memory = true;
+    bool gpu = true;
+    bool npu = true;
+    bool process = true;
+};
+
 struct SystemStats {
+    SummarySections sections;
     CpuStats cpu;
     MemoryStats memory;
     GpuStats gpu;
     NpuStats npu;
+    ProcessStats process;
+    CommandStats command;
+    LatencyStats latency;
+    TimingStats timing;
+    OverheadStats overhead;
+    HistoryStats history;
 };
 
 CpuStats computeCpuStats(const std::vector<double>& values);
+CpuStats computeCpuStats(const std::vector<double>& values, const PerCoreSeries& perCore);
 MemoryStats computeMemoryStats(const std::vector<uint64_t>& usedMB, const std::vector<double>& usedPercent);
 GpuStats computeGpuStats(const std::vector<double>& utilization, std::size_t gpuCount);
 NpuStats computeNpuStats(const std::vector<double>& utilization, const std::string& npuName);
+LatencyStats computeLatencyStats(const std::vector<CollectorLatency>& latencies);
+
+// Streaming counterparts, filled from accumulators updated once per sample
+CpuStats computeCpuStats(const RunningStats& cpu);
+CpuStats computeCpuStats(const RunningStats& cpu, const PerCoreAccumulator& perCore);
+MemoryStats computeMemoryStats(const RunningStats& usedMB, const RunningStats& usedPercent);
+GpuStats computeGpuStats(const RunningStats& utilization, std::size_t gpuCount);
+GpuStats computeGpuStats(const RunningStats& utilization, std::size_t gpuCount, const PerCoreAccumulator& perGpu);
+NpuStats computeNpuStats(const RunningStats& utilization, const std::string& npuName);
+// Copies name, peak process count and run totals from totals, and fills the rest from the accumulators
+ProcessStats computeProcessStats(const RunningStats& cpu, const RunningStats& rssKB, const RunningStats& pssKB,
+                                 const ProcessStats& totals);
+Percentiles computePercentiles(const QuantileSketch& sketch);
+void accumulateLatency(LatencyStats& stats, const CollectorLatency& sample);
+// Needs intervalMs and budgetPercent set beforehand; returns false if the tick went over budget
+bool accumulateOverhead(OverheadStats& stats, const TickOverhead& tick);
 double computePeak(const std::vector<double>& values);
 double computeAverage(const std::vector<double>& values);
 double computeMin(const std::vector<double>& values);
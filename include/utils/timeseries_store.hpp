@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-capacity ring; once full, each push overwrites the oldest element
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t capacity = 0) : data_(capacity) {}
+
+    void push(const T& value) {
+        if (data_.empty()) return;
+        data_[head_] = value;
+        head_ = (head_ + 1) % data_.size();
+        if (size_ < data_.size()) ++size_;
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return data_.size(); }
+    bool empty() const { return size_ == 0; }
+    // Index 0 is the oldest retained element
+    const T& at(std::size_t i) const { return data_[(head_ + data_.size() - size_ + i) % data_.size()]; }
+    const T& back() const { return at(size_ - 1); }
+
+private:
+    std::vector<T> data_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+// Aggregate of every sample whose timestamp fell in [startMs, startMs + tier width)
+struct RollupBucket {
+    int64_t startMs = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    uint32_t count = 0;
+
+    double average() const { return count ? sum / count : 0.0; }
+};
+
+struct RollupTierConfig {
+    int64_t bucketMs;
+    std::size_t capacity; // Closed buckets retained
+};
+
+struct TimeSeriesConfig {
+    std::size_t rawCapacity = 600; // Full-resolution samples retained
+    // 10 s for 6 h, 1 min for 7 days, 1 h for 90 days
+    std::vector<RollupTierConfig> tiers = {
+        {10 * 1000, 6 * 360},
+        {60 * 1000, 7 * 1440},
+        {3600 * 1000, 90 * 24},
+    };
+};
+
+/**
+ * Bounded round-robin history in the spirit of RRD.
+ *
+ * The most recent rawCapacity samples are kept at full resolution; every
+ * sample is also folded at insert time into the open bucket of each coarser
+ * tier, and a bucket is closed into its tier's ring when a sample lands past
+ * its end. Nothing is ever rescanned and all storage is allocated up front,
+ * so the footprint is fixed by the configuration however long the run.
+ */
+class TimeSeriesStore {
+public:
+    enum Metric {
+        Cpu,
+        MemoryUsedMB,
+        MemoryUsedPercent,
+        Gpu,
+        Npu,
+        MetricCount
+    };
+
+    explicit TimeSeriesStore(const TimeSeriesConfig& config = TimeSeriesConfig());
+
+    // values holds one entry per Metric; timestamps must not go backwards. A NaN
+    // entry marks a metric that was not sampled: it is kept as NaN at full
+    // resolution so the columns stay aligned, and left out of the rollups
+    void add(int64_t timestampMs, const double* values);
+
+    std::size_t rawSize() const { return rawTimestamps_.size(); }
+    std::size_t rawCapacity() const { return rawTimestamps_.capacity(); }
+    int64_t rawTimestamp(std::size_t i) const { return rawTimestamps_.at(i); }
+    double rawValue(Metric metric, std::size_t i) const { return rawValues_[metric].at(i); }
+
+    std::size_t tierCount() const { return tierConfig_.size(); }
+    const RollupTierConfig& tierConfig(std::size_t tier) const { return tierConfig_[tier]; }
+    // Closed buckets of a tier, oldest first; the bucket still being filled is openBucket()
+    const RingBuffer<RollupBucket>& tier(Metric metric, std::size_t tier) const;
+    const RollupBucket& openBucket(Metric metric, std::size_t tier) const;
+
+    // Bytes reserved for samples and buckets, fixed at construction
+    std::size_t footprintBytes() const;
+
+private:
+    struct MetricTier {
+        RingBuffer<RollupBucket> closed;
+        RollupBucket open;
+    };
+
+    std::vector<RollupTierConfig> tierConfig_;
+    RingBuffer<int64_t> rawTimestamps_;
+    std::vector<RingBuffer<double>> rawValues_;
+    std::vector<MetricTier> tiers_; // MetricCount * tierCount, metric-major
+};
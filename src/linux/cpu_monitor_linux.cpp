@@ -0,0 +1,142 @@
+#include "cpu_monitor.hpp"
+#include "utils/proc_reader.hpp"
+#include <string>
+#include <vector>
+
+class LinuxCpuMonitor : public ICpuMonitor {
+public:
+    explicit LinuxCpuMonitor(const std::string& procRoot) : statFile(procRoot + "/stat") {
+        readAggregateTicks(lastTicks);
+        discoverCores();
+    }
+
+    double getCpuBusy() override {
+        CpuTicks nowTicks;
+        if (!readAggregateTicks(nowTicks)) return 0.0;
+        double busy = busyPercent(lastTicks, nowTicks);
+        lastTicks = nowTicks;
+        return busy;
+    }
+
+    bool isSupported() const override {
+        return statFile.isOpen();
+    }
+
+    std::size_t getCoreCount() const override {
+        return lastCoreTicks.size();
+    }
+
+    std::size_t getPerCoreBusy(double* out, std::size_t capacity) override {
+        std::size_t count = capacity < lastCoreTicks.size() ? capacity : lastCoreTicks.size();
+        for (std::size_t i = 0; i < count; ++i) out[i] = 0.0;
+        long len = statFile.readAll(coreBuffer.data(), coreBuffer.size());
+        if (len <= 0) return count;
+
+        const char* p = coreBuffer.data();
+        const char* end = p + len;
+        p = procscan::skipToNextLine(p, end); // aggregate line
+        // Offline cores have no line, so the index is parsed rather than assumed
+        while (p < end && procscan::startsWith(p, end, "cpu", 3)) {
+            uint64_t index = 0;
+            const char* next = procscan::parseUint64(p + 3, end, index);
+            CpuTicks ticks;
+            if (next && index < lastCoreTicks.size() && parseTicks(next, end, ticks)) {
+                if (index < count) out[index] = busyPercent(lastCoreTicks[index], ticks);
+                lastCoreTicks[index] = ticks;
+            }
+            p = procscan::skipToNextLine(p, end);
+        }
+        return count;
+    }
+
+private:
+    struct CpuTicks {
+        uint64_t total = 0;
+        uint64_t idle = 0;
+    };
+
+    ProcFile statFile;
+    CpuTicks lastTicks;
+    std::vector<CpuTicks> lastCoreTicks;
+    // The aggregate "cpu" line is always first, so the head of the file is enough
+    char buffer[1024];
+    // Sized once in discoverCores() to cover every per-core line
+    std::vector<char> coreBuffer;
+
+    static double busyPercent(const CpuTicks& before, const CpuTicks& after) {
+        // Counters only move forward; a smaller value means CPU hotplug reset them
+        uint64_t totalDelta = after.total > before.total ? after.total - before.total : 0;
+        uint64_t idleDelta = after.idle > before.idle ? after.idle - before.idle : 0;
+        if (totalDelta == 0 || idleDelta > totalDelta) return 0.0;
+        return 100.0 * (totalDelta - idleDelta) / totalDelta;
+    }
+
+    // Parses the tick columns that follow a "cpu"/"cpuN" label
+    static bool parseTicks(const char* p, const char* end, CpuTicks& ticks) {
+        // user nice system idle iowait irq softirq steal; guest and guest_nice are
+        // already accounted in user and nice, so they are not added again
+        uint64_t fields[8] = {};
+        for (int i = 0; i < 8; ++i) {
+            const char* next = procscan::parseUint64(p, end, fields[i]);
+            if (!next) {
+                if (i < 4) return false;
+                break; // older kernels report fewer columns
+            }
+            p = next;
+        }
+
+        ticks.total = 0;
+        for (uint64_t field : fields) ticks.total += field;
+        ticks.idle = fields[3] + fields[4];
+        return true;
+    }
+
+    bool readAggregateTicks(CpuTicks& ticks) {
+        long len = statFile.readAll(buffer, sizeof(buffer));
+        if (len <= 0) return false;
+        const char* end = buffer + len;
+        if (!procscan::startsWith(buffer, end, "cpu ", 4)) return false;
+        return parseTicks(buffer + 4, end, ticks);
+    }
+
+    // Reads the whole cpu block once to size the per-core state; nothing is
+    // allocated after this
+    void discoverCores() {
+        std::vector<char> scratch(64 * 1024);
+        long len = -1;
+        while (true) {
+            len = statFile.readAll(scratch.data(), scratch.size());
+            if (len < 0 || static_cast<std::size_t>(len) + 1 < scratch.size()) break;
+            scratch.resize(scratch.size() * 2);
+        }
+        if (len <= 0) return;
+
+        const char* begin = scratch.data();
+        const char* p = begin;
+        const char* end = begin + len;
+        p = procscan::skipToNextLine(p, end);
+        std::size_t coreCount = 0;
+        while (p < end && procscan::startsWith(p, end, "cpu", 3)) {
+            uint64_t index = 0;
+            if (procscan::parseUint64(p + 3, end, index) && index + 1 > coreCount) {
+                coreCount = static_cast<std::size_t>(index + 1);
+            }
+            p = procscan::skipToNextLine(p, end);
+        }
+
+        lastCoreTicks.assign(coreCount, CpuTicks{});
+        // Leave headroom for counters growing by a few digits during the run
+        coreBuffer.assign(static_cast<std::size_t>(p - begin) + 64 * (coreCount + 1) + 1, '\0');
+        double* discard = nullptr;
+        getPerCoreBusy(discard, 0);
+    }
+};
+
+ICpuMonitor* createLinuxCpuMonitor(const std::string& procRoot) {
+    return new LinuxCpuMonitor(procRoot);
+}
+
+// Factory function for use elsewhere
+ICpuMonitor* createCpuMonitor() {
+    return new LinuxCpuMonitor("/proc");
+}
@@ -0,0 +1,327 @@
+#include "gpu_monitor.hpp"
+#include "utils/proc_reader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+// drm-engine-* counters of clients that appear between rescans are picked up
+// at the next one; opening a DRM device is rare, walking every fd is not cheap
+constexpr uint64_t kClientRescanNs = 5000000000ull;
+constexpr uint64_t kNoBaseline = UINT64_MAX;
+
+uint64_t steadyClockNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool isCardName(const std::string& name) {
+    if (name.size() <= 4 || name.compare(0, 4, "card") != 0) return false;
+    return std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+std::string readFirstLine(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// Value of KEY=value in a uevent file
+std::string ueventValue(const std::filesystem::path& path, const std::string& key) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.size() > key.size() && line.compare(0, key.size(), key) == 0 && line[key.size()] == '=') {
+            return line.substr(key.size() + 1);
+        }
+    }
+    return std::string();
+}
+
+// Reads a sysfs attribute holding one unsigned decimal
+bool readValue(const ProcFile& file, uint64_t& value) {
+    char buf[32];
+    long len = file.readAll(buf, sizeof(buf));
+    return len > 0 && procscan::parseUint64(buf, buf + len, value) != nullptr;
+}
+
+// Value of "key:\t<value>" when the line at p starts with key
+const char* fdinfoValue(const char* p, const char* end, const char* key, std::size_t keyLength) {
+    if (!procscan::startsWith(p, end, key, keyLength)) return nullptr;
+    return procscan::skipSpaces(p + keyLength, end);
+}
+
+const char* lineEnd(const char* p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    return p;
+}
+}
+
+class LinuxGpuMonitor : public IGpuMonitor {
+public:
+    LinuxGpuMonitor(const std::string& sysRoot, const std::string& procRoot, uint64_t (*clockNs)())
+        : procRoot(procRoot), clockNs(clockNs ? clockNs : steadyClockNs) {
+        enumerateCards(sysRoot + "/class/drm");
+        lastNs = this->clockNs();
+        for (Card& card : cards) {
+            if (card.energy.isOpen() && !readValue(card.energy, card.lastEnergyUJ)) card.energy.close();
+            watchClients = watchClients || !card.busy.isOpen();
+        }
+        if (watchClients) {
+            pids.reserve(1024);
+            scanClients(lastNs);
+        }
+    }
+
+    GpuUsage getGpuUsage() override {
+        uint64_t now = clockNs();
+        uint64_t elapsedNs = now > lastNs ? now - lastNs : 0;
+        lastNs = now;
+        if (watchClients) {
+            if (now - lastScanNs >= kClientRescanNs) scanClients(now);
+            sampleClients();
+        }
+
+        GpuUsage usage;
+        usage.averageUtilization = 0.0;
+        usage.gpus.reserve(cards.size());
+        for (Card& card : cards) {
+            GpuInfo info;
+            info.name = card.name;
+            info.utilizationPercent = utilization(card, elapsedNs);
+            info.temperature = 0;
+            info.powerUsage = 0;
+            uint64_t value = 0;
+            if (card.temperature.isOpen() && readValue(card.temperature, value)) {
+                info.temperature = static_cast<uint32_t>(value / 1000); // millidegrees
+            }
+            if (card.power.isOpen() && readValue(card.power, value)) {
+                info.powerUsage = static_cast<uint32_t>(value / 1000000); // microwatts
+            } else if (card.energy.isOpen() && readValue(card.energy, value)) {
+                // Microjoules over nanoseconds: W = uJ * 1e3 / ns
+                if (elapsedNs > 0 && value > card.lastEnergyUJ) {
+                    info.powerUsage = static_cast<uint32_t>((value - card.lastEnergyUJ) * 1000 / elapsedNs);
+                }
+                card.lastEnergyUJ = value;
+            }
+            usage.averageUtilization += info.utilizationPercent;
+            usage.gpus.push_back(std::move(info));
+        }
+        if (!cards.empty()) usage.averageUtilization /= static_cast<double>(cards.size());
+        return usage;
+    }
+
+    bool isSupported() const override {
+        return !cards.empty();
+    }
+
+    size_t getGpuCount() const override {
+        return cards.size();
+    }
+
+private:
+    struct Card {
+        std::string name;
+        std::string pciSlot;  // Matched against drm-pdev in client fdinfo
+        ProcFile busy;        // gpu_busy_percent (amdgpu)
+        ProcFile temperature; // hwmon temp1_input, millidegrees Celsius
+        ProcFile power;       // hwmon power1_average or power1_input, microwatts
+        ProcFile energy;      // hwmon energy1_input, microjoules; used when there is no power file
+        uint64_t lastEnergyUJ = 0;
+        // Engine classes seen in client fdinfo, with their capacity and the
+        // busy time all clients added this tick
+        std::vector<std::string> engines;
+        std::vector<uint64_t> capacity;
+        std::vector<uint64_t> busyNs;
+    };
+
+    // One DRM file description; dup'ed or inherited fds share a client id and are read once
+    struct Client {
+        int pid = 0;
+        std::size_t card = 0;
+        uint64_t id = 0;
+        ProcFile fdinfo;
+        std::vector<uint64_t> lastNs;  // Per engine of the card
+        bool seen = false;
+    };
+
+    std::string procRoot;
+    uint64_t (*clockNs)();
+    std::vector<Card> cards;
+    std::vector<Client> clients;
+    bool watchClients = false;
+    uint64_t lastNs = 0;
+    uint64_t lastScanNs = 0;
+    ProcDirectory procDir;
+    std::vector<int> pids;
+    char buffer[4096];
+
+    void enumerateCards(const std::string& drmRoot) {
+        std::error_code ec;
+        std::vector<std::string> names;
+        for (const auto& entry : std::filesystem::directory_iterator(drmRoot, ec)) {
+            std::string name = entry.path().filename().string();
+            if (isCardName(name)) names.push_back(name);
+        }
+        // card10 after card9
+        std::sort(names.begin(), names.end(), [](const std::string& a, const std::string& b) {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+        for (const std::string& name : names) {
+            std::filesystem::path device = std::filesystem::path(drmRoot) / name / "device";
+            Card card;
+            card.pciSlot = ueventValue(device / "uevent", "PCI_SLOT_NAME");
+            card.name = readFirstLine(device / "product_name");
+            if (card.name.empty()) {
+                std::string driver = ueventValue(device / "uevent", "DRIVER");
+                card.name = driver.empty() ? name : driver + " " + card.pciSlot;
+            }
+            card.busy.open((device / "gpu_busy_percent").string());
+            for (const auto& hwmon : std::filesystem::directory_iterator(device / "hwmon", ec)) {
+                std::string dir = hwmon.path().string();
+                card.temperature.open(dir + "/temp1_input");
+                if (!card.power.open(dir + "/power1_average")) card.power.open(dir + "/power1_input");
+                if (!card.power.isOpen()) card.energy.open(dir + "/energy1_input");
+                break;
+            }
+            cards.push_back(std::move(card));
+        }
+    }
+
+    std::size_t engineIndex(Card& card, const char* name, std::size_t length) {
+        for (std::size_t i = 0; i < card.engines.size(); ++i) {
+            if (card.engines[i].size() == length && std::memcmp(card.engines[i].data(), name, length) == 0) return i;
+        }
+        card.engines.emplace_back(name, length);
+        card.capacity.push_back(1);
+        card.busyNs.push_back(0);
+        return card.engines.size() - 1;
+    }
+
+    // Walks <procRoot>/PID/fd for DRM device nodes and keeps one fdinfo per client
+    void scanClients(uint64_t now) {
+        lastScanNs = now;
+        for (Client& client : clients) client.seen = false;
+        if (!procDir.isOpen()) procDir.open(procRoot);
+        if (procDir.listPids(pids)) {
+            std::error_code ec;
+            for (int pid : pids) {
+                std::string dir = procRoot + "/" + std::to_string(pid);
+                for (const auto& fd : std::filesystem::directory_iterator(dir + "/fd", ec)) {
+                    std::string target = std::filesystem::read_symlink(fd.path(), ec).string();
+                    if (ec || target.compare(0, 9, "/dev/dri/") != 0) continue;
+                    addClient(pid, dir + "/fdinfo/" + fd.path().filename().string());
+                }
+            }
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(), [](const Client& c) { return !c.seen; }),
+                      clients.end());
+    }
+
+    void addClient(int pid, const std::string& fdinfoPath) {
+        Client client;
+        if (!client.fdinfo.open(fdinfoPath)) return;
+        long len = client.fdinfo.readAll(buffer, sizeof(buffer));
+        if (len <= 0) return;
+        const char* end = buffer + len;
+        const char* pdev = nullptr;
+        std::size_t pdevLength = 0;
+        bool hasId = false;
+        for (const char* p = buffer; p < end; p = procscan::skipToNextLine(p, end)) {
+            if (const char* v = fdinfoValue(p, end, "drm-pdev:", 9)) {
+                pdev = v;
+                pdevLength = static_cast<std::size_t>(lineEnd(v, end) - v);
+            } else if (const char* v = fdinfoValue(p, end, "drm-client-id:", 14)) {
+                hasId = procscan::parseUint64(v, end, client.id) != nullptr;
+            }
+        }
+        if (!pdev || !hasId) return;
+        auto card = std::find_if(cards.begin(), cards.end(), [&](const Card& c) {
+            return c.pciSlot.size() == pdevLength && std::memcmp(c.pciSlot.data(), pdev, pdevLength) == 0;
+        });
+        if (card == cards.end() || card->busy.isOpen()) return;
+        client.card = static_cast<std::size_t>(card - cards.begin());
+        for (Client& known : clients) {
+            if (known.card == client.card && known.id == client.id) {
+                known.seen = true;
+                return;
+            }
+        }
+        client.pid = pid;
+        client.seen = true;
+        // The counters read now are the baseline; busy time is counted from the next tick
+        readEngines(client, buffer, end, false);
+        clients.push_back(std::move(client));
+    }
+
+    // Parses drm-engine-<name> (ns) and drm-engine-capacity-<name> lines. With
+    // accumulate, the growth since the last read is added to the card's busy time.
+    void readEngines(Client& client, const char* p, const char* end, bool accumulate) {
+        Card& card = cards[client.card];
+        for (; p < end; p = procscan::skipToNextLine(p, end)) {
+            if (!procscan::startsWith(p, end, "drm-engine-", 11)) continue;
+            bool isCapacity = procscan::startsWith(p, end, "drm-engine-capacity-", 20);
+            const char* name = p + (isCapacity ? 20 : 11);
+            const char* colon = name;
+            while (colon < end && *colon != ':' && *colon != '\n') ++colon;
+            if (colon >= end || *colon != ':') continue;
+            uint64_t value = 0;
+            if (!procscan::parseUint64(colon + 1, end, value)) continue;
+            std::size_t engine = engineIndex(card, name, static_cast<std::size_t>(colon - name));
+            if (isCapacity) {
+                card.capacity[engine] = std::max<uint64_t>(value, 1);
+                continue;
+            }
+            if (engine >= client.lastNs.size()) client.lastNs.resize(card.engines.size(), kNoBaseline);
+            uint64_t& last = client.lastNs[engine];
+            if (accumulate && last != kNoBaseline && value > last) card.busyNs[engine] += value - last;
+            last = value;
+        }
+    }
+
+    void sampleClients() {
+        for (Card& card : cards) std::fill(card.busyNs.begin(), card.busyNs.end(), 0);
+        for (std::size_t i = 0; i < clients.size();) {
+            long len = clients[i].fdinfo.readAll(buffer, sizeof(buffer));
+            if (len <= 0) {
+                // The process exited or closed the device
+                if (i + 1 < clients.size()) clients[i] = std::move(clients.back());
+                clients.pop_back();
+                continue;
+            }
+            readEngines(clients[i], buffer, buffer + len, true);
+            ++i;
+        }
+    }
+
+    // Busiest engine class, as a share of its capacity over the interval
+    double utilization(const Card& card, uint64_t elapsedNs) {
+        uint64_t busy = 0;
+        if (card.busy.isOpen()) {
+            return readValue(card.busy, busy) ? static_cast<double>(std::min<uint64_t>(busy, 100)) : 0.0;
+        }
+        if (elapsedNs == 0) return 0.0;
+        double percent = 0.0;
+        for (std::size_t i = 0; i < card.engines.size(); ++i) {
+            double share = 100.0 * static_cast<double>(card.busyNs[i]) /
+                           (static_cast<double>(elapsedNs) * static_cast<double>(card.capacity[i]));
+            percent = std::max(percent, share);
+        }
+        return std::min(percent, 100.0);
+    }
+};
+
+IGpuMonitor* createLinuxGpuMonitor(const std::string& sysRoot, const std::string& procRoot, uint64_t (*clockNs)()) {
+    return new LinuxGpuMonitor(sysRoot, procRoot, clockNs);
+}
+
+// Factory function for use elsewhere
+IGpuMonitor* createGpuMonitor() {
+    return createLinuxGpuMonitor("/sys", "/proc");
+}
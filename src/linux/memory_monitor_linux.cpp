@@ -0,0 +1,128 @@
+#include "memory_monitor.hpp"
+#include "utils/proc_reader.hpp"
+#include <string>
+
+namespace {
+constexpr uint64_t kKbPerMb = 1024;
+
+struct MeminfoKb {
+    uint64_t memTotal = 0;
+    uint64_t memFree = 0;
+    uint64_t memAvailable = 0;
+    uint64_t buffers = 0;
+    uint64_t cached = 0;
+    uint64_t swapTotal = 0;
+    uint64_t swapFree = 0;
+    uint64_t dirty = 0;
+    uint64_t writeback = 0;
+    uint64_t shmem = 0;
+    bool hasMemTotal = false;
+    bool hasMemAvailable = false;
+};
+
+// Maps a meminfo key to its slot; keys are dispatched on length first so most
+// of the ~50 lines are rejected without a string compare
+uint64_t* fieldForKey(MeminfoKb& kb, const char* key, std::size_t len) {
+    using procscan::startsWith;
+    const char* end = key + len;
+    switch (len) {
+    case 5:
+        if (startsWith(key, end, "Dirty", 5)) return &kb.dirty;
+        if (startsWith(key, end, "Shmem", 5)) return &kb.shmem;
+        break;
+    case 6:
+        if (startsWith(key, end, "Cached", 6)) return &kb.cached;
+        break;
+    case 7:
+        if (startsWith(key, end, "MemFree", 7)) return &kb.memFree;
+        if (startsWith(key, end, "Buffers", 7)) return &kb.buffers;
+        break;
+    case 8:
+        if (startsWith(key, end, "MemTotal", 8)) { kb.hasMemTotal = true; return &kb.memTotal; }
+        if (startsWith(key, end, "SwapFree", 8)) return &kb.swapFree;
+        break;
+    case 9:
+        if (startsWith(key, end, "SwapTotal", 9)) return &kb.swapTotal;
+        if (startsWith(key, end, "Writeback", 9)) return &kb.writeback;
+        break;
+    case 12:
+        if (startsWith(key, end, "MemAvailable", 12)) { kb.hasMemAvailable = true; return &kb.memAvailable; }
+        break;
+    default:
+        break;
+    }
+    return nullptr;
+}
+}
+
+bool parseMeminfo(const char* text, std::size_t length, MemoryUsage& usage) {
+    MeminfoKb kb;
+    const char* p = text;
+    const char* end = text + length;
+    while (p < end) {
+        const char* key = p;
+        while (p < end && *p != ':' && *p != '\n') ++p;
+        if (p < end && *p == ':') {
+            uint64_t* field = fieldForKey(kb, key, static_cast<std::size_t>(p - key));
+            if (field) procscan::parseUint64(p + 1, end, *field);
+        }
+        p = procscan::skipToNextLine(p, end);
+    }
+    if (!kb.hasMemTotal) return false;
+
+    // Kernels before 3.14 lack MemAvailable; approximate it the way free(1) used to
+    if (!kb.hasMemAvailable) {
+        kb.memAvailable = kb.memFree + kb.buffers + kb.cached;
+    }
+    if (kb.memAvailable > kb.memTotal) kb.memAvailable = kb.memTotal;
+
+    usage.totalPhysicalMB = kb.memTotal / kKbPerMb;
+    usage.availablePhysicalMB = kb.memAvailable / kKbPerMb;
+    usage.usedPhysicalMB = (kb.memTotal - kb.memAvailable) / kKbPerMb;
+    usage.usedPercentage = kb.memTotal ? (double)(kb.memTotal - kb.memAvailable) / kb.memTotal * 100.0 : 0.0;
+
+    // Swap backs the virtual fields
+    uint64_t swapFree = kb.swapFree > kb.swapTotal ? kb.swapTotal : kb.swapFree;
+    usage.totalVirtualMB = kb.swapTotal / kKbPerMb;
+    usage.availableVirtualMB = swapFree / kKbPerMb;
+    usage.usedVirtualMB = (kb.swapTotal - swapFree) / kKbPerMb;
+
+    usage.pageCacheMB = kb.cached / kKbPerMb;
+    usage.buffersMB = kb.buffers / kKbPerMb;
+    usage.dirtyMB = kb.dirty / kKbPerMb;
+    usage.writebackMB = kb.writeback / kKbPerMb;
+    usage.shmemMB = kb.shmem / kKbPerMb;
+    return true;
+}
+
+class LinuxMemoryMonitor : public IMemoryMonitor {
+public:
+    explicit LinuxMemoryMonitor(const std::string& procRoot) : meminfoFile(procRoot + "/meminfo") {}
+
+    MemoryUsage getMemoryUsage() override {
+        MemoryUsage usage = {};
+        long len = meminfoFile.readAll(buffer, sizeof(buffer));
+        if (len > 0) {
+            parseMeminfo(buffer, static_cast<std::size_t>(len), usage);
+        }
+        return usage;
+    }
+
+    bool isSupported() const override {
+        return meminfoFile.isOpen();
+    }
+
+private:
+    ProcFile meminfoFile;
+    // /proc/meminfo is ~1.5 KB on current kernels; reused for every sample
+    char buffer[8192];
+};
+
+IMemoryMonitor* createLinuxMemoryMonitor(const std::string& procRoot) {
+    return new LinuxMemoryMonitor(procRoot);
+}
+
+// Factory function for use elsewhere
+IMemoryMonitor* createMemoryMonitor() {
+    return new LinuxMemoryMonitor("/proc");
+}
@@ -0,0 +1,185 @@
+#include "process_monitor.hpp"
+#include "utils/proc_reader.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+class LinuxProcessMonitor : public IProcessMonitor {
+public:
+    explicit LinuxProcessMonitor(const std::string& procRoot)
+        : procRoot(procRoot), statFile(procRoot + "/stat"), pageKB(static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024) {
+        countCores();
+        readSystemTicks(lastSystemTicks);
+    }
+
+    void track(const std::vector<int>& pids) override {
+        // Processes that stay tracked keep their descriptors and baselines, so
+        // a growing process tree only opens files for the new members
+        std::sort(processes.begin(), processes.end(),
+                  [](const Tracked& a, const Tracked& b) { return a.pid < b.pid; });
+        std::vector<int> wanted(pids);
+        std::sort(wanted.begin(), wanted.end());
+        std::vector<Tracked> next;
+        next.reserve(wanted.size());
+        std::size_t old = 0;
+        for (int pid : wanted) {
+            while (old < processes.size() && processes[old].pid < pid) ++old;
+            if (old < processes.size() && processes[old].pid == pid) {
+                next.push_back(std::move(processes[old++]));
+                continue;
+            }
+            std::string dir = procRoot + "/" + std::to_string(pid);
+            Tracked tracked;
+            tracked.pid = pid;
+            if (!tracked.stat.open(dir + "/stat")) continue;
+            // Both are optional: smaps_rollup needs Linux 4.14 and io may be unreadable
+            tracked.smaps.open(dir + "/smaps_rollup");
+            tracked.io.open(dir + "/io");
+            if (!readCounters(tracked, tracked.last)) continue;
+            next.push_back(std::move(tracked));
+        }
+        processes = std::move(next);
+    }
+
+    ProcessUsage getProcessUsage() override {
+        ProcessUsage usage;
+        uint64_t systemTicks = 0;
+        uint64_t elapsedTicks = 0;
+        if (readSystemTicks(systemTicks)) {
+            elapsedTicks = systemTicks > lastSystemTicks ? systemTicks - lastSystemTicks : 0;
+            lastSystemTicks = systemTicks;
+        }
+
+        uint64_t cpuTicks = 0;
+        for (std::size_t i = 0; i < processes.size();) {
+            Tracked& tracked = processes[i];
+            Counters now;
+            if (!readCounters(tracked, now)) {
+                // Exited; swap-remove keeps the remaining descriptors untouched
+                if (i + 1 < processes.size()) processes[i] = std::move(processes.back());
+                processes.pop_back();
+                continue;
+            }
+            const Counters& last = tracked.last;
+            cpuTicks += delta(last.cpuTicks, now.cpuTicks);
+            usage.minorFaults += delta(last.minorFaults, now.minorFaults);
+            usage.majorFaults += delta(last.majorFaults, now.majorFaults);
+            usage.readBytes += delta(last.readBytes, now.readBytes);
+            usage.writeBytes += delta(last.writeBytes, now.writeBytes);
+            usage.rssKB += now.rssKB;
+            usage.pssKB += now.pssKB;
+            tracked.last = now;
+            ++i;
+        }
+        usage.processes = processes.size();
+        // The aggregate line advances once per tick on every core, so one core's
+        // worth of wall time is elapsedTicks / cores. The process counters are
+        // read after /proc/stat and can run ahead of it by a tick, which on a
+        // single core reads as more than 100%; no process can use more than
+        // every core
+        if (elapsedTicks > 0 && cores > 0) {
+            usage.cpuPercent = std::min(100.0 * static_cast<double>(cpuTicks) * cores / static_cast<double>(elapsedTicks),
+                                        100.0 * static_cast<double>(cores));
+        }
+        return usage;
+    }
+
+    bool isSupported() const override {
+        return statFile.isOpen();
+    }
+
+private:
+    struct Counters {
+        uint64_t cpuTicks = 0;
+        uint64_t minorFaults = 0;
+        uint64_t majorFaults = 0;
+        uint64_t readBytes = 0;
+        uint64_t writeBytes = 0;
+        uint64_t rssKB = 0;
+        uint64_t pssKB = 0;
+    };
+
+    // Descriptors stay open for the life of the process, so a sample is three
+    // preads; they stay bound to it, so a reused PID reads as an exit
+    struct Tracked {
+        int pid = 0;
+        ProcFile stat;
+        ProcFile smaps;
+        ProcFile io;
+        Counters last;
+    };
+
+    std::string procRoot;
+    ProcFile statFile;
+    uint64_t pageKB;
+    std::size_t cores = 0;
+    uint64_t lastSystemTicks = 0;
+    std::vector<Tracked> processes;
+    char buffer[4096];
+
+    static uint64_t delta(uint64_t before, uint64_t after) {
+        return after > before ? after - before : 0;
+    }
+
+    // Reads "<label> <value>" style lines (smaps_rollup, io) into the matching outputs
+    static void scanLabeled(const char* p, const char* end, const char* const* labels, const std::size_t* lengths,
+                            uint64_t* const* values, std::size_t count) {
+        while (p < end) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (procscan::startsWith(p, end, labels[i], lengths[i])) {
+                    procscan::parseUint64(p + lengths[i], end, *values[i]);
+                    break;
+                }
+            }
+            p = procscan::skipToNextLine(p, end);
+        }
+    }
+
+    bool readCounters(const Tracked& tracked, Counters& counters) {
+        long len = tracked.stat.readAll(buffer, sizeof(buffer));
+        if (len <= 0) return false;
+        PidStat stat;
+        if (!parsePidStat(buffer, buffer + len, stat)) return false;
+        counters.minorFaults = stat.minorFaults;
+        counters.majorFaults = stat.majorFaults;
+        counters.cpuTicks = stat.userTicks + stat.systemTicks;
+        counters.rssKB = stat.rssPages * pageKB;
+        counters.pssKB = 0;
+
+        if (tracked.smaps.isOpen()) {
+            len = tracked.smaps.readAll(buffer, sizeof(buffer));
+            if (len > 0) {
+                static const char* const labels[] = {"Rss:", "Pss:"};
+                static const std::size_t lengths[] = {4, 4};
+                uint64_t* values[] = {&counters.rssKB, &counters.pssKB};
+                scanLabeled(buffer, buffer + len, labels, lengths, values, 2);
+            }
+        }
+        if (tracked.io.isOpen()) {
+            len = tracked.io.readAll(buffer, sizeof(buffer));
+            if (len > 0) {
+                static const char* const labels[] = {"read_bytes:", "write_bytes:"};
+                static const std::size_t lengths[] = {11, 12};
+                uint64_t* values[] = {&counters.readBytes, &counters.writeBytes};
+                scanLabeled(buffer, buffer + len, labels, lengths, values, 2);
+            }
+        }
+        return true;
+    }
+
+    bool readSystemTicks(uint64_t& total) {
+        long len = statFile.readAll(buffer, sizeof(buffer));
+        return len > 0 && parseAggregateCpuTicks(buffer, buffer + len, total);
+    }
+
+    void countCores() {
+        std::vector<char> scratch;
+        long len = statFile.readAll(scratch);
+        if (len > 0) cores = countCpuLines(scratch.data(), scratch.data() + len);
+    }
+};
+
+IProcessMonitor* createLinuxProcessMonitor(const std::string& procRoot) {
+    return new LinuxProcessMonitor(procRoot);
+}
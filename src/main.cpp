@@ -13,6 +13,7 @@
 #include "utils/monitor_args.hpp"
 #include "utils/monitor_utils.hpp"
 #include "utils/process_manager.hpp"
+#include "utils/metric_sources.hpp"
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -48,6 +49,25 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // List the metric sources compiled in for this platform
+    if (args.listMetrics) {
+        printMetricSources();
+        return 0;
+    }
+
+    OutputFormat format = OutputFormat::Text;
+    parseOutputFormat(args.outputFormat, format);
+
+    // Recompute statistics from a recording instead of sampling
+    if (!args.replayPath.empty()) {
+        SystemSamples samples;
+        if (!replaySystemUsage(args, samples)) {
+            return 1;
+        }
+        outputSystemStatistics(samples, args.resultPath, format);
+        return 0;
+    }
+
     // Launch the app if specified
     if (!args.appName.empty()) {
         launchApp(args.appName);
@@ -55,10 +75,13 @@ int main(int argc, char* argv[]) {
 
     // Monitor system usage (CPU + Memory + GPU)
     SystemSamples samples;
-    monitorSystemUsage(args, samples);
+    if (!monitorSystemUsage(args, samples)) {
+        return 1;
+    }
 
     // Output statistics
-    outputSystemStatistics(samples, args.resultPath);
+    outputSystemStatistics(samples, args.resultPath, format);
 
-    return 0;
+    // A wrapped command's exit status passes through, so crossmon can stand in for it in scripts
+    return args.command.empty() ? 0 : samples.command.exitCode;
 } 
\ No newline at end of file
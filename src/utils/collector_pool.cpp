@@ -0,0 +1,76 @@
+#include "utils/collector_pool.hpp"
+#include "utils/self_usage.hpp"
+#include <chrono>
+
+CollectorPool::~CollectorPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    startCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::size_t CollectorPool::addJob(std::function<void()> job) {
+    jobs_.push_back(std::move(job));
+    latencyMs_.push_back(0.0);
+    cpuMs_.push_back(0.0);
+    return jobs_.size() - 1;
+}
+
+void CollectorPool::start() {
+    started_ = true;
+    for (std::size_t i = 1; i < jobs_.size(); ++i) {
+        workers_.emplace_back(&CollectorPool::workerLoop, this, i);
+    }
+}
+
+void CollectorPool::runTimed(std::size_t job) {
+    uint64_t cpuBegin = threadCpuTimeNs();
+    auto begin = std::chrono::steady_clock::now();
+    jobs_[job]();
+    auto end = std::chrono::steady_clock::now();
+    uint64_t cpuEnd = threadCpuTimeNs();
+    latencyMs_[job] = std::chrono::duration<double, std::milli>(end - begin).count();
+    cpuMs_[job] = static_cast<double>(cpuEnd - cpuBegin) / 1e6;
+}
+
+void CollectorPool::workerLoop(std::size_t job) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            startCv_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) return;
+            seenGeneration = generation_;
+        }
+
+        runTimed(job);
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last = --pending_ == 0;
+        }
+        if (last) doneCv_.notify_one();
+    }
+}
+
+void CollectorPool::runAll() {
+    if (jobs_.empty()) return;
+    if (!started_) start();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = jobs_.size() - 1;
+        ++generation_;
+    }
+    startCv_.notify_all();
+
+    runTimed(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [&] { return pending_ == 0; });
+}
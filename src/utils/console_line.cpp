@@ -0,0 +1,137 @@
+#include "utils/console_line.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <cerrno>
+    #include <unistd.h>
+#endif
+
+void LineBuffer::append(const char* text, std::size_t length) {
+    std::size_t room = kCapacity - size_;
+    if (length > room) length = room;
+    std::memcpy(data_ + size_, text, length);
+    size_ += length;
+}
+
+void LineBuffer::appendUint(uint64_t value) {
+    auto result = std::to_chars(data_ + size_, data_ + kCapacity, value);
+    if (result.ec == std::errc()) size_ = static_cast<std::size_t>(result.ptr - data_);
+}
+
+void LineBuffer::appendFixed1(double value) {
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(data_ + size_, data_ + kCapacity, value, std::chars_format::fixed, 1);
+    if (result.ec == std::errc()) size_ = static_cast<std::size_t>(result.ptr - data_);
+#else
+    // Without floating-point to_chars (older libc++), round to tenths once and
+    // print the integer and decimal parts separately. Exact decimal ties round
+    // away from zero here rather than to even.
+    if (!std::isfinite(value)) {
+        append(std::isnan(value) ? "nan" : (value < 0 ? "-inf" : "inf"));
+        return;
+    }
+    double tenths = std::round(std::fabs(value) * 10.0);
+    if (tenths >= 1e18) {
+        append("inf");
+        return;
+    }
+    uint64_t scaled = static_cast<uint64_t>(tenths);
+    if (std::signbit(value)) append("-");
+    appendUint(scaled / 10);
+    char fraction[2] = {'.', static_cast<char>('0' + scaled % 10)};
+    append(fraction, sizeof(fraction));
+#endif
+}
+
+void formatTickLine(LineBuffer& line, const double* cpu, const MemoryUsage* memory, const GpuUsage* gpu,
+                    const double* npu) {
+    line.clear();
+    // Separator before every part but the first
+    auto separate = [&line] {
+        if (line.size() > 0) line.append(" | ");
+    };
+    if (cpu) {
+        line.append("CPU: ");
+        line.appendFixed1(*cpu);
+        line.append("%");
+    }
+    if (memory) {
+        separate();
+        line.append("Memory: ");
+        line.appendUint(memory->usedPhysicalMB);
+        line.append(" MB (");
+        line.appendFixed1(memory->usedPercentage);
+        line.append("%)");
+    }
+    if (gpu) {
+        separate();
+#ifdef _DEBUG
+        line.append("[DEBUG: ");
+        line.appendUint(gpu->gpus.size());
+        line.append(" GPUs] ");
+#endif
+        // GPU display - individual GPUs if multiple detected
+        if (gpu->gpus.size() > 1) {
+            line.append("GPUs: ");
+            for (std::size_t i = 0; i < gpu->gpus.size(); ++i) {
+                if (i > 0) line.append(", ");
+                line.appendFixed1(gpu->gpus[i].utilizationPercent);
+                line.append("%");
+#ifdef _DEBUG
+                line.append("(");
+                line.append(gpu->gpus[i].name.data(), gpu->gpus[i].name.size());
+                line.append(")");
+#endif
+            }
+            line.append(" (avg: ");
+            line.appendFixed1(gpu->averageUtilization);
+            line.append("%)");
+        } else {
+            line.append("GPU: ");
+            line.appendFixed1(gpu->averageUtilization);
+            line.append("%");
+        }
+    }
+    if (npu) {
+        separate();
+        line.append("NPU: ");
+        line.appendFixed1(*npu);
+        line.append("%");
+    }
+    line.append("\n");
+}
+
+void writeConsoleLine(const LineBuffer& line) {
+    const char* p = line.data();
+    std::size_t left = line.size();
+#ifdef _WIN32
+    _write(1, p, static_cast<unsigned int>(left));
+#else
+    while (left > 0) {
+        ssize_t written = ::write(STDOUT_FILENO, p, left);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += written;
+        left -= static_cast<std::size_t>(written);
+    }
+#endif
+}
+
+DisplayThrottle::DisplayThrottle(double maxPerSecond)
+    : minGap_(maxPerSecond > 0.0
+                  ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / maxPerSecond))
+                  : std::chrono::steady_clock::duration::zero()) {}
+
+bool DisplayThrottle::shouldDisplay(std::chrono::steady_clock::time_point now) {
+    if (shownAny_ && now - lastShown_ < minGap_) return false;
+    lastShown_ = now;
+    shownAny_ = true;
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "utils/gorilla_codec.hpp"
+#include <cstring>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace {
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+// Both require x != 0
+int leadingZeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+int trailingZeros(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+}
+
+void TimestampColumnCodec::encode(BitWriter& out, int64_t timestamp) {
+    int64_t delta = static_cast<int64_t>(static_cast<uint64_t>(timestamp) - static_cast<uint64_t>(prev_));
+    uint64_t dod = zigzag(static_cast<int64_t>(static_cast<uint64_t>(delta) - static_cast<uint64_t>(prevDelta_)));
+    if (dod == 0) {
+        out.writeBit(false);
+    } else if (dod < (uint64_t(1) << 16)) {
+        out.writeBits(0x2, 2);
+        out.writeBits(dod, 16);
+    } else if (dod < (uint64_t(1) << 24)) {
+        out.writeBits(0x6, 3);
+        out.writeBits(dod, 24);
+    } else if (dod < (uint64_t(1) << 32)) {
+        out.writeBits(0xE, 4);
+        out.writeBits(dod, 32);
+    } else {
+        out.writeBits(0xF, 4);
+        out.writeBits(dod, 64);
+    }
+    prevDelta_ = delta;
+    prev_ = timestamp;
+}
+
+void FloatColumnCodec::encode(BitWriter& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (first_) {
+        out.writeBits(bits, 64);
+        prev_ = bits;
+        first_ = false;
+        return;
+    }
+    uint64_t x = bits ^ prev_;
+    prev_ = bits;
+    if (x == 0) {
+        out.writeBit(false);
+        return;
+    }
+    out.writeBit(true);
+    int leading = leadingZeros(x);
+    int trailing = trailingZeros(x);
+    if (leading >= prevLeading_ && trailing >= prevTrailing_) {
+        // Fits the previous meaningful window: reuse it without restating the bounds
+        out.writeBit(false);
+        out.writeBits(x >> prevTrailing_, 64 - prevLeading_ - prevTrailing_);
+    } else {
+        int meaningful = 64 - leading - trailing;
+        out.writeBit(true);
+        out.writeBits(static_cast<uint64_t>(leading), 6);
+        out.writeBits(static_cast<uint64_t>(meaningful - 1), 6);
+        out.writeBits(x >> trailing, meaningful);
+        prevLeading_ = leading;
+        prevTrailing_ = trailing;
+    }
+}
+
+void UintColumnCodec::encode(BitWriter& out, uint64_t value) {
+    uint64_t delta = zigzag(static_cast<int64_t>(value - prev_));
+    prev_ = value;
+    if (delta == 0) {
+        out.writeBit(false);
+        return;
+    }
+    out.writeBit(true);
+    while (delta >= 0x80) {
+        out.writeBits((delta & 0x7F) | 0x80, 8);
+        delta >>= 7;
+    }
+    out.writeBits(delta, 8);
+}
+
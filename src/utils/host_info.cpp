@@ -0,0 +1,68 @@
+#include "utils/host_info.hpp"
+#include <fstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/utsname.h>
+    #include <unistd.h>
+#endif
+#ifdef __APPLE__
+    #include <sys/sysctl.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+std::string readRegistryString(const char* key, const char* value) {
+    char buffer[256] = {};
+    DWORD size = sizeof(buffer);
+    if (RegGetValueA(HKEY_LOCAL_MACHINE, key, value, RRF_RT_REG_SZ, nullptr, buffer, &size) != ERROR_SUCCESS) {
+        return "";
+    }
+    return buffer;
+}
+#endif
+
+#ifdef __linux__
+std::string readCpuModel() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        // x86 reports "model name", most ARM kernels only "Hardware" or "Processor"
+        if (line.compare(0, 10, "model name") == 0 || line.compare(0, 8, "Hardware") == 0 ||
+            line.compare(0, 9, "Processor") == 0) {
+            std::size_t colon = line.find(':');
+            if (colon != std::string::npos && colon + 2 <= line.size()) {
+                return line.substr(colon + 2);
+            }
+        }
+    }
+    return "";
+}
+#endif
+}
+
+HostInfo queryHostInfo() {
+    HostInfo info;
+#ifdef _WIN32
+    char name[MAX_COMPUTERNAME_LENGTH + 1] = {};
+    DWORD nameSize = sizeof(name);
+    if (GetComputerNameA(name, &nameSize)) info.hostName = name;
+    const char* versionKey = "SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion";
+    info.kernel = "Windows " + readRegistryString(versionKey, "CurrentBuild");
+    info.cpuModel = readRegistryString("HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", "ProcessorNameString");
+#else
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) == 0) info.hostName = name;
+    struct utsname uts;
+    if (uname(&uts) == 0) info.kernel = std::string(uts.sysname) + " " + uts.release;
+#ifdef __APPLE__
+    char brand[256] = {};
+    size_t brandSize = sizeof(brand);
+    if (sysctlbyname("machdep.cpu.brand_string", brand, &brandSize, nullptr, 0) == 0) info.cpuModel = brand;
+#elif defined(__linux__)
+    info.cpuModel = readCpuModel();
+#endif
+#endif
+    return info;
+}
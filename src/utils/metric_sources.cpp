@@ -0,0 +1,371 @@
+#include "utils/metric_sources.hpp"
+#include "cpu_monitor.hpp"
+#include "memory_monitor.hpp"
+#include "gpu_monitor.hpp"
+#ifdef _WIN32
+#include "npu_monitor.hpp"
+#endif
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#ifdef __linux__
+#include "utils/process_tree.hpp"
+#include <sys/resource.h>
+#endif
+
+ICpuMonitor* createCpuMonitor();
+IMemoryMonitor* createMemoryMonitor();
+IGpuMonitor* createGpuMonitor();
+
+namespace {
+class CpuSource : public IMetricSource {
+public:
+    CpuSource(const MetricSourceContext&, const MetricDescriptor& descriptor) : descriptor_(descriptor) {}
+    ~CpuSource() override { delete monitor_; }
+
+    const MetricDescriptor& descriptor() const override { return descriptor_; }
+
+    bool open(TickSnapshot& snapshot) override {
+        monitor_ = createCpuMonitor();
+        if (!monitor_) return false;
+        monitor_->getCpuBusy(); // Baseline, so the first tick covers one interval
+        snapshot.coreBusy.assign(monitor_->getCoreCount(), 0.0);
+        return true;
+    }
+
+    void collect(TickSnapshot& snapshot) override {
+        snapshot.cpu = monitor_->getCpuBusy();
+        if (!snapshot.coreBusy.empty()) {
+            monitor_->getPerCoreBusy(snapshot.coreBusy.data(), snapshot.coreBusy.size());
+        }
+    }
+
+private:
+    const MetricDescriptor& descriptor_;
+    ICpuMonitor* monitor_ = nullptr;
+};
+
+class MemorySource : public IMetricSource {
+public:
+    MemorySource(const MetricSourceContext&, const MetricDescriptor& descriptor) : descriptor_(descriptor) {}
+    ~MemorySource() override { delete monitor_; }
+
+    const MetricDescriptor& descriptor() const override { return descriptor_; }
+
+    bool open(TickSnapshot&) override {
+        monitor_ = createMemoryMonitor();
+        return monitor_ != nullptr;
+    }
+
+    void collect(TickSnapshot& snapshot) override { snapshot.mem = monitor_->getMemoryUsage(); }
+
+private:
+    const MetricDescriptor& descriptor_;
+    IMemoryMonitor* monitor_ = nullptr;
+};
+
+class GpuSource : public IMetricSource {
+public:
+    GpuSource(const MetricSourceContext&, const MetricDescriptor& descriptor) : descriptor_(descriptor) {}
+    ~GpuSource() override { delete monitor_; }
+
+    const MetricDescriptor& descriptor() const override { return descriptor_; }
+
+    bool open(TickSnapshot& snapshot) override {
+        monitor_ = createGpuMonitor();
+        if (!monitor_) return false;
+        // Triggers device detection, after which the count is fixed
+        GpuUsage initialGpuCheck = monitor_->getGpuUsage();
+        snapshot.gpuBusy.assign(monitor_->getGpuCount(), 0.0);
+#ifdef _DEBUG
+        std::cout << "[DEBUG] GPU initialization complete. Count: " << snapshot.gpuBusy.size() << std::endl;
+        std::cout << "[DEBUG] Initial GPU check - Average utilization: "
+                  << initialGpuCheck.averageUtilization << "%" << std::endl;
+        for (size_t i = 0; i < initialGpuCheck.gpus.size(); ++i) {
+            std::cout << "[DEBUG] GPU " << i << ": " << initialGpuCheck.gpus[i].name
+                      << " - " << initialGpuCheck.gpus[i].utilizationPercent << "%" << std::endl;
+        }
+#else
+        (void)initialGpuCheck;
+#endif
+        return true;
+    }
+
+    void collect(TickSnapshot& snapshot) override {
+        snapshot.gpu = monitor_->getGpuUsage();
+        // Flattened into the fixed-size row the accumulators and recordings use
+        for (std::size_t i = 0; i < snapshot.gpuBusy.size(); ++i) {
+            snapshot.gpuBusy[i] = i < snapshot.gpu.gpus.size() ? snapshot.gpu.gpus[i].utilizationPercent : 0.0;
+        }
+    }
+
+private:
+    const MetricDescriptor& descriptor_;
+    IGpuMonitor* monitor_ = nullptr;
+};
+
+#ifdef _WIN32
+class NpuSource : public IMetricSource {
+public:
+    NpuSource(const MetricSourceContext&, const MetricDescriptor& descriptor) : descriptor_(descriptor) {}
+    ~NpuSource() override { delete monitor_; }
+
+    const MetricDescriptor& descriptor() const override { return descriptor_; }
+
+    bool open(TickSnapshot& snapshot) override {
+        monitor_ = create_windows_npu_monitor();
+        if (!monitor_ || !monitor_->initialize()) return false;
+        snapshot.npuName = monitor_->get_usage().name;
+        return true;
+    }
+
+    void collect(TickSnapshot& snapshot) override { snapshot.npu = monitor_->get_usage().usage_percent; }
+
+private:
+    const MetricDescriptor& descriptor_;
+    NPUMonitor* monitor_ = nullptr;
+};
+#endif
+
+#ifdef __linux__
+// The application's own share, summed over its whole descendant tree and read
+// through descriptors kept open on each member's /proc entries
+class ProcessSource : public IMetricSource {
+public:
+    ProcessSource(const MetricSourceContext& context, const MetricDescriptor& descriptor)
+        : descriptor_(descriptor), args_(context.args), child_(context.child), watcher_(context.watcher) {}
+    ~ProcessSource() override { delete monitor_; }
+
+    const MetricDescriptor& descriptor() const override { return descriptor_; }
+
+    bool open(TickSnapshot& snapshot) override {
+        if (!child_.isRunning() && args_.appName.empty()) return false;
+        monitor_ = createLinuxProcessMonitor("/proc");
+        if (child_.isRunning()) {
+            roots_ = {child_.pid()};
+            snapshot.processName = args_.command[0];
+        } else {
+            watcher_.isRunning();
+            roots_ = watcher_.pids();
+            snapshot.processName = args_.appName;
+        }
+        rootGeneration_ = watcher_.generation();
+        tree_.refresh(roots_);
+        monitor_->track(tree_.members());
+        return true;
+    }
+
+    // The watcher only changes between ticks, so reading it here is safe
+    void collect(TickSnapshot& snapshot) override {
+        snapshot.process = monitor_->getProcessUsage();
+        if (!child_.isRunning() && watcher_.generation() != rootGeneration_) {
+            // A matching process exited and /proc was rescanned
+            rootGeneration_ = watcher_.generation();
+            roots_ = watcher_.pids();
+        }
+        // New descendants are counted from the next tick
+        if (tree_.refresh(roots_)) monitor_->track(tree_.members());
+    }
+
+private:
+    const MetricDescriptor& descriptor_;
+    const MonitorArgs& args_;
+    const ChildProcess& child_;
+    AppWatcher& watcher_;
+    IProcessMonitor* monitor_ = nullptr;
+    ProcessTree tree_;
+    std::vector<int> roots_;
+    uint64_t rootGeneration_ = 0;
+};
+
+// Host-wide ranking for --top
+class TopSource : public IMetricSource {
+public:
+    static constexpr std::size_t kDefaultRows = 5; // When named with --metrics but --top is not given
+
+    TopSource(const MetricSourceContext& context, const MetricDescriptor& descriptor)
+        : descriptor_(descriptor),
+          rows_(context.args.top > 0 ? static_cast<std::size_t>(context.args.top) : kDefaultRows) {}
+    ~TopSource() override { delete table_; }
+
+    const MetricDescriptor& descriptor() const override { return descriptor_; }
+
+    bool open(TickSnapshot& snapshot) override {
+        raiseOpenFileLimit();
+        table_ = new ProcessTable("/proc");
+        if (!table_->refresh()) return false; // Baseline, so the first tick already has CPU%
+        snapshot.topByCpu.reserve(rows_);
+        snapshot.topByRss.reserve(rows_);
+        return true;
+    }
+
+    void collect(TickSnapshot& snapshot) override {
+        table_->refresh();
+        table_->topByCpu(rows_, snapshot.topByCpu);
+        table_->topByRss(rows_, snapshot.topByRss);
+    }
+
+private:
+    // The table keeps a descriptor open per process; lift the soft limit to the hard one
+    static void raiseOpenFileLimit() {
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+    const MetricDescriptor& descriptor_;
+    std::size_t rows_;
+    ProcessTable* table_ = nullptr;
+};
+
+bool hasProcessTarget(const MetricSourceContext& context) {
+    return !context.args.appName.empty() || context.child.isRunning();
+}
+
+bool wantsTop(const MetricSourceContext& context) {
+    return context.args.top > 0;
+}
+#endif
+
+template <typename Source>
+IMetricSource* makeSource(const MetricSourceContext& context, const MetricDescriptor& descriptor) {
+    return new Source(context, descriptor);
+}
+
+struct RegistryEntry {
+    MetricDescriptor descriptor;
+    bool selectedByDefault;                        // Part of the run when --metrics is not given
+    bool (*implied)(const MetricSourceContext&);   // Added by other options regardless of --metrics
+    IMetricSource* (*create)(const MetricSourceContext&, const MetricDescriptor&);
+};
+
+#ifdef _WIN32
+constexpr CostClass kCpuCost = CostClass::Expensive; // PDH query
+constexpr CostClass kGpuCost = CostClass::Expensive; // WMI and DXGI
+#elif defined(__APPLE__)
+constexpr CostClass kCpuCost = CostClass::Cheap;
+constexpr CostClass kGpuCost = CostClass::Moderate;  // IOKit registry walk
+#else
+constexpr CostClass kCpuCost = CostClass::Cheap;
+constexpr CostClass kGpuCost = CostClass::Moderate;  // sysfs per card, fdinfo for cards without a busy counter
+#endif
+
+const RegistryEntry kRegistry[] = {
+    {{"cpu", "%", MetricType::Gauge, kCpuCost, MetricSlot::Cpu, "Total and per-core busy time"},
+     true, nullptr, &makeSource<CpuSource>},
+    {{"mem", "MB", MetricType::Gauge, CostClass::Cheap, MetricSlot::Memory, "Physical memory in use"},
+     true, nullptr, &makeSource<MemorySource>},
+    {{"gpu", "%", MetricType::Gauge, kGpuCost, MetricSlot::Gpu, "Utilization of every GPU"},
+     true, nullptr, &makeSource<GpuSource>},
+#ifdef _WIN32
+    {{"npu", "%", MetricType::Gauge, CostClass::Expensive, MetricSlot::Npu, "NPU utilization"},
+     true, nullptr, &makeSource<NpuSource>},
+#endif
+#ifdef __linux__
+    {{"process", "%, KB", MetricType::Counter, CostClass::Moderate, MetricSlot::Process,
+      "CPU, RSS/PSS, faults and I/O of the application's process tree"},
+     false, &hasProcessTarget, &makeSource<ProcessSource>},
+    {{"top", "processes", MetricType::Table, CostClass::Expensive, MetricSlot::Top,
+      "Heaviest processes on the host by CPU and by RSS"},
+     false, &wantsTop, &makeSource<TopSource>},
+#endif
+};
+
+constexpr std::size_t kRegistrySize = sizeof(kRegistry) / sizeof(kRegistry[0]);
+}
+
+const char* metricTypeName(MetricType type) {
+    switch (type) {
+    case MetricType::Gauge: return "gauge";
+    case MetricType::Counter: return "counter";
+    case MetricType::Table: return "table";
+    }
+    return "";
+}
+
+const char* costClassName(CostClass cost) {
+    switch (cost) {
+    case CostClass::Cheap: return "cheap";
+    case CostClass::Moderate: return "moderate";
+    case CostClass::Expensive: return "expensive";
+    }
+    return "";
+}
+
+std::size_t metricSourceCount() {
+    return kRegistrySize;
+}
+
+const MetricDescriptor& metricDescriptor(std::size_t index) {
+    return kRegistry[index].descriptor;
+}
+
+const MetricDescriptor* findMetricDescriptor(const std::string& name) {
+    for (const auto& entry : kRegistry) {
+        if (name == entry.descriptor.name) return &entry.descriptor;
+    }
+    return nullptr;
+}
+
+std::string metricSourceNames() {
+    std::string names;
+    for (const auto& entry : kRegistry) {
+        if (!names.empty()) names += ", ";
+        names += entry.descriptor.name;
+    }
+    return names;
+}
+
+void printMetricSources() {
+    std::cout << std::left << std::setw(10) << "SOURCE" << std::setw(12) << "UNIT" << std::setw(10) << "TYPE"
+              << std::setw(11) << "COST" << "DESCRIPTION\n";
+    for (const auto& entry : kRegistry) {
+        const MetricDescriptor& d = entry.descriptor;
+        std::cout << std::setw(10) << d.name << std::setw(12) << d.unit << std::setw(10) << metricTypeName(d.type)
+                  << std::setw(11) << costClassName(d.cost) << d.description << "\n";
+    }
+    std::cout << std::right << std::flush;
+}
+
+CollectorLatency collectorLatencyFromSlots(const double* bySlot) {
+    CollectorLatency latency;
+    latency.cpuMs = bySlot[static_cast<std::size_t>(MetricSlot::Cpu)];
+    latency.memoryMs = bySlot[static_cast<std::size_t>(MetricSlot::Memory)];
+    latency.gpuMs = bySlot[static_cast<std::size_t>(MetricSlot::Gpu)];
+    latency.npuMs = bySlot[static_cast<std::size_t>(MetricSlot::Npu)];
+    return latency;
+}
+
+MetricSourceSet::~MetricSourceSet() {
+    for (IMetricSource* source : sources_) {
+        delete source;
+    }
+}
+
+bool MetricSourceSet::open(const MetricSourceContext& context, TickSnapshot& snapshot) {
+    const std::vector<std::string>& names = context.args.metrics;
+    for (const auto& name : names) {
+        if (!findMetricDescriptor(name)) {
+            error_ = "Unknown metric source " + name + " (available: " + metricSourceNames() + ")";
+            return false;
+        }
+    }
+    for (const auto& entry : kRegistry) {
+        bool named = std::find(names.begin(), names.end(), entry.descriptor.name) != names.end();
+        bool wanted = named || (names.empty() && entry.selectedByDefault) ||
+                      (entry.implied && entry.implied(context));
+        if (!wanted) continue;
+        IMetricSource* source = entry.create(context, entry.descriptor);
+        if (!source->open(snapshot)) {
+            // Only worth a notice when asked for by name; an NPU-less host is not an error
+            if (named) std::cerr << "Metric source " << entry.descriptor.name << " is not available" << std::endl;
+            delete source;
+            continue;
+        }
+        snapshot.setPresent(entry.descriptor.slot);
+        sources_.push_back(source);
+    }
+    return true;
+}
@@ -0,0 +1,509 @@
+#include "utils/metrics_server.hpp"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+#ifdef __linux__
+    #include <sys/epoll.h>
+#endif
+
+namespace {
+void appendValue(SummaryBuffer& out, double value) {
+    // OpenMetrics spells the special values NaN, +Inf and -Inf
+    if (std::isnan(value)) {
+        out.append("NaN");
+    } else if (std::isinf(value)) {
+        out.append(value > 0 ? "+Inf" : "-Inf");
+    } else {
+        out.appendDouble(value);
+    }
+}
+
+void appendFamily(SummaryBuffer& out, const char* name, const char* type, const char* unit, const char* help) {
+    out.append("# TYPE ");
+    out.append(name, std::strlen(name));
+    out.append(" ");
+    out.append(type, std::strlen(type));
+    if (unit) {
+        out.append("\n# UNIT ");
+        out.append(name, std::strlen(name));
+        out.append(" ");
+        out.append(unit, std::strlen(unit));
+    }
+    out.append("\n# HELP ");
+    out.append(name, std::strlen(name));
+    out.append(" ");
+    out.append(help, std::strlen(help));
+    out.append("\n");
+}
+
+void appendSample(SummaryBuffer& out, const char* name, double value) {
+    out.append(name, std::strlen(name));
+    out.append(" ");
+    appendValue(out, value);
+    out.append("\n");
+}
+
+void appendIndexedSample(SummaryBuffer& out, const char* name, const char* label, std::size_t index, double value) {
+    out.append(name, std::strlen(name));
+    out.append("{");
+    out.append(label, std::strlen(label));
+    out.append("=\"");
+    out.appendUint(index);
+    out.append("\"} ");
+    appendValue(out, value);
+    out.append("\n");
+}
+
+void appendLabeledSample(SummaryBuffer& out, const char* name, const char* label, const char* labelValue, double value) {
+    out.append(name, std::strlen(name));
+    out.append("{");
+    out.append(label, std::strlen(label));
+    out.append("=\"");
+    out.append(labelValue, std::strlen(labelValue));
+    out.append("\"} ");
+    appendValue(out, value);
+    out.append("\n");
+}
+
+void appendCounter(SummaryBuffer& out, const char* name, const char* help, uint64_t value) {
+    appendFamily(out, name, "counter", nullptr, help);
+    out.append(name, std::strlen(name));
+    out.append("_total ");
+    out.appendUint(value);
+    out.append("\n");
+}
+
+constexpr double kBytesPerMB = 1024.0 * 1024.0;
+}
+
+void renderOpenMetrics(const MetricsSnapshot& snapshot, SummaryBuffer& out) {
+    out.clear();
+    if (snapshot.cpuAvailable) {
+        appendFamily(out, "crossmon_cpu_utilization_percent", "gauge", "percent", "Whole-system CPU busy time.");
+        appendSample(out, "crossmon_cpu_utilization_percent", snapshot.cpuPercent);
+    }
+    if (snapshot.cpuAvailable && !snapshot.corePercent.empty()) {
+        appendFamily(out, "crossmon_cpu_core_utilization_percent", "gauge", "percent", "Busy time of each logical core.");
+        for (std::size_t i = 0; i < snapshot.corePercent.size(); ++i) {
+            appendIndexedSample(out, "crossmon_cpu_core_utilization_percent", "core", i, snapshot.corePercent[i]);
+        }
+    }
+
+    if (snapshot.memoryAvailable) {
+        appendFamily(out, "crossmon_memory_used_bytes", "gauge", "bytes", "Physical memory in use.");
+        appendSample(out, "crossmon_memory_used_bytes", static_cast<double>(snapshot.memoryUsedMB) * kBytesPerMB);
+        appendFamily(out, "crossmon_memory_total_bytes", "gauge", "bytes", "Installed physical memory.");
+        appendSample(out, "crossmon_memory_total_bytes", static_cast<double>(snapshot.memoryTotalMB) * kBytesPerMB);
+        appendFamily(out, "crossmon_memory_used_percent", "gauge", "percent", "Physical memory in use as a share of the total.");
+        appendSample(out, "crossmon_memory_used_percent", snapshot.memoryUsedPercent);
+    }
+
+    if (snapshot.gpuAvailable) {
+        appendFamily(out, "crossmon_gpu_utilization_percent", "gauge", "percent", "GPU utilization averaged across GPUs.");
+        appendSample(out, "crossmon_gpu_utilization_percent", snapshot.gpuPercent);
+    }
+    if (snapshot.gpuAvailable && !snapshot.gpuPercentPerDevice.empty()) {
+        appendFamily(out, "crossmon_gpu_device_utilization_percent", "gauge", "percent", "Utilization of each GPU.");
+        for (std::size_t i = 0; i < snapshot.gpuPercentPerDevice.size(); ++i) {
+            appendIndexedSample(out, "crossmon_gpu_device_utilization_percent", "gpu", i, snapshot.gpuPercentPerDevice[i]);
+        }
+    }
+    if (snapshot.npuAvailable) {
+        appendFamily(out, "crossmon_npu_utilization_percent", "gauge", "percent", "NPU utilization.");
+        appendSample(out, "crossmon_npu_utilization_percent", snapshot.npuPercent);
+    }
+
+    if (snapshot.cpuAvailable || snapshot.memoryAvailable || snapshot.gpuAvailable || snapshot.npuAvailable) {
+        appendFamily(out, "crossmon_collector_latency_seconds", "gauge", "seconds", "Time the last sample spent in each collector.");
+    }
+    if (snapshot.cpuAvailable) {
+        appendLabeledSample(out, "crossmon_collector_latency_seconds", "collector", "cpu", snapshot.latency.cpuMs / 1000.0);
+    }
+    if (snapshot.memoryAvailable) {
+        appendLabeledSample(out, "crossmon_collector_latency_seconds", "collector", "memory", snapshot.latency.memoryMs / 1000.0);
+    }
+    if (snapshot.gpuAvailable) {
+        appendLabeledSample(out, "crossmon_collector_latency_seconds", "collector", "gpu", snapshot.latency.gpuMs / 1000.0);
+    }
+    if (snapshot.npuAvailable) {
+        appendLabeledSample(out, "crossmon_collector_latency_seconds", "collector", "npu", snapshot.latency.npuMs / 1000.0);
+    }
+
+    appendCounter(out, "crossmon_samples", "Samples collected since start.", snapshot.samples);
+    appendCounter(out, "crossmon_overruns", "Ticks that started after their deadline.", snapshot.overruns);
+    appendCounter(out, "crossmon_skipped_ticks", "Deadlines dropped to stay on the interval grid.", snapshot.skippedTicks);
+    appendFamily(out, "crossmon_last_sample_timestamp_seconds", "gauge", "seconds", "Wall-clock time of the latest sample.");
+    appendSample(out, "crossmon_last_sample_timestamp_seconds", static_cast<double>(snapshot.timestampMs) / 1000.0);
+    out.append("# EOF\n");
+}
+
+MetricsServer::MetricsServer() = default;
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::publish(const MetricsSnapshot& snapshot) {
+    std::unique_lock<std::mutex> lock(snapshotMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    // Vector sizes never change between ticks, so these assignments reuse storage
+    latest_ = snapshot;
+}
+
+#ifdef _WIN32
+bool MetricsServer::start(const std::string&) {
+    error_ = "--serve is not supported on Windows";
+    return false;
+}
+
+void MetricsServer::stop() {}
+#else
+namespace {
+constexpr uint64_t kListenTag = 0;
+constexpr uint64_t kWakeTag = 1;
+constexpr uint64_t kFirstConnectionTag = 2;
+
+#ifdef __linux__
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0; // SO_NOSIGPIPE is set on each socket instead
+#endif
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+// Case-insensitive search within a request header block
+bool containsNoCase(const char* text, std::size_t length, const char* needle) {
+    std::size_t n = std::strlen(needle);
+    for (std::size_t i = 0; i + n <= length; ++i) {
+        std::size_t j = 0;
+        while (j < n && std::tolower(static_cast<unsigned char>(text[i + j])) == needle[j]) ++j;
+        if (j == n) return true;
+    }
+    return false;
+}
+}
+
+bool MetricsServer::start(const std::string& address) {
+    if (running_) return false;
+    std::size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon + 1 == address.size()) {
+        error_ = "expected HOST:PORT, got '" + address + "'";
+        return false;
+    }
+    std::string host = address.substr(0, colon);
+    std::string service = address.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    int rc = getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result);
+    if (rc != 0) {
+        error_ = std::string("cannot resolve ") + address + ": " + gai_strerror(rc);
+        return false;
+    }
+    for (addrinfo* ai = result; ai && listenFd_ < 0; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, 64) == 0 && setNonBlocking(fd)) {
+            listenFd_ = fd;
+        } else {
+            error_ = std::string("cannot listen on ") + address + ": " + std::strerror(errno);
+            ::close(fd);
+        }
+    }
+    freeaddrinfo(result);
+    if (listenFd_ < 0) return false;
+
+    sockaddr_storage bound = {};
+    socklen_t boundLength = sizeof(bound);
+    getsockname(listenFd_, reinterpret_cast<sockaddr*>(&bound), &boundLength);
+    port_ = bound.ss_family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port)
+                                        : ntohs(reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+
+    if (pipe(wakeFds_) != 0 || !setNonBlocking(wakeFds_[0]) || !setNonBlocking(wakeFds_[1])) {
+        error_ = std::string("cannot create wake pipe: ") + std::strerror(errno);
+        stop();
+        return false;
+    }
+#ifdef __linux__
+    pollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (pollFd_ < 0) {
+        error_ = std::string("epoll_create1 failed: ") + std::strerror(errno);
+        stop();
+        return false;
+    }
+#endif
+    watch(listenFd_, kListenTag, false, true);
+    watch(wakeFds_[0], kWakeTag, false, true);
+
+    error_.clear();
+    stopping_ = false;
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serveLoop, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (running_) {
+        stopping_ = true;
+        char byte = 0;
+        (void)!::write(wakeFds_[1], &byte, 1);
+        thread_.join();
+        running_ = false;
+    }
+    for (Connection& conn : connections_) closeConnection(conn);
+    for (int* fd : {&listenFd_, &wakeFds_[0], &wakeFds_[1], &pollFd_}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+}
+
+void MetricsServer::watch(int fd, uint64_t tag, bool writable, bool add) {
+#ifdef __linux__
+    epoll_event event = {};
+    event.events = writable ? EPOLLOUT : EPOLLIN;
+    event.data.u64 = tag;
+    epoll_ctl(pollFd_, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+#else
+    (void)fd;
+    (void)tag;
+    (void)writable;
+    (void)add;
+#endif
+}
+
+void MetricsServer::serveLoop() {
+    while (!stopping_) {
+        uint64_t ready[kMaxConnections + 2];
+        int count = 0;
+#ifdef __linux__
+        epoll_event events[kMaxConnections + 2];
+        int n = epoll_wait(pollFd_, events, static_cast<int>(kMaxConnections + 2), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < n; ++i) ready[count++] = events[i].data.u64;
+#else
+        pollfd fds[kMaxConnections + 2];
+        uint64_t tags[kMaxConnections + 2];
+        nfds_t watched = 0;
+        fds[watched] = {listenFd_, POLLIN, 0};
+        tags[watched++] = kListenTag;
+        fds[watched] = {wakeFds_[0], POLLIN, 0};
+        tags[watched++] = kWakeTag;
+        for (std::size_t i = 0; i < kMaxConnections; ++i) {
+            if (connections_[i].fd < 0) continue;
+            fds[watched] = {connections_[i].fd, static_cast<short>(connections_[i].writing ? POLLOUT : POLLIN), 0};
+            tags[watched++] = kFirstConnectionTag + i;
+        }
+        int n = poll(fds, watched, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (nfds_t i = 0; i < watched; ++i) {
+            if (fds[i].revents) ready[count++] = tags[i];
+        }
+#endif
+        for (int i = 0; i < count; ++i) {
+            if (ready[i] == kListenTag) {
+                acceptConnections();
+            } else if (ready[i] == kWakeTag) {
+                char drain[16];
+                while (::read(wakeFds_[0], drain, sizeof(drain)) > 0) {}
+            } else {
+                Connection& conn = connections_[ready[i] - kFirstConnectionTag];
+                if (conn.fd < 0) continue;
+                if (conn.writing) {
+                    onWritable(conn);
+                } else {
+                    onReadable(conn);
+                }
+            }
+        }
+    }
+}
+
+void MetricsServer::acceptConnections() {
+    for (;;) {
+#ifdef __linux__
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd >= 0) {
+            setNonBlocking(fd);
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+        }
+#endif
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN once the backlog is drained
+        }
+        Connection* slot = nullptr;
+        for (std::size_t i = 0; i < kMaxConnections && !slot; ++i) {
+            if (connections_[i].fd < 0) slot = &connections_[i];
+        }
+        if (!slot) {
+            ::close(fd); // Full; a scraper simply retries on its next interval
+            continue;
+        }
+        slot->fd = fd;
+        slot->requestSize = 0;
+        slot->writing = false;
+        slot->writeWatched = false;
+        watch(fd, kFirstConnectionTag + static_cast<uint64_t>(slot - connections_), false, true);
+    }
+}
+
+void MetricsServer::onReadable(Connection& conn) {
+    for (;;) {
+        if (conn.requestSize == kRequestBytes) {
+            closeConnection(conn); // Headers larger than any scraper sends
+            return;
+        }
+        ssize_t n = ::read(conn.fd, conn.request + conn.requestSize, kRequestBytes - conn.requestSize);
+        if (n == 0) {
+            closeConnection(conn);
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) closeConnection(conn);
+            break;
+        }
+        conn.requestSize += static_cast<std::size_t>(n);
+    }
+    handleRequest(conn);
+}
+
+void MetricsServer::handleRequest(Connection& conn) {
+    for (std::size_t i = 0; i + 4 <= conn.requestSize; ++i) {
+        if (std::memcmp(conn.request + i, "\r\n\r\n", 4) == 0) {
+            respond(conn, i + 4);
+            return;
+        }
+    }
+}
+
+void MetricsServer::respond(Connection& conn, std::size_t length) {
+    const char* request = conn.request;
+    const char* lineEnd = static_cast<const char*>(std::memchr(request, '\r', length));
+    std::size_t lineLength = static_cast<std::size_t>(lineEnd - request);
+    const char* pathBegin = static_cast<const char*>(std::memchr(request, ' ', lineLength));
+    const char* pathEnd = pathBegin ? static_cast<const char*>(std::memchr(pathBegin + 1, ' ', lineEnd - pathBegin - 1))
+                                    : nullptr;
+
+    const char* status = "200 OK";
+    const char* contentType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+    conn.body.clear();
+    if (!pathBegin || !pathEnd) {
+        status = "400 Bad Request";
+    } else if (pathBegin - request != 3 || std::memcmp(request, "GET", 3) != 0) {
+        status = "405 Method Not Allowed";
+    } else {
+        ++pathBegin;
+        const char* query = static_cast<const char*>(std::memchr(pathBegin, '?', pathEnd - pathBegin));
+        std::size_t pathLength = static_cast<std::size_t>((query ? query : pathEnd) - pathBegin);
+        if (pathLength == 8 && std::memcmp(pathBegin, "/metrics", 8) == 0) {
+            {
+                std::lock_guard<std::mutex> lock(snapshotMutex_);
+                scratch_ = latest_;
+            }
+            renderOpenMetrics(scratch_, conn.body);
+            scrapes_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            status = "404 Not Found";
+        }
+    }
+    if (status[0] != '2') {
+        contentType = "text/plain; charset=utf-8";
+        conn.body.append(status, std::strlen(status));
+        conn.body.append("\n");
+    }
+
+    bool http10 = pathEnd && lineEnd - pathEnd >= 9 && std::memcmp(pathEnd + 1, "HTTP/1.0", 8) == 0;
+    conn.closeAfterSend = status[0] == '4' || http10 || containsNoCase(request, length, "\nconnection: close");
+    int headSize = std::snprintf(conn.head, sizeof(conn.head),
+                                 "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s\r\n", status,
+                                 contentType, conn.body.size(), conn.closeAfterSend ? "Connection: close\r\n" : "");
+    conn.headSize = static_cast<std::size_t>(headSize);
+    conn.sent = 0;
+    conn.writing = true;
+
+    // Pipelined bytes after this request are kept for the next one
+    conn.requestSize -= length;
+    std::memmove(conn.request, conn.request + length, conn.requestSize);
+
+    onWritable(conn);
+    if (conn.fd >= 0 && conn.writing) {
+        watch(conn.fd, kFirstConnectionTag + static_cast<uint64_t>(&conn - connections_), true, false);
+        conn.writeWatched = true;
+    }
+}
+
+void MetricsServer::onWritable(Connection& conn) {
+    std::size_t total = conn.headSize + conn.body.size();
+    while (conn.sent < total) {
+        iovec parts[2];
+        int count = 0;
+        if (conn.sent < conn.headSize) {
+            parts[count++] = {conn.head + conn.sent, conn.headSize - conn.sent};
+            parts[count++] = {const_cast<char*>(conn.body.data()), conn.body.size()};
+        } else {
+            std::size_t offset = conn.sent - conn.headSize;
+            parts[count++] = {const_cast<char*>(conn.body.data()) + offset, conn.body.size() - offset};
+        }
+        msghdr message = {};
+        message.msg_iov = parts;
+        message.msg_iovlen = count;
+        ssize_t n = sendmsg(conn.fd, &message, kSendFlags);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) closeConnection(conn);
+            return;
+        }
+        conn.sent += static_cast<std::size_t>(n);
+    }
+    conn.writing = false;
+    if (conn.closeAfterSend) {
+        closeConnection(conn);
+        return;
+    }
+    if (conn.writeWatched) {
+        watch(conn.fd, kFirstConnectionTag + static_cast<uint64_t>(&conn - connections_), false, false);
+        conn.writeWatched = false;
+    }
+    if (conn.requestSize > 0) handleRequest(conn);
+}
+
+void MetricsServer::closeConnection(Connection& conn) {
+    if (conn.fd < 0) return;
+    ::close(conn.fd); // Also removes it from the epoll set
+    conn.fd = -1;
+    conn.requestSize = 0;
+    conn.writing = false;
+    conn.writeWatched = false;
+}
+#endif
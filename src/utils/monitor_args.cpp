@@ -1,5 +1,6 @@
 #include "utils/monitor_args.hpp"
 #include <iostream>
+#include <cmath>
 #include <cstring>
 #include <cstdlib>
 
@@ -7,6 +8,16 @@ MonitorArgs parseMonitorArgs(int argc, char* argv[]) {
     MonitorArgs args;
     int argi = 1;
     
+    if (argc > 1 && strcmp(argv[1], "replay") == 0) {
+        if (argc < 3) {
+            args.hasError = true;
+            args.errorMessage = "Error: replay requires a recording file";
+            return args;
+        }
+        args.replayPath = argv[2];
+        argi = 3;
+    }
+    
     while (argi < argc) {
         if (strcmp(argv[argi], "-i") == 0 || strcmp(argv[argi], "--interval") == 0) {
             if (argi + 1 < argc) {
@@ -26,6 +37,40 @@ MonitorArgs parseMonitorArgs(int argc, char* argv[]) {
                 args.errorMessage = "Error: -o/--output requires a file path";
                 return args;
             }
+        } else if (strcmp(argv[argi], "--format") == 0) {
+            if (argi + 1 < argc) {
+                const char* format = argv[argi + 1];
+                if (strcmp(format, "text") != 0 && strcmp(format, "json") != 0 &&
+                    strcmp(format, "csv") != 0 && strcmp(format, "kv") != 0) {
+                    args.hasError = true;
+                    args.errorMessage = std::string("Error: Unknown output format ") + format + " (use text, json, csv or kv)";
+                    return args;
+                }
+                args.outputFormat = format;
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --format requires a value (text, json, csv or kv)";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--serve") == 0) {
+            if (argi + 1 < argc) {
+                args.serveAddress = argv[argi + 1];
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --serve requires an address (e.g. 127.0.0.1:9464)";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--record") == 0) {
+            if (argi + 1 < argc) {
+                args.recordPath = argv[argi + 1];
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --record requires a file path";
+                return args;
+            }
         } else if (strcmp(argv[argi], "-s") == 0 || strcmp(argv[argi], "--samples") == 0) {
             // Skip samples argument for now (not implemented in current version)
             if (argi + 1 < argc) {
@@ -35,6 +80,132 @@ MonitorArgs parseMonitorArgs(int argc, char* argv[]) {
                 args.errorMessage = "Error: -s/--samples requires a value";
                 return args;
             }
+        } else if (strcmp(argv[argi], "--keep-history") == 0) {
+            args.keepHistory = true;
+            argi++;
+        } else if (strcmp(argv[argi], "--compress") == 0 || strcmp(argv[argi], "--compress=lossless") == 0) {
+            args.compressRecording = true;
+            argi++;
+        } else if (strcmp(argv[argi], "--compress=lossy") == 0) {
+            args.compressRecording = true;
+            args.lossyRecording = true;
+            argi++;
+        } else if (strcmp(argv[argi], "--realtime") == 0) {
+            args.realtime = true;
+            argi++;
+        } else if (strcmp(argv[argi], "--history-minutes") == 0) {
+            if (argi + 1 < argc) {
+                args.historyMinutes = std::stoi(argv[argi + 1]);
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --history-minutes requires a value";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--display-rate") == 0) {
+            if (argi + 1 < argc) {
+                args.displayRate = std::stod(argv[argi + 1]);
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --display-rate requires a value (lines per second)";
+                return args;
+            }
+            // 0 is the default (every sample); negative, NaN and infinite rates mean nothing
+            if (!std::isfinite(args.displayRate) || args.displayRate < 0.0) {
+                args.hasError = true;
+                args.errorMessage = "Error: --display-rate requires a non-negative number of lines per second";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--top") == 0) {
+            if (argi + 1 < argc) {
+                args.top = std::stoi(argv[argi + 1]);
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --top requires a number of processes";
+                return args;
+            }
+            if (args.top <= 0) {
+                args.hasError = true;
+                args.errorMessage = "Error: --top requires a positive number of processes";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--metrics") == 0) {
+            if (argi + 1 >= argc) {
+                args.hasError = true;
+                args.errorMessage = "Error: --metrics requires a comma-separated list of sources (or list)";
+                return args;
+            }
+            std::string list = argv[argi + 1];
+            argi += 2;
+            if (list == "list") {
+                args.listMetrics = true;
+                continue;
+            }
+            // Names are checked against the source registry when monitoring starts
+            std::size_t start = 0;
+            while (true) {
+                std::size_t comma = list.find(',', start);
+                std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+                if (name.empty()) {
+                    args.hasError = true;
+                    args.errorMessage = "Error: --metrics has an empty source name in " + list;
+                    return args;
+                }
+                args.metrics.push_back(name);
+                if (comma == std::string::npos) break;
+                start = comma + 1;
+            }
+        } else if (strcmp(argv[argi], "--overhead-budget") == 0) {
+            if (argi + 1 < argc) {
+                args.overheadBudget = std::stod(argv[argi + 1]);
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --overhead-budget requires a value (percent of one core)";
+                return args;
+            }
+            if (args.overheadBudget <= 0.0) {
+                args.hasError = true;
+                args.errorMessage = "Error: --overhead-budget requires a positive percentage";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--adaptive") == 0) {
+            if (argi + 1 < argc) {
+                args.adaptiveMaxInterval = std::stoi(argv[argi + 1]);
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --adaptive requires a maximum interval (milliseconds)";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--adaptive-step") == 0) {
+            if (argi + 1 < argc) {
+                args.adaptiveStep = std::stod(argv[argi + 1]);
+                argi += 2;
+            } else {
+                args.hasError = true;
+                args.errorMessage = "Error: --adaptive-step requires a value (percentage points)";
+                return args;
+            }
+            if (args.adaptiveStep <= 0.0) {
+                args.hasError = true;
+                args.errorMessage = "Error: --adaptive-step requires a positive number of percentage points";
+                return args;
+            }
+        } else if (strcmp(argv[argi], "--catch-up") == 0) {
+            args.catchUp = true;
+            argi++;
+        } else if (strcmp(argv[argi], "--") == 0) {
+            // Everything after -- is the command to run, including its own options
+            if (argi + 1 >= argc) {
+                args.hasError = true;
+                args.errorMessage = "Error: -- must be followed by a command to run";
+                return args;
+            }
+            args.command.assign(argv + argi + 1, argv + argc);
+            break;
         } else if (strcmp(argv[argi], "-h") == 0 || strcmp(argv[argi], "--help") == 0) {
             args.showHelp = true;
             return args;
@@ -49,25 +220,71 @@ MonitorArgs parseMonitorArgs(int argc, char* argv[]) {
             break;
         }
     }
+
+    // Checked after the loop so --adaptive and -i may come in either order
+    if (args.adaptiveMaxInterval != 0 && args.adaptiveMaxInterval <= args.interval) {
+        args.hasError = true;
+        args.errorMessage = "Error: --adaptive requires a maximum interval longer than -i (" +
+                            std::to_string(args.interval) + " ms)";
+        return args;
+    }
     
     return args;
 }
 
 void printHelp(const char* programName) {
     std::cout << "CrossMon - Cross-platform System Resource Monitor\n\n";
-    std::cout << "Usage: " << programName << " [OPTIONS] [APPLICATION_NAME]\n\n";
+    std::cout << "Usage: " << programName << " [OPTIONS] [APPLICATION_NAME]\n";
+    std::cout << "       " << programName << " [OPTIONS] -- COMMAND [ARGS...]\n";
+    std::cout << "       " << programName << " replay FILE [OPTIONS]\n\n";
     std::cout << "Options:\n";
     std::cout << "  -h, --help                Show this help message\n";
     std::cout << "  -i, --interval MSEC       Monitoring interval in milliseconds (default: 1000)\n";
-    std::cout << "  -o, --output FILE         Output statistics to file\n\n";
+    std::cout << "  -o, --output FILE         Output statistics to file\n";
+    std::cout << "  --format FORMAT           Output file format: text, json, csv or kv (default: text)\n";
+    std::cout << "  --display-rate N          Print at most N status lines per second while sampling\n";
+    std::cout << "                           continues at the full interval (default: every sample)\n";
+    std::cout << "  --serve HOST:PORT         Answer OpenMetrics scrapes on http://HOST:PORT/metrics\n";
+    std::cout << "                           while sampling (not available on Windows)\n";
+    std::cout << "  --record FILE             Append every sample to a binary recording\n";
+    std::cout << "  --compress[=lossy]        Store the recording in compressed blocks; values are kept\n";
+    std::cout << "                           exactly unless =lossy rounds percentages to 1/128 pp and\n";
+    std::cout << "                           latencies to 1/1024 ms first (about 10x smaller)\n";
+    std::cout << "  --realtime                Replay at the recorded pace (default: as fast as possible)\n";
+    std::cout << "  --history-minutes N       Minutes of full-resolution history to retain (default: 10);\n";
+    std::cout << "                           older samples survive as 10 s / 1 min / 1 h rollups\n";
+    std::cout << "  --keep-history            Also keep every raw per-core and latency sample (unbounded)\n";
+    std::cout << "  --top N                   Also print the N heaviest processes by CPU and by RSS\n";
+    std::cout << "                           with each status line (Linux only)\n";
+    std::cout << "  --metrics LIST            Collect only these sources, comma-separated (e.g. cpu,mem);\n";
+    std::cout << "                           \"--metrics list\" shows every source with its unit and cost\n";
+    std::cout << "  --overhead-budget PCT     Warn when a tick costs crossmon more than PCT% of one core\n";
+    std::cout << "                           (collection plus output, as thread CPU time)\n";
+    std::cout << "  --adaptive MSEC           Sample at -i while metrics move and stretch the interval up\n";
+    std::cout << "                           to MSEC while they are flat; statistics are time-weighted\n";
+    std::cout << "  --adaptive-step PP        Change between samples that counts as movement (default: 5)\n";
+    std::cout << "  --catch-up                Run ticks missed during a slow sample back to back\n";
+    std::cout << "                           (default: skip them and stay on the interval grid)\n\n";
     std::cout << "Arguments:\n";
     std::cout << "  APPLICATION_NAME          Monitor system while this application is running\n";
-    std::cout << "                           If not provided, monitor until Ctrl+C is pressed\n\n";
+    std::cout << "                           If not provided, monitor until Ctrl+C is pressed\n";
+    std::cout << "  -- COMMAND [ARGS...]      Run COMMAND, stop the moment it exits and report its exact\n";
+    std::cout << "                           CPU time, max RSS, context switches and block I/O\n";
+    std::cout << "                           (not available on Windows)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " --help\n";
     std::cout << "  " << programName << " -i 500 notepad.exe\n";
     std::cout << "  " << programName << " --interval 2000 --output stats.txt chrome.exe\n";
-    std::cout << "  " << programName << " -o system_stats.txt\n\n";
+    std::cout << "  " << programName << " -o system_stats.txt\n";
+    std::cout << "  " << programName << " -o summary.json --format json\n";
+    std::cout << "  " << programName << " --record run.crossrec chrome.exe\n";
+    std::cout << "  " << programName << " -i 1000 --display-rate 0.1 --serve 127.0.0.1:9464\n";
+    std::cout << "  " << programName << " -i 100 -o build.json --format json -- make -j8\n";
+    std::cout << "  " << programName << " -i 2000 --top 5\n";
+    std::cout << "  " << programName << " -i 100 --metrics cpu,mem\n";
+    std::cout << "  " << programName << " -i 100 --adaptive 2000\n";
+    std::cout << "  " << programName << " -i 100 --overhead-budget 1 -o overhead.json --format json\n";
+    std::cout << "  " << programName << " replay run.crossrec -o stats.txt\n\n";
     std::cout << "The program monitors CPU, Memory, and GPU usage in real-time.\n";
     std::cout << "Press Ctrl+C to stop monitoring and view statistics.\n";
 } 
\ No newline at end of file
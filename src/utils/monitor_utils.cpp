@@ -2,12 +2,14 @@
 #include "utils/process_manager.hpp"
 #include "utils/statistics.hpp"
 #include "utils/output_formatter.hpp"
+#include "utils/collector_pool.hpp"
+#include "utils/sample_scheduler.hpp"
+#include "utils/recording.hpp"
+#include "utils/console_line.hpp"
+#include "utils/metrics_server.hpp"
+#include "utils/metric_sources.hpp"
+#include "utils/self_usage.hpp"
 #include "cpu_monitor.hpp"
-#include "memory_monitor.hpp"
-#include "gpu_monitor.hpp"
-#ifdef _WIN32
-#include "npu_monitor.hpp"
-#endif
 #include <thread>
 #include <chrono>
 #include <vector>
@@ -15,206 +17,589 @@
 #include <csignal>
 #include <atomic>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 ICpuMonitor* createCpuMonitor();
-IMemoryMonitor* createMemoryMonitor();
-IGpuMonitor* createGpuMonitor();
 
 namespace {
 std::atomic<bool> keepRunning(true);
 void signalHandler(int) { keepRunning = false; }
 }
 
-void monitorSystemUsage(const MonitorArgs& args, SystemSamples& samples) {
+namespace {
+// Only the slots of sources opened for the run are accumulated, so a source
+// left out with --metrics leaves its statistics empty rather than zero-filled.
+//
+// weight is the time the sample stands for in shortest intervals (1 at a fixed
+// interval), so averages and percentiles stay time-weighted when the interval adapts
+void recordTick(SystemSamples& samples, const TickSnapshot& tick, const CollectorLatency& latency, double weight) {
+    // Sketches count whole samples; a sample covering n shortest intervals counts n times
+    uint64_t count = static_cast<uint64_t>(std::max(std::llround(weight), 1LL));
+    if (tick.has(MetricSlot::Cpu)) {
+        samples.cpu.add(tick.cpu, weight);
+        samples.cpuSketch.add(tick.cpu, count);
+        if (!tick.coreBusy.empty()) {
+            samples.perCore.add(tick.coreBusy.data(), weight);
+        }
+    }
+    if (tick.has(MetricSlot::Memory)) {
+        samples.memoryUsedMBStats.add(static_cast<double>(tick.mem.usedPhysicalMB), weight);
+        samples.memoryUsedMBSketch.add(static_cast<double>(tick.mem.usedPhysicalMB), count);
+        samples.memoryUsedPercentStats.add(tick.mem.usedPercentage, weight);
+        samples.memoryUsedPercentSketch.add(tick.mem.usedPercentage, count);
+    }
+    if (tick.has(MetricSlot::Gpu)) {
+        samples.gpu.add(tick.gpu.averageUtilization, weight);
+        samples.gpuSketch.add(tick.gpu.averageUtilization, count);
+        if (!tick.gpuBusy.empty()) {
+            samples.perGpu.add(tick.gpuBusy.data(), weight);
+        }
+    }
+    if (tick.has(MetricSlot::Npu)) {
+        samples.npu.add(tick.npu, weight);
+        samples.npuSketch.add(tick.npu, count);
+    }
+    if (tick.has(MetricSlot::Process) && tick.process.processes > 0) {
+        samples.processCpu.add(tick.process.cpuPercent, weight);
+        samples.processRssKB.add(static_cast<double>(tick.process.rssKB), weight);
+        samples.processPssKB.add(static_cast<double>(tick.process.pssKB), weight);
+        ProcessStats& totals = samples.processTotals;
+        totals.peakProcesses = std::max(totals.peakProcesses, tick.process.processes);
+        totals.minorFaults += tick.process.minorFaults;
+        totals.majorFaults += tick.process.majorFaults;
+        totals.readBytes += tick.process.readBytes;
+        totals.writeBytes += tick.process.writeBytes;
+    }
+    accumulateLatency(samples.latency, latency);
+
+    // NaN marks a column whose source is not sampled; the store leaves it out of its rollups
+    const double absent = std::numeric_limits<double>::quiet_NaN();
+    double values[TimeSeriesStore::MetricCount] = {};
+    values[TimeSeriesStore::Cpu] = tick.has(MetricSlot::Cpu) ? tick.cpu : absent;
+    values[TimeSeriesStore::MemoryUsedMB] =
+        tick.has(MetricSlot::Memory) ? static_cast<double>(tick.mem.usedPhysicalMB) : absent;
+    values[TimeSeriesStore::MemoryUsedPercent] = tick.has(MetricSlot::Memory) ? tick.mem.usedPercentage : absent;
+    values[TimeSeriesStore::Gpu] = tick.has(MetricSlot::Gpu) ? tick.gpu.averageUtilization : absent;
+    values[TimeSeriesStore::Npu] = tick.has(MetricSlot::Npu) ? tick.npu : absent;
+    samples.history.add(tick.timestampNs / 1000000, values);
+
+    if (!samples.keepHistory) return;
+    if (!tick.coreBusy.empty()) {
+        samples.perCoreUsage.append(tick.coreBusy.data());
+    }
+    samples.collectorLatency.push_back(latency);
+}
+
+TimeSeriesConfig historyConfigFor(const MonitorArgs& args, int intervalMs) {
+    TimeSeriesConfig config;
+    config.rawCapacity = static_cast<std::size_t>(std::max(args.historyMinutes, 0)) * 60000 /
+                         static_cast<std::size_t>(std::max(intervalMs, 1));
+    return config;
+}
+
+// Summary sections of the sources present in tick
+SummarySections sectionsOf(const TickSnapshot& tick) {
+    SummarySections sections;
+    sections.cpu = tick.has(MetricSlot::Cpu);
+    sections.memory = tick.has(MetricSlot::Memory);
+    sections.gpu = tick.has(MetricSlot::Gpu);
+    sections.npu = tick.has(MetricSlot::Npu);
+    sections.process = tick.has(MetricSlot::Process);
+    return sections;
+}
+
+// Signals that drive the adaptive interval; sources that were not opened stay
+// at zero and so never count as movement
+constexpr std::size_t kAdaptiveSignals = 6;
+
+void adaptiveSignals(const TickSnapshot& tick, double* signals) {
+    signals[0] = tick.cpu;
+    // The busiest core shows a one-core burst the total would average away
+    signals[1] = tick.coreBusy.empty() ? 0.0 : *std::max_element(tick.coreBusy.begin(), tick.coreBusy.end());
+    signals[2] = tick.mem.usedPercentage;
+    signals[3] = tick.gpuBusy.empty() ? tick.gpu.averageUtilization
+                                      : *std::max_element(tick.gpuBusy.begin(), tick.gpuBusy.end());
+    signals[4] = tick.npu;
+    signals[5] = tick.process.cpuPercent;
+}
+
+// Mean spacing and rate of the samples between firstNs and lastNs
+void finishIntervalTiming(TimingStats& timing, int64_t firstNs, int64_t lastNs) {
+    if (timing.ticks < 2 || lastNs <= firstNs) return;
+    double spanMs = static_cast<double>(lastNs - firstNs) / 1e6;
+    timing.meanIntervalMs = spanMs / static_cast<double>(timing.ticks - 1);
+    timing.samplesPerHour = 3600000.0 / timing.meanIntervalMs;
+}
+
+// Rebuilds scheduler timing from recorded timestamps by matching each sample
+// to the nearest interval slot after the first one
+struct ReplayTimeline {
+    int64_t firstNs = 0;
+    int64_t intervalNs = 1;
+    int64_t lastSlot = -1;
+    double jitterSumUs = 0.0;
+
+    void add(int64_t timestampNs, TimingStats& timing) {
+        if (timing.ticks == 0) firstNs = timestampNs;
+        int64_t offset = timestampNs - firstNs;
+        int64_t slot = (offset + intervalNs / 2) / intervalNs;
+        if (lastSlot >= 0 && slot > lastSlot + 1) {
+            ++timing.overruns;
+            timing.skippedTicks += static_cast<std::size_t>(slot - lastSlot - 1);
+        }
+        lastSlot = std::max(lastSlot, slot);
+        double jitterUs = std::abs(static_cast<double>(offset - slot * intervalNs)) / 1000.0;
+        jitterSumUs += jitterUs;
+        timing.maxJitterUs = std::max(timing.maxJitterUs, jitterUs);
+        ++timing.ticks;
+        timing.meanJitterUs = jitterSumUs / timing.ticks;
+    }
+};
+
+void appendRecording(RecordingWriter& recorder, const TickSnapshot& tick, const CollectorLatency& latency) {
+    SampleRecord record;
+    record.timestampNs = tick.timestampNs;
+    record.cpuPercent = tick.cpu;
+    record.memoryUsedMB = tick.mem.usedPhysicalMB;
+    record.memoryTotalMB = tick.mem.totalPhysicalMB;
+    record.memoryUsedPercent = tick.mem.usedPercentage;
+    record.gpuPercent = tick.gpu.averageUtilization;
+    record.npuPercent = tick.npu;
+    record.cpuLatencyMs = static_cast<float>(latency.cpuMs);
+    record.memoryLatencyMs = static_cast<float>(latency.memoryMs);
+    record.gpuLatencyMs = static_cast<float>(latency.gpuMs);
+    record.npuLatencyMs = static_cast<float>(latency.npuMs);
+    recorder.append(record, tick.coreBusy.data(), tick.gpuBusy.data());
+}
+
+// Formatted into a stack buffer and written in one call, so the sampling
+// thread never allocates, consults the locale or flushes iostreams per tick
+void printTick(const TickSnapshot& tick) {
+    LineBuffer line;
+    formatTickLine(line, tick.has(MetricSlot::Cpu) ? &tick.cpu : nullptr,
+                   tick.has(MetricSlot::Memory) ? &tick.mem : nullptr,
+                   tick.has(MetricSlot::Gpu) ? &tick.gpu : nullptr,
+                   tick.has(MetricSlot::Npu) ? &tick.npu : nullptr);
+    writeConsoleLine(line);
+}
+
+void appendTopRanking(LineBuffer& line, const char* label, std::size_t labelLength,
+                      const std::vector<TopProcess>& rows, bool byCpu) {
+    line.append(label, labelLength);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        line.append(i == 0 ? " " : " | ", i == 0 ? 1 : 3);
+        line.append(rows[i].name, std::strlen(rows[i].name));
+        line.append("(");
+        line.appendUint(static_cast<uint64_t>(rows[i].pid));
+        line.append(") ");
+        if (byCpu) {
+            line.appendFixed1(rows[i].cpuPercent);
+            line.append("%");
+        } else {
+            line.appendFixed1(static_cast<double>(rows[i].rssKB) / 1024.0);
+            line.append(" MB");
+        }
+    }
+    line.append("\n");
+}
+
+// Two lines under the status line: "  Top CPU: name(pid) x% | ..." and
+// "  Top RSS: name(pid) y MB | ..."; rows past the line capacity are cut off
+void printTopProcesses(const std::vector<TopProcess>& byCpu, const std::vector<TopProcess>& byRss) {
+    LineBuffer line;
+    appendTopRanking(line, "  Top CPU:", 10, byCpu, true);
+    writeConsoleLine(line);
+    line.clear();
+    appendTopRanking(line, "  Top RSS:", 10, byRss, false);
+    writeConsoleLine(line);
+}
+}
+
+bool monitorSystemUsage(const MonitorArgs& args, SystemSamples& samples) {
     std::signal(SIGINT, signalHandler);
     
-    ICpuMonitor* cpuMonitor = createCpuMonitor();
-    IMemoryMonitor* memoryMonitor = createMemoryMonitor();
-    IGpuMonitor* gpuMonitor = createGpuMonitor();
+    // Bound before any collector starts, so a taken port fails fast
+    MetricsServer server;
+    if (!args.serveAddress.empty()) {
+        if (!server.start(args.serveAddress)) {
+            std::cerr << "Failed to serve metrics on " << args.serveAddress << ": " << server.error() << std::endl;
+            return false;
+        }
+    }
     
-#ifdef _WIN32
-    NPUMonitor* npuMonitor = create_windows_npu_monitor();
-    bool npuAvailable = npuMonitor->initialize();
-    if (npuAvailable) {
-        NPUUsage npuInfo = npuMonitor->get_usage();
-        samples.npuName = npuInfo.name;
+    // A command given after -- is started here and owned for the whole run
+    ChildProcess child;
+    if (!args.command.empty() && !child.start(args.command)) {
+        std::cerr << "Failed to start command: " << child.error() << std::endl;
+        return false;
     }
-#else
-    bool npuAvailable = false;
-#endif
     
-    // Initialize CPU monitor and trigger GPU detection
-    cpuMonitor->getCpuBusy();
+    // Only the selected sources are constructed; each writes its own slots of the snapshot
+    AppWatcher watcher(args.appName);
+    TickSnapshot tick;
+    MetricSourceSet sources;
+    if (!sources.open(MetricSourceContext{args, child, watcher}, tick)) {
+        std::cerr << sources.error() << std::endl;
+        return false;
+    }
+    if (args.top > 0 && !findMetricDescriptor("top")) {
+        std::cerr << "--top is only supported on Linux" << std::endl;
+    }
+    samples.sections = sectionsOf(tick);
+    samples.npuName = tick.npuName;
+    samples.processTotals.name = tick.processName;
+    
+    // Per-core and per-GPU rows were sized when the sources opened and are reused every tick
+    samples.perCore.reset(tick.coreBusy.size());
+    samples.perCoreUsage.reset(tick.coreBusy.size());
+    samples.gpuCount = tick.gpuBusy.size();
+    samples.perGpu.reset(samples.gpuCount);
+    samples.keepHistory = args.keepHistory;
     
-    // Get GPU count
-    GpuUsage initialGpuCheck = gpuMonitor->getGpuUsage();
-    samples.gpuCount = gpuMonitor->getGpuCount();
+    // History storage is allocated here, up front, and never grows afterwards
+    samples.history = TimeSeriesStore(historyConfigFor(args, args.interval));
+    
+    // Sources run concurrently, one job each, so a tick costs the slowest one
+    // (e.g. the Windows PDH CPU query) rather than the sum of all of them
+    CollectorPool pool;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        IMetricSource& source = sources[i];
+        pool.addJob([&source, &tick] { source.collect(tick); });
+    }
     
-#ifdef _DEBUG
-    std::cout << "[DEBUG] GPU initialization complete. Count: " << samples.gpuCount << std::endl;
-    std::cout << "[DEBUG] Initial GPU check - Average utilization: " 
-              << initialGpuCheck.averageUtilization << "%" << std::endl;
-    for (size_t i = 0; i < initialGpuCheck.gpus.size(); ++i) {
-        std::cout << "[DEBUG] GPU " << i << ": " << initialGpuCheck.gpus[i].name 
-                  << " - " << initialGpuCheck.gpus[i].utilizationPercent << "%" << std::endl;
+    // The recorder only queues each sample; file I/O happens on its own thread
+    RecordingWriter recorder;
+    if (!args.recordPath.empty()) {
+        RecordingHeader header = makeRecordingHeader(
+            static_cast<uint32_t>(args.interval), tick.coreBusy.size(), tick.gpuBusy.size(), samples.npuName,
+            args.compressRecording ? RecordingEncoding::Gorilla : RecordingEncoding::Raw);
+        header.maxIntervalMs = static_cast<uint32_t>(args.adaptiveMaxInterval);
+        header.sampledSlots = tick.present;
+        header.quantized = args.lossyRecording ? 1 : 0;
+        if (recorder.open(args.recordPath, header)) {
+            std::cout << "Recording samples to " << args.recordPath << std::endl;
+        } else {
+            std::cerr << "Failed to open recording " << args.recordPath << std::endl;
+        }
     }
+    
+    // Sampling always runs at the full interval; only the console line is rate-limited
+    DisplayThrottle display(args.displayRate);
+    
+    // Ticks target absolute deadlines, so collection and console time do not drift the schedule;
+    // with a command running, the wait also ends the moment it exits
+#ifdef _WIN32
+    SteadySchedulerClock clock;
+#else
+    WakeableSchedulerClock clock(child.exitFd());
 #endif
+    SampleScheduler scheduler(std::chrono::milliseconds(args.interval),
+                              args.catchUp ? OverrunPolicy::CatchUp : OverrunPolicy::Skip, clock);
+    
+    // With --adaptive the next deadline is chosen after every tick, between -i and the maximum
+    bool adaptive = args.adaptiveMaxInterval > 0;
+    AdaptiveInterval adaptiveInterval(std::chrono::milliseconds(args.interval),
+                                      std::chrono::milliseconds(args.adaptiveMaxInterval), args.adaptiveStep,
+                                      kAdaptiveSignals);
+    double signals[kAdaptiveSignals] = {};
+    int64_t firstTimestampNs = 0;
+    int64_t lastTimestampNs = 0;
+    
+    // Reused every tick; the per-core and per-GPU vectors keep their size
+    MetricsSnapshot snapshot;
+    snapshot.cpuAvailable = tick.has(MetricSlot::Cpu);
+    snapshot.memoryAvailable = tick.has(MetricSlot::Memory);
+    snapshot.gpuAvailable = tick.has(MetricSlot::Gpu);
+    snapshot.npuAvailable = tick.has(MetricSlot::Npu);
+    
+    // crossmon's own cost: thread CPU per collector job and for everything after
+    // collection, plus its RSS and syscall count, read once per tick
+    SelfUsageReader selfReader;
+    SelfUsage self;
+    selfReader.read(self);
+    uint64_t lastSyscalls = self.syscalls;
+    samples.overhead.intervalMs = args.interval;
+    samples.overhead.budgetPercent = args.overheadBudget;
+    bool budgetWarned = false;
+    
+    auto collectTick = [&] {
+        tick.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        pool.runAll();
+        auto outputBegin = std::chrono::steady_clock::now();
+        uint64_t outputCpuBegin = threadCpuTimeNs();
+        TickOverhead overhead;
+        double latencyBySlot[static_cast<std::size_t>(MetricSlot::Count)] = {};
+        double cpuBySlot[static_cast<std::size_t>(MetricSlot::Count)] = {};
+        for (std::size_t job = 0; job < pool.jobCount(); ++job) {
+            std::size_t slot = static_cast<std::size_t>(sources[job].descriptor().slot);
+            latencyBySlot[slot] = pool.lastLatencyMs(job);
+            cpuBySlot[slot] = pool.lastCpuMs(job);
+            overhead.collectCpuMs += pool.lastCpuMs(job);
+        }
+        overhead.collectorCpu = collectorLatencyFromSlots(cpuBySlot);
+        CollectorLatency latency = collectorLatencyFromSlots(latencyBySlot);
+        double weight = adaptive ? sampleWeight(lastTimestampNs, tick.timestampNs,
+                                                std::chrono::milliseconds(args.interval))
+                                 : 1.0;
+        if (firstTimestampNs == 0) firstTimestampNs = tick.timestampNs;
+        lastTimestampNs = tick.timestampNs;
+        recordTick(samples, tick, latency, weight);
+        if (adaptive) {
+            // The tick's CPU is measured against the interval it was scheduled at
+            samples.overhead.intervalMs = std::chrono::duration<double, std::milli>(adaptiveInterval.current()).count();
+            adaptiveSignals(tick, signals);
+            scheduler.setInterval(adaptiveInterval.observe(signals));
+        }
+        if (recorder.isOpen()) {
+            appendRecording(recorder, tick, latency);
+        }
+        if (server.isRunning()) {
+            TimingStats timing = scheduler.stats();
+            snapshot.timestampMs = tick.timestampNs / 1000000;
+            snapshot.cpuPercent = tick.cpu;
+            snapshot.corePercent = tick.coreBusy;
+            snapshot.memoryUsedMB = tick.mem.usedPhysicalMB;
+            snapshot.memoryTotalMB = tick.mem.totalPhysicalMB;
+            snapshot.memoryUsedPercent = tick.mem.usedPercentage;
+            snapshot.gpuPercent = tick.gpu.averageUtilization;
+            snapshot.gpuPercentPerDevice = tick.gpuBusy;
+            snapshot.npuPercent = tick.npu;
+            snapshot.latency = latency;
+            snapshot.samples = samples.latency.samples;
+            snapshot.overruns = timing.overruns;
+            snapshot.skippedTicks = timing.skippedTicks;
+            server.publish(snapshot);
+        }
+        if (display.shouldDisplay(std::chrono::steady_clock::now())) {
+            printTick(tick);
+            if (tick.has(MetricSlot::Top)) printTopProcesses(tick.topByCpu, tick.topByRss);
+        }
+        overhead.outputCpuMs = static_cast<double>(threadCpuTimeNs() - outputCpuBegin) / 1e6;
+        overhead.outputWallMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - outputBegin).count();
+        if (selfReader.read(self)) {
+            overhead.rssKB = self.rssKB;
+            overhead.syscalls = self.syscalls - lastSyscalls;
+            lastSyscalls = self.syscalls;
+        }
+        if (!accumulateOverhead(samples.overhead, overhead) && !budgetWarned) {
+            // Once per run; the summary counts every tick that went over
+            budgetWarned = true;
+            double tickCpuMs = overhead.collectCpuMs + overhead.outputCpuMs;
+            std::cerr << "Warning: tick " << samples.overhead.ticks << " cost " << std::fixed << std::setprecision(3)
+                      << tickCpuMs << " ms CPU (" << samples.overhead.tickCpuPercent(tickCpuMs)
+                      << "% of one core), over the --overhead-budget of " << args.overheadBudget << "%" << std::endl;
+        }
+    };
     
     std::cout << "System Information:\n";
-    std::cout << "GPUs detected: " << samples.gpuCount << std::endl;
-#ifdef _WIN32
-    if (npuAvailable) {
+    if (tick.has(MetricSlot::Gpu)) {
+        std::cout << "GPUs detected: " << samples.gpuCount << std::endl;
+    }
+    if (tick.has(MetricSlot::Npu)) {
         std::cout << "NPU detected: " << samples.npuName << std::endl;
-    } else {
+    } else if (findMetricDescriptor("npu")) {
         std::cout << "NPU: Not available" << std::endl;
+    } else {
+        std::cout << "NPU: Not supported on this platform" << std::endl;
+    }
+    
+    if (server.isRunning()) {
+        std::cout << "Serving OpenMetrics on http://" << args.serveAddress << "/metrics" << std::endl;
     }
-#else
-    std::cout << "NPU: Not supported on this platform" << std::endl;
-#endif
     
     if (!args.appName.empty()) {
         std::cout << "Monitoring system usage while " << args.appName << " is running...\n";
-        std::cout << "Press Ctrl+C to stop and see statistics.\n\n";
-        
-        while (keepRunning && isAppRunning(args.appName)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(args.interval));
-            
-            // Get CPU usage
-            double cpu = cpuMonitor->getCpuBusy();
-            samples.cpuUsage.push_back(cpu);
-            
-            // Get memory usage
-            MemoryUsage mem = memoryMonitor->getMemoryUsage();
-            samples.memoryUsedMB.push_back(mem.usedPhysicalMB);
-            samples.memoryUsedPercent.push_back(mem.usedPercentage);
-            
-            // Get GPU usage
-            GpuUsage gpu = gpuMonitor->getGpuUsage();
-            samples.gpuUtilization.push_back(gpu.averageUtilization);
-            
-            // Get NPU usage
-#ifdef _WIN32
-            double npuUsage = 0.0;
-            if (npuAvailable) {
-                NPUUsage npu = npuMonitor->get_usage();
-                npuUsage = npu.usage_percent;
-            }
-            samples.npuUtilization.push_back(npuUsage);
-#endif
-            
-            // Display current usage with individual GPU info
-            std::cout << "CPU: " << std::fixed << std::setprecision(1) << cpu << "% | "
-                      << "Memory: " << mem.usedPhysicalMB << " MB ("
-                      << std::fixed << std::setprecision(1) << mem.usedPercentage << "%) | ";
-            
-#ifdef _DEBUG
-            std::cout << "[DEBUG: " << gpu.gpus.size() << " GPUs] ";
-#endif
-            if (gpu.gpus.size() > 1) {
-                std::cout << "GPUs: ";
-                for (size_t i = 0; i < gpu.gpus.size(); ++i) {
-                    if (i > 0) std::cout << ", ";
-                    std::cout << std::fixed << std::setprecision(1) << gpu.gpus[i].utilizationPercent << "%";
-#ifdef _DEBUG
-                    std::cout << "(" << gpu.gpus[i].name << ")";
-#endif
-                }
-                std::cout << " (avg: " << std::fixed << std::setprecision(1) << gpu.averageUtilization << "%)";
-            } else {
-                std::cout << "GPU: " << std::fixed << std::setprecision(1) << gpu.averageUtilization << "%";
-            }
-            
-#ifdef _WIN32
-            if (npuAvailable) {
-                std::cout << " | NPU: " << std::fixed << std::setprecision(1) << npuUsage << "%";
-            }
-#endif
-            std::cout << std::endl;
-        }
+    } else if (child.isRunning()) {
+        std::cout << "Monitoring system usage while " << args.command[0] << " (PID " << child.pid() << ") runs...\n";
     } else {
         std::cout << "Monitoring system usage...\n";
-        std::cout << "Press Ctrl+C to stop and see statistics.\n\n";
-        
-        while (keepRunning) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(args.interval));
-            
-            // Get CPU usage
-            double cpu = cpuMonitor->getCpuBusy();
-            samples.cpuUsage.push_back(cpu);
-            
-            // Get memory usage
-            MemoryUsage mem = memoryMonitor->getMemoryUsage();
-            samples.memoryUsedMB.push_back(mem.usedPhysicalMB);
-            samples.memoryUsedPercent.push_back(mem.usedPercentage);
-            
-            // Get GPU usage
-            GpuUsage gpu = gpuMonitor->getGpuUsage();
-            samples.gpuUtilization.push_back(gpu.averageUtilization);
-            
-            // Get NPU usage
-#ifdef _WIN32
-            double npuUsage = 0.0;
-            if (npuAvailable) {
-                NPUUsage npu = npuMonitor->get_usage();
-                npuUsage = npu.usage_percent;
-            }
-            samples.npuUtilization.push_back(npuUsage);
-#endif
-            
-            // Display current usage
-            std::cout << "CPU: " << std::fixed << std::setprecision(1) << cpu << "% | "
-                      << "Memory: " << mem.usedPhysicalMB << " MB ("
-                      << std::fixed << std::setprecision(1) << mem.usedPercentage << "%) | ";
-            
-#ifdef _DEBUG
-            std::cout << "[DEBUG: " << gpu.gpus.size() << " GPUs] ";
-#endif
-            // GPU display - individual GPUs if multiple detected
-            if (gpu.gpus.size() > 1) {
-                std::cout << "GPUs: ";
-                for (size_t i = 0; i < gpu.gpus.size(); ++i) {
-                    if (i > 0) std::cout << ", ";
-                    std::cout << std::fixed << std::setprecision(1) << gpu.gpus[i].utilizationPercent << "%";
-#ifdef _DEBUG
-                    std::cout << "(" << gpu.gpus[i].name << ")";
-#endif
-                }
-                std::cout << " (avg: " << std::fixed << std::setprecision(1) << gpu.averageUtilization << "%)";
-            } else {
-                std::cout << "GPU: " << std::fixed << std::setprecision(1) << gpu.averageUtilization << "%";
-            }
-            
-#ifdef _WIN32
-            if (npuAvailable) {
-                std::cout << " | NPU: " << std::fixed << std::setprecision(1) << npuUsage << "%";
-            }
-#endif
-            
-            std::cout << std::endl;
+    }
+    std::cout << "Press Ctrl+C to stop and see statistics.\n\n" << std::flush;
+    
+    // Runs until Ctrl+C, the application's last process exits, or the command
+    // exits (waitNext() fails the moment it does, so no tick is taken after it)
+    uint64_t processCpuBegin = processCpuTimeNs();
+    auto wallBegin = std::chrono::steady_clock::now();
+    while (keepRunning && (args.appName.empty() || watcher.isRunning()) && scheduler.waitNext()) {
+        collectTick();
+    }
+    samples.timing = scheduler.stats();
+    if (adaptive) {
+        samples.timing.intervalMs = args.interval;
+        samples.timing.maxIntervalMs = args.adaptiveMaxInterval;
+        samples.timing.tightenings = adaptiveInterval.tightenings();
+    }
+    finishIntervalTiming(samples.timing, firstTimestampNs, lastTimestampNs);
+    if (adaptive && samples.timing.meanIntervalMs > 0.0) {
+        // The summary's share of one core is against the interval actually kept
+        samples.overhead.intervalMs = samples.timing.meanIntervalMs;
+    }
+    samples.overhead.processCpuSeconds = static_cast<double>(processCpuTimeNs() - processCpuBegin) / 1e9;
+    samples.overhead.wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBegin).count();
+    if (child.isRunning()) {
+        // After Ctrl+C this waits for the command, which received the same SIGINT
+        samples.command = child.wait();
+        if (!child.error().empty()) {
+            std::cerr << "Failed to collect command exit status: " << child.error() << std::endl;
         }
     }
     
-    delete cpuMonitor;
-    delete memoryMonitor;
-    delete gpuMonitor;
-#ifdef _WIN32
-    delete npuMonitor;
-#endif
+    if (recorder.isOpen()) {
+        recorder.close();
+        std::cout << "\nRecorded " << recorder.recordsWritten() << " samples to " << args.recordPath;
+        if (recorder.recordsDropped() > 0) {
+            std::cout << " (" << recorder.recordsDropped() << " dropped)";
+        }
+        std::cout << std::endl;
+    }
+    
+    return true;
+}
+
+bool replaySystemUsage(const MonitorArgs& args, SystemSamples& samples) {
+    RecordingReader reader;
+    if (!reader.open(args.replayPath)) {
+        std::cerr << "Failed to replay recording: " << reader.error() << std::endl;
+        return false;
+    }
+    std::signal(SIGINT, signalHandler);
+    
+    const RecordingHeader& header = reader.header();
+    std::cout << "Replaying " << args.replayPath << "\n";
+    std::cout << "Host:     " << header.host << " (" << header.kernel << ")\n";
+    std::cout << "CPU:      " << header.cpuModel << "\n";
+    std::cout << "Interval: " << header.intervalMs << " ms" << std::endl;
+    if (header.quantized) {
+        std::cout << "Values were rounded when recorded (lossy compression)" << std::endl;
+    }
+    
+    // Every recording has all the columns, but only the sampled ones hold data.
+    // Version 1 files predate sampledSlots and always sampled CPU, memory and
+    // GPU, plus the NPU when one was named
+    TickSnapshot tick;
+    if (header.version >= 2) {
+        tick.present = header.sampledSlots;
+    } else {
+        tick.setPresent(MetricSlot::Cpu);
+        tick.setPresent(MetricSlot::Memory);
+        tick.setPresent(MetricSlot::Gpu);
+        if (header.npuName[0] != '\0') tick.setPresent(MetricSlot::Npu);
+    }
+    // Process usage and the process table are never recorded
+    tick.present &= ~((1u << static_cast<unsigned>(MetricSlot::Process)) |
+                      (1u << static_cast<unsigned>(MetricSlot::Top)));
+    samples.sections = sectionsOf(tick);
+    tick.coreBusy.assign(header.coreCount, 0.0);
+    tick.gpuBusy.assign(header.gpuCount, 0.0);
+    samples.perCore.reset(tick.coreBusy.size());
+    samples.perCoreUsage.reset(tick.coreBusy.size());
+    samples.keepHistory = args.keepHistory;
+    samples.history = TimeSeriesStore(historyConfigFor(args, static_cast<int>(header.intervalMs)));
+    samples.gpuCount = header.gpuCount;
+    samples.perGpu.reset(tick.gpuBusy.size());
+    samples.npuName = header.npuName;
+    
+    ReplayTimeline timeline;
+    timeline.intervalNs = std::max<int64_t>(static_cast<int64_t>(header.intervalMs) * 1000000, 1);
+    samples.timing.intervalMs = header.intervalMs;
+    // An adaptive recording has no fixed grid to measure overruns against; its
+    // samples are weighted by their recorded timestamps instead
+    bool adaptive = header.maxIntervalMs > 0;
+    samples.timing.maxIntervalMs = header.maxIntervalMs;
+    int64_t lastTimestampNs = 0;
+    
+    // Fed through recordTick exactly as live ticks are, so replayed statistics
+    // match what the live run would have printed; a --compress=lossy recording
+    // holds rounded values, so its figures can differ in the last digits
+    SampleRecord record;
+    DisplayThrottle display(args.displayRate);
+    auto start = std::chrono::steady_clock::now();
+    while (keepRunning && reader.next(record, tick.coreBusy.data(), tick.gpuBusy.data())) {
+        if (args.realtime && samples.timing.ticks > 0) {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(record.timestampNs - timeline.firstNs));
+        }
+        tick.timestampNs = record.timestampNs;
+        tick.cpu = record.cpuPercent;
+        tick.mem.usedPhysicalMB = record.memoryUsedMB;
+        tick.mem.totalPhysicalMB = record.memoryTotalMB;
+        tick.mem.usedPercentage = record.memoryUsedPercent;
+        tick.gpu.averageUtilization = record.gpuPercent;
+        tick.npu = record.npuPercent;
+        CollectorLatency latency;
+        latency.cpuMs = record.cpuLatencyMs;
+        latency.memoryMs = record.memoryLatencyMs;
+        latency.gpuMs = record.gpuLatencyMs;
+        latency.npuMs = record.npuLatencyMs;
+        double weight = adaptive ? sampleWeight(lastTimestampNs, record.timestampNs,
+                                                std::chrono::milliseconds(header.intervalMs))
+                                 : 1.0;
+        lastTimestampNs = record.timestampNs;
+        recordTick(samples, tick, latency, weight);
+        if (adaptive) {
+            if (samples.timing.ticks == 0) timeline.firstNs = record.timestampNs;
+            ++samples.timing.ticks;
+        } else {
+            timeline.add(record.timestampNs, samples.timing);
+        }
+        if (args.realtime && display.shouldDisplay(std::chrono::steady_clock::now())) {
+            printTick(tick);
+        }
+    }
+    finishIntervalTiming(samples.timing, timeline.firstNs, lastTimestampNs);
+    double elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "\nReplayed " << samples.timing.ticks << " samples in " << std::fixed << std::setprecision(1)
+              << elapsedSec * 1000.0 << " ms";
+    if (elapsedSec > 0.0) {
+        std::cout << " (" << std::setprecision(0) << samples.timing.ticks / elapsedSec << " samples/s)";
+    }
+    std::cout << std::endl;
+    return true;
 }
 
-void outputSystemStatistics(const SystemSamples& samples, const std::string& resultPath) {
+void outputSystemStatistics(const SystemSamples& samples, const std::string& resultPath, OutputFormat format) {
     SystemStats stats;
-    stats.cpu = computeCpuStats(samples.cpuUsage);
-    stats.memory = computeMemoryStats(samples.memoryUsedMB, samples.memoryUsedPercent);
-    stats.gpu = computeGpuStats(samples.gpuUtilization, samples.gpuCount);
-#ifdef _WIN32
-    stats.npu = computeNpuStats(samples.npuUtilization, samples.npuName);
-#endif
+    stats.sections = samples.sections;
+    stats.cpu = computeCpuStats(samples.cpu, samples.perCore);
+    stats.memory = computeMemoryStats(samples.memoryUsedMBStats, samples.memoryUsedPercentStats);
+    stats.gpu = computeGpuStats(samples.gpu, samples.gpuCount, samples.perGpu);
+    stats.cpu.percentiles = computePercentiles(samples.cpuSketch);
+    stats.memory.usedMBPercentiles = computePercentiles(samples.memoryUsedMBSketch);
+    stats.memory.usedPercentPercentiles = computePercentiles(samples.memoryUsedPercentSketch);
+    stats.gpu.percentiles = computePercentiles(samples.gpuSketch);
+    stats.process = computeProcessStats(samples.processCpu, samples.processRssKB, samples.processPssKB,
+                                        samples.processTotals);
+    stats.command = samples.command;
+    stats.latency = samples.latency;
+    stats.timing = samples.timing;
+    stats.overhead = samples.overhead;
+    stats.history.rawSamples = samples.history.rawSize();
+    stats.history.rawCapacity = samples.history.rawCapacity();
+    for (std::size_t t = 0; t < samples.history.tierCount(); ++t) {
+        HistoryTierStats tier;
+        tier.bucketSeconds = samples.history.tierConfig(t).bucketMs / 1000.0;
+        // Columns of sources that were not sampled have no buckets, so count the fullest
+        for (int m = 0; m < TimeSeriesStore::MetricCount; ++m) {
+            auto metric = static_cast<TimeSeriesStore::Metric>(m);
+            tier.buckets = std::max(tier.buckets, samples.history.tier(metric, t).size());
+        }
+        tier.capacity = samples.history.tierConfig(t).capacity;
+        stats.history.tiers.push_back(tier);
+    }
+    stats.history.footprintBytes = samples.history.footprintBytes();
+    stats.npu = computeNpuStats(samples.npu, samples.npuName);
+    stats.npu.percentiles = computePercentiles(samples.npuSketch);
     
     printSystemStatsToConsole(stats);
     
     if (!resultPath.empty()) {
-        writeSystemStatsToFile(stats, resultPath);
+        writeSystemStatsToFile(stats, resultPath, format);
     }
 }
 
@@ -224,7 +609,8 @@ void monitorCpuUsage(const MonitorArgs& args, std::vector<double>& samples) {
     ICpuMonitor* monitor = createCpuMonitor();
     monitor->getCpuBusy(); // Initialize
     if (!args.appName.empty()) {
-        while (keepRunning && isAppRunning(args.appName)) {
+        AppWatcher watcher(args.appName);
+        while (keepRunning && watcher.isRunning()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(args.interval));
             double cpu = monitor->getCpuBusy();
             samples.push_back(cpu);
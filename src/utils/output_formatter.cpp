@@ -2,6 +2,623 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+std::ostream& operator<<(std::ostream& out, const Percentiles& p) {
+    return out << p.p50 << " / " << p.p90 << " / " << p.p99 << " / " << p.p999;
+}
+
+std::string bucketLabel(double seconds) {
+    std::ostringstream label;
+    if (seconds >= 3600.0 && static_cast<long long>(seconds) % 3600 == 0) {
+        label << static_cast<long long>(seconds / 3600.0) << " h";
+    } else if (seconds >= 60.0 && static_cast<long long>(seconds) % 60 == 0) {
+        label << static_cast<long long>(seconds / 60.0) << " min";
+    } else {
+        label << seconds << " s";
+    }
+    return label.str();
+}
+
+void renderCpuStats(std::ostream& out, const CpuStats& stats) {
+    out << "CPU Usage Statistics\n";
+    out << "Samples: " << stats.samples << "\n";
+    out << "Peak:    " << stats.peak << "%\n";
+    out << "Average: " << stats.average << "%\n";
+    out << "Min:     " << stats.min << "%\n";
+    out << "Max:     " << stats.max << "%\n";
+    out << "StdDev:  " << stats.stddev << "%\n";
+    out << "P50/P90/P99/P99.9: " << stats.percentiles << "%\n";
+    if (!stats.coreAverage.empty()) {
+        out << "Cores:   " << stats.coreAverage.size() << "\n";
+        out << "Imbalance: " << stats.imbalance << " pp\n";
+        for (std::size_t i = 0; i < stats.coreAverage.size(); ++i) {
+            out << "Core " << i << ": avg " << stats.coreAverage[i] << "%, peak " << stats.corePeak[i] << "%\n";
+        }
+    }
+}
+
+void renderMemoryStats(std::ostream& out, const MemoryStats& stats) {
+    out << "\nMemory Usage Statistics\n";
+    out << "Samples:     " << stats.samples << "\n";
+    out << "Peak Used:   " << stats.peakUsedMB << " MB (" << stats.peakUsedPercent << "%)\n";
+    out << "Avg Used:    " << stats.avgUsedMB << " MB (" << stats.avgUsedPercent << "%)\n";
+    out << "Min Used:    " << stats.minUsedMB << " MB (" << stats.minUsedPercent << "%)\n";
+    out << "Max Used:    " << stats.maxUsedMB << " MB (" << stats.maxUsedPercent << "%)\n";
+    out << "StdDev:      " << stats.stddevUsedMB << " MB (" << stats.stddevUsedPercent << "%)\n";
+    out << "P50/P90/P99/P99.9: " << stats.usedMBPercentiles << " MB (" << stats.usedPercentPercentiles << "%)\n";
+}
+
+void renderGpuStats(std::ostream& out, const GpuStats& stats) {
+    out << "\nGPU Usage Statistics\n";
+    out << "GPUs Found:      " << stats.gpuCount << "\n";
+    out << "Samples:         " << stats.samples << "\n";
+    out << "Peak GPU:        " << stats.peakUtilization << "%\n";
+    out << "Avg GPU:         " << stats.avgUtilization << "%\n";
+    out << "Min GPU:         " << stats.minUtilization << "%\n";
+    out << "Max GPU:         " << stats.maxUtilization << "%\n";
+    out << "StdDev GPU:      " << stats.stddevUtilization << "%\n";
+    out << "P50/P90/P99/P99.9: " << stats.percentiles << "%\n";
+    if (stats.deviceAverage.size() > 1) {
+        for (std::size_t i = 0; i < stats.deviceAverage.size(); ++i) {
+            out << "GPU " << i << ": avg " << stats.deviceAverage[i] << "%, peak " << stats.devicePeak[i] << "%\n";
+        }
+    }
+}
+
+void renderNpuStats(std::ostream& out, const NpuStats& stats) {
+    out << "\nNPU Usage Statistics\n";
+    out << "NPU:             " << (stats.npuName.empty() ? "Not available" : stats.npuName) << "\n";
+    out << "Samples:         " << stats.samples << "\n";
+    if (stats.samples > 0) {
+        out << "Peak NPU:        " << stats.peakUtilization << "%\n";
+        out << "Avg NPU:         " << stats.avgUtilization << "%\n";
+        out << "Min NPU:         " << stats.minUtilization << "%\n";
+        out << "Max NPU:         " << stats.maxUtilization << "%\n";
+        out << "StdDev NPU:      " << stats.stddevUtilization << "%\n";
+        out << "P50/P90/P99/P99.9: " << stats.percentiles << "%\n";
+    }
+}
+
+void renderProcessStats(std::ostream& out, const ProcessStats& stats) {
+    if (stats.samples == 0) return;
+    out << "\nProcess Usage Statistics\n";
+    out << "Application:     " << stats.name << " (" << stats.peakProcesses << " processes at peak)\n";
+    out << "Samples:         " << stats.samples << "\n";
+    out << "Peak CPU:        " << stats.peakCpu << "%\n";
+    out << "Avg CPU:         " << stats.avgCpu << "%\n";
+    out << "Peak RSS:        " << stats.peakRssKB / 1024.0 << " MB (PSS " << stats.peakPssKB / 1024.0 << " MB)\n";
+    out << "Avg RSS:         " << stats.avgRssKB / 1024.0 << " MB (PSS " << stats.avgPssKB / 1024.0 << " MB)\n";
+    out << "Page Faults:     " << stats.minorFaults << " minor, " << stats.majorFaults << " major\n";
+    out << "Disk I/O:        " << stats.readBytes / 1048576.0 << " MB read, " << stats.writeBytes / 1048576.0
+        << " MB written\n";
+}
+
+void renderCommandStats(std::ostream& out, const CommandStats& stats) {
+    if (stats.command.empty()) return;
+    out << "\nCommand Resource Totals\n";
+    out << "Command:         " << stats.command << "\n";
+    out << "Exit Code:       " << stats.exitCode << "\n";
+    out << "Wall Time:       " << stats.wallSeconds << " s\n";
+    out << "CPU Time:        " << stats.userSeconds << " s user, " << stats.systemSeconds << " s system\n";
+    out << "Max RSS:         " << stats.maxRssKB / 1024.0 << " MB\n";
+    out << "Page Faults:     " << stats.minorFaults << " minor, " << stats.majorFaults << " major\n";
+    out << "Context Switches: " << stats.voluntarySwitches << " voluntary, " << stats.involuntarySwitches
+        << " involuntary\n";
+    out << "Block I/O:       " << stats.blockInputOps << " in, " << stats.blockOutputOps << " out\n";
+}
+
+void renderLatencyStats(std::ostream& out, const LatencyStats& stats) {
+    if (stats.samples == 0) return;
+    out << "\nCollector Latency (avg / max)\n";
+    out << "CPU:             " << stats.average.cpuMs << " / " << stats.max.cpuMs << " ms\n";
+    out << "Memory:          " << stats.average.memoryMs << " / " << stats.max.memoryMs << " ms\n";
+    out << "GPU:             " << stats.average.gpuMs << " / " << stats.max.gpuMs << " ms\n";
+#ifdef _WIN32
+    out << "NPU:             " << stats.average.npuMs << " / " << stats.max.npuMs << " ms\n";
+#endif
+}
+
+void renderTimingStats(std::ostream& out, const TimingStats& stats) {
+    if (stats.ticks == 0) return;
+    out << "\nSampling Timing\n";
+    out << "Ticks:           " << stats.ticks << "\n";
+    if (stats.maxIntervalMs > 0.0) {
+        out << "Interval:        adaptive " << stats.intervalMs << "-" << stats.maxIntervalMs << " ms (avg "
+            << stats.meanIntervalMs << " ms)\n";
+        out << "Samples/hour:    " << stats.samplesPerHour << " (" << stats.tightenings << " tightenings)\n";
+    } else {
+        out << "Interval:        " << stats.intervalMs << " ms\n";
+    }
+    out << "Overruns:        " << stats.overruns << " (" << stats.skippedTicks << " ticks skipped)\n";
+    out << "Jitter:          " << stats.meanJitterUs << " us avg, " << stats.maxJitterUs << " us max\n";
+}
+
+void renderOverheadStats(std::ostream& out, const OverheadStats& stats) {
+    if (stats.ticks == 0) return;
+    out << "\nMonitor Overhead (thread CPU per tick)\n";
+    out << "Tick CPU:        " << stats.averageTickCpuMs << " / " << stats.maxTickCpuMs << " ms ("
+        << stats.tickCpuPercent(stats.averageTickCpuMs) << "% of one core)\n";
+    out << "Collection CPU:  " << stats.averageCollectCpuMs << " ms (CPU " << stats.averageCollectorCpu.cpuMs
+        << ", Memory " << stats.averageCollectorCpu.memoryMs << ", GPU " << stats.averageCollectorCpu.gpuMs
+#ifdef _WIN32
+        << ", NPU " << stats.averageCollectorCpu.npuMs
+#endif
+        << ")\n";
+    out << "Output:          " << stats.averageOutputWallMs << " / " << stats.maxOutputWallMs << " ms wall, "
+        << stats.averageOutputCpuMs << " ms CPU\n";
+    out << "Process CPU:     " << stats.processCpuSeconds << " s over " << stats.wallSeconds << " s ("
+        << stats.processCpuPercent() << "% of one core)\n";
+    out << "RSS:             " << stats.averageRssKB / 1024.0 << " MB avg, " << stats.peakRssKB / 1024.0
+        << " MB peak\n";
+    if (stats.averageSyscalls > 0.0) {
+        out << "Syscalls:        " << stats.averageSyscalls << " per tick (read/write class)\n";
+    }
+    if (stats.budgetPercent > 0.0) {
+        out << "Budget:          " << stats.budgetPercent << "% of one core, exceeded on " << stats.overBudgetTicks
+            << " ticks\n";
+    }
+}
+
+void renderHistoryStats(std::ostream& out, const HistoryStats& stats) {
+    if (stats.footprintBytes == 0) return;
+    out << "\nRetained History\n";
+    out << "Full resolution: " << stats.rawSamples << " / " << stats.rawCapacity << " samples\n";
+    for (const auto& tier : stats.tiers) {
+        out << std::left << std::setw(17) << (bucketLabel(tier.bucketSeconds) + " buckets:") << std::right
+            << tier.buckets << " / " << tier.capacity << "\n";
+    }
+    out << "Footprint:       " << stats.footprintBytes / 1024.0 << " KB (fixed)\n";
+}
+
+// Bytes needed for a summary, so the buffer is allocated once
+std::size_t summaryReserveBytes(const SystemStats& stats) {
+    return 4096 + 96 * (stats.cpu.coreAverage.size() + stats.gpu.deviceAverage.size() + stats.history.tiers.size());
+}
+
+// Indented JSON; non-finite numbers become null
+class JsonSink {
+public:
+    explicit JsonSink(SummaryBuffer& out) : out_(out) { out_.append("{"); }
+
+    void beginObject(const char* key) { open(key, '{'); }
+    void endObject() { close('}'); }
+    void beginArray(const char* key) { open(key, '['); }
+    void endArray() { close(']'); }
+    void count(const char* key, uint64_t value) {
+        member(key);
+        out_.appendUint(value);
+    }
+    void number(const char* key, double value) {
+        member(key);
+        if (std::isfinite(value)) {
+            out_.appendDouble(value);
+        } else {
+            out_.append("null");
+        }
+    }
+    void text(const char* key, const std::string& value) {
+        member(key);
+        out_.append("\"");
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                char escaped[2] = {'\\', c};
+                out_.append(escaped, sizeof(escaped));
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out_.append(escaped, 6);
+            } else {
+                out_.append(&c, 1);
+            }
+        }
+        out_.append("\"");
+    }
+    void finish() {
+        close('}');
+        out_.append("\n");
+    }
+
+private:
+    static constexpr int kMaxDepth = 8;
+
+    // Separator, newline and indentation before a member; arrays pass a null key
+    void member(const char* key) {
+        if (!empty_[depth_]) out_.append(",");
+        empty_[depth_] = false;
+        indent(depth_ + 1);
+        if (key) {
+            out_.append("\"");
+            out_.append(key, std::strlen(key));
+            out_.append("\": ");
+        }
+    }
+    void open(const char* key, char bracket) {
+        member(key);
+        out_.append(&bracket, 1);
+        empty_[++depth_] = true;
+    }
+    void close(char bracket) {
+        if (!empty_[depth_]) indent(depth_);
+        --depth_;
+        out_.append(&bracket, 1);
+    }
+    void indent(int level) {
+        out_.append("\n");
+        for (int i = 0; i < level; ++i) out_.append("  ");
+    }
+
+    SummaryBuffer& out_;
+    bool empty_[kMaxDepth + 1] = {true};
+    int depth_ = 0;
+};
+
+// One line per value under a dotted key; array elements are keyed by index
+class FlatSink {
+public:
+    FlatSink(SummaryBuffer& out, char separator, bool csv) : out_(out), separator_(separator), csv_(csv) {
+        if (csv_) out_.append("key,value\n");
+    }
+
+    void beginObject(const char* key) { push(key, false); }
+    void endObject() { pop(); }
+    void beginArray(const char* key) { push(key, true); }
+    void endArray() { pop(); }
+    void count(const char* key, uint64_t value) {
+        line(key);
+        out_.appendUint(value);
+        out_.append("\n");
+    }
+    void number(const char* key, double value) {
+        line(key);
+        out_.appendDouble(value);
+        out_.append("\n");
+    }
+    void text(const char* key, const std::string& value) {
+        line(key);
+        if (csv_) out_.append("\"");
+        for (char c : value) {
+            if (c == '\n' || c == '\r') c = ' ';
+            out_.append(&c, 1);
+            if (csv_ && c == '"') out_.append(&c, 1);
+        }
+        if (csv_) out_.append("\"");
+        out_.append("\n");
+    }
+    void finish() {}
+
+private:
+    static constexpr int kMaxDepth = 8;
+
+    void push(const char* key, bool array) {
+        prefixLength_[depth_] = prefix_.size();
+        appendKey(key);
+        ++depth_;
+        isArray_[depth_] = array;
+        nextIndex_[depth_] = 0;
+    }
+    void pop() {
+        --depth_;
+        prefix_.resize(prefixLength_[depth_]);
+    }
+    void appendKey(const char* key) {
+        if (!prefix_.empty()) prefix_ += '.';
+        if (key) {
+            prefix_ += key;
+        } else if (isArray_[depth_]) {
+            char index[24];
+            auto result = std::to_chars(index, index + sizeof(index), nextIndex_[depth_]++);
+            prefix_.append(index, result.ptr);
+        }
+    }
+    void line(const char* key) {
+        std::size_t length = prefix_.size();
+        appendKey(key);
+        out_.append(prefix_);
+        out_.append(&separator_, 1);
+        prefix_.resize(length);
+    }
+
+    SummaryBuffer& out_;
+    char separator_;
+    bool csv_;
+    std::string prefix_; // Grows to the longest key once, then is reused
+    std::size_t prefixLength_[kMaxDepth + 1] = {};
+    bool isArray_[kMaxDepth + 1] = {};
+    std::size_t nextIndex_[kMaxDepth + 1] = {};
+    int depth_ = 0;
+};
+
+const char* const kPercentileKeys[4] = {"p50", "p90", "p99", "p999"};
+const char* const kUsedMBPercentileKeys[4] = {"used_mb_p50", "used_mb_p90", "used_mb_p99", "used_mb_p999"};
+const char* const kUsedPercentPercentileKeys[4] = {"used_percent_p50", "used_percent_p90", "used_percent_p99",
+                                                   "used_percent_p999"};
+
+template <typename Sink>
+void visitPercentiles(Sink& sink, const char* const (&keys)[4], const Percentiles& p) {
+    sink.number(keys[0], p.p50);
+    sink.number(keys[1], p.p90);
+    sink.number(keys[2], p.p99);
+    sink.number(keys[3], p.p999);
+}
+
+// The summary schema, walked once per output. The cpu, memory, gpu, npu and
+// process sections are present only when their source was sampled (see
+// SummarySections); every other key is always present. Bump
+// kSummarySchemaVersion whenever a key is renamed or removed. Version 2 made
+// those five sections optional.
+constexpr uint64_t kSummarySchemaVersion = 2;
+
+template <typename Sink>
+void visitSystemStats(const SystemStats& stats, Sink& sink) {
+    sink.count("schema_version", kSummarySchemaVersion);
+
+    const SummarySections& sections = stats.sections;
+    const CpuStats& cpu = stats.cpu;
+    if (sections.cpu) {
+        sink.beginObject("cpu");
+        sink.count("samples", cpu.samples);
+        sink.number("peak", cpu.peak);
+        sink.number("average", cpu.average);
+        sink.number("min", cpu.min);
+        sink.number("max", cpu.max);
+        sink.number("stddev", cpu.stddev);
+        visitPercentiles(sink, kPercentileKeys, cpu.percentiles);
+        sink.count("busiest_core", cpu.busiestCore);
+        sink.number("imbalance", cpu.imbalance);
+        sink.beginArray("cores");
+        for (std::size_t i = 0; i < cpu.coreAverage.size(); ++i) {
+            sink.beginObject(nullptr);
+            sink.number("average", cpu.coreAverage[i]);
+            sink.number("peak", cpu.corePeak[i]);
+            sink.endObject();
+        }
+        sink.endArray();
+        sink.endObject();
+    }
+
+    const MemoryStats& memory = stats.memory;
+    if (sections.memory) {
+        sink.beginObject("memory");
+        sink.count("samples", memory.samples);
+        sink.count("peak_used_mb", memory.peakUsedMB);
+        sink.count("avg_used_mb", memory.avgUsedMB);
+        sink.count("min_used_mb", memory.minUsedMB);
+        sink.count("max_used_mb", memory.maxUsedMB);
+        sink.number("stddev_used_mb", memory.stddevUsedMB);
+        visitPercentiles(sink, kUsedMBPercentileKeys, memory.usedMBPercentiles);
+        sink.number("peak_used_percent", memory.peakUsedPercent);
+        sink.number("avg_used_percent", memory.avgUsedPercent);
+        sink.number("min_used_percent", memory.minUsedPercent);
+        sink.number("max_used_percent", memory.maxUsedPercent);
+        sink.number("stddev_used_percent", memory.stddevUsedPercent);
+        visitPercentiles(sink, kUsedPercentPercentileKeys, memory.usedPercentPercentiles);
+        sink.endObject();
+    }
+
+    const GpuStats& gpu = stats.gpu;
+    if (sections.gpu) {
+        sink.beginObject("gpu");
+        sink.count("count", gpu.gpuCount);
+        sink.count("samples", gpu.samples);
+        sink.number("peak", gpu.peakUtilization);
+        sink.number("average", gpu.avgUtilization);
+        sink.number("min", gpu.minUtilization);
+        sink.number("max", gpu.maxUtilization);
+        sink.number("stddev", gpu.stddevUtilization);
+        visitPercentiles(sink, kPercentileKeys, gpu.percentiles);
+        sink.beginArray("devices");
+        for (std::size_t i = 0; i < gpu.deviceAverage.size(); ++i) {
+            sink.beginObject(nullptr);
+            sink.number("average", gpu.deviceAverage[i]);
+            sink.number("peak", gpu.devicePeak[i]);
+            sink.endObject();
+        }
+        sink.endArray();
+        sink.endObject();
+    }
+
+    const NpuStats& npu = stats.npu;
+    if (sections.npu) {
+        sink.beginObject("npu");
+        sink.text("name", npu.npuName);
+        sink.count("samples", npu.samples);
+        sink.number("peak", npu.peakUtilization);
+        sink.number("average", npu.avgUtilization);
+        sink.number("min", npu.minUtilization);
+        sink.number("max", npu.maxUtilization);
+        sink.number("stddev", npu.stddevUtilization);
+        visitPercentiles(sink, kPercentileKeys, npu.percentiles);
+        sink.endObject();
+    }
+
+    const ProcessStats& process = stats.process;
+    if (sections.process) {
+        sink.beginObject("process");
+        sink.text("name", process.name);
+        sink.count("samples", process.samples);
+        sink.count("peak_processes", process.peakProcesses);
+        sink.number("peak_cpu", process.peakCpu);
+        sink.number("avg_cpu", process.avgCpu);
+        sink.count("peak_rss_kb", process.peakRssKB);
+        sink.count("avg_rss_kb", process.avgRssKB);
+        sink.count("peak_pss_kb", process.peakPssKB);
+        sink.count("avg_pss_kb", process.avgPssKB);
+        sink.count("minor_faults", process.minorFaults);
+        sink.count("major_faults", process.majorFaults);
+        sink.count("read_bytes", process.readBytes);
+        sink.count("write_bytes", process.writeBytes);
+        sink.endObject();
+    }
+
+    const CommandStats& command = stats.command;
+    sink.beginObject("command");
+    sink.text("command", command.command);
+    sink.count("exit_code", static_cast<uint64_t>(command.exitCode));
+    sink.number("wall_seconds", command.wallSeconds);
+    sink.number("user_seconds", command.userSeconds);
+    sink.number("system_seconds", command.systemSeconds);
+    sink.count("max_rss_kb", command.maxRssKB);
+    sink.count("minor_faults", command.minorFaults);
+    sink.count("major_faults", command.majorFaults);
+    sink.count("voluntary_context_switches", command.voluntarySwitches);
+    sink.count("involuntary_context_switches", command.involuntarySwitches);
+    sink.count("block_input_ops", command.blockInputOps);
+    sink.count("block_output_ops", command.blockOutputOps);
+    sink.endObject();
+
+    const LatencyStats& latency = stats.latency;
+    sink.beginObject("collector_latency_ms");
+    sink.count("samples", latency.samples);
+    const CollectorLatency* rows[] = {&latency.average, &latency.max};
+    const char* rowKeys[] = {"average", "max"};
+    for (int r = 0; r < 2; ++r) {
+        sink.beginObject(rowKeys[r]);
+        sink.number("cpu", rows[r]->cpuMs);
+        sink.number("memory", rows[r]->memoryMs);
+        sink.number("gpu", rows[r]->gpuMs);
+        sink.number("npu", rows[r]->npuMs);
+        sink.endObject();
+    }
+    sink.endObject();
+
+    const TimingStats& timing = stats.timing;
+    sink.beginObject("timing");
+    sink.count("ticks", timing.ticks);
+    sink.number("interval_ms", timing.intervalMs);
+    sink.count("overruns", timing.overruns);
+    sink.count("skipped_ticks", timing.skippedTicks);
+    sink.number("mean_jitter_us", timing.meanJitterUs);
+    sink.number("max_jitter_us", timing.maxJitterUs);
+    sink.number("max_interval_ms", timing.maxIntervalMs);
+    sink.number("mean_interval_ms", timing.meanIntervalMs);
+    sink.number("samples_per_hour", timing.samplesPerHour);
+    sink.count("tightenings", timing.tightenings);
+    sink.endObject();
+
+    const OverheadStats& overhead = stats.overhead;
+    sink.beginObject("monitor_overhead");
+    sink.count("ticks", overhead.ticks);
+    sink.number("average_tick_cpu_ms", overhead.averageTickCpuMs);
+    sink.number("max_tick_cpu_ms", overhead.maxTickCpuMs);
+    sink.number("average_tick_cpu_percent", overhead.tickCpuPercent(overhead.averageTickCpuMs));
+    sink.number("average_collect_cpu_ms", overhead.averageCollectCpuMs);
+    sink.beginObject("collector_cpu_ms");
+    sink.number("cpu", overhead.averageCollectorCpu.cpuMs);
+    sink.number("memory", overhead.averageCollectorCpu.memoryMs);
+    sink.number("gpu", overhead.averageCollectorCpu.gpuMs);
+    sink.number("npu", overhead.averageCollectorCpu.npuMs);
+    sink.endObject();
+    sink.number("average_output_wall_ms", overhead.averageOutputWallMs);
+    sink.number("max_output_wall_ms", overhead.maxOutputWallMs);
+    sink.number("average_output_cpu_ms", overhead.averageOutputCpuMs);
+    sink.number("process_cpu_seconds", overhead.processCpuSeconds);
+    sink.number("wall_seconds", overhead.wallSeconds);
+    sink.number("process_cpu_percent", overhead.processCpuPercent());
+    sink.number("average_rss_kb", overhead.averageRssKB);
+    sink.count("peak_rss_kb", overhead.peakRssKB);
+    sink.number("average_syscalls", overhead.averageSyscalls);
+    sink.number("budget_percent", overhead.budgetPercent);
+    sink.count("over_budget_ticks", overhead.overBudgetTicks);
+    sink.endObject();
+
+    const HistoryStats& history = stats.history;
+    sink.beginObject("history");
+    sink.count("raw_samples", history.rawSamples);
+    sink.count("raw_capacity", history.rawCapacity);
+    sink.count("footprint_bytes", history.footprintBytes);
+    sink.beginArray("tiers");
+    for (const auto& tier : history.tiers) {
+        sink.beginObject(nullptr);
+        sink.number("bucket_seconds", tier.bucketSeconds);
+        sink.count("buckets", tier.buckets);
+        sink.count("capacity", tier.capacity);
+        sink.endObject();
+    }
+    sink.endArray();
+    sink.endObject();
+
+    sink.finish();
+}
+
+// Writes a sibling temporary file and renames it over path, which replaces
+// the previous contents in one step on both POSIX and Windows
+bool writeFileAtomically(const std::string& path, const char* data, std::size_t size) {
+    std::string temp = path + ".tmp";
+#ifdef _WIN32
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(data, 1, size, file) == size;
+    ok = std::fclose(file) == 0 && ok;
+    if (ok) ok = MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = true;
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    ok = ok && fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (ok) ok = std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) std::remove(temp.c_str());
+    return ok;
+}
+}
+
+bool parseOutputFormat(const std::string& name, OutputFormat& format) {
+    if (name == "text") {
+        format = OutputFormat::Text;
+    } else if (name == "json") {
+        format = OutputFormat::Json;
+    } else if (name == "csv") {
+        format = OutputFormat::Csv;
+    } else if (name == "kv") {
+        format = OutputFormat::Kv;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void SummaryBuffer::appendUint(uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+void SummaryBuffer::appendDouble(double value) {
+    char digits[32];
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(digits, static_cast<std::size_t>(result.ptr - digits));
+#else
+    // Older libc++ has no floating-point to_chars; 17 significant digits still round-trip
+    int length = std::snprintf(digits, sizeof(digits), "%.17g", value);
+    append(digits, static_cast<std::size_t>(length));
+#endif
+}
 
 void printCpuStatsToConsole(const CpuStats& stats) {
     std::cout << "\n--- CPU Usage Statistics ---\n";
@@ -10,17 +627,21 @@ void printCpuStatsToConsole(const CpuStats& stats) {
     std::cout << "Average: " << std::fixed << std::setprecision(1) << stats.average << "%" << std::endl;
     std::cout << "Min:     " << std::fixed << std::setprecision(1) << stats.min << "%" << std::endl;
     std::cout << "Max:     " << std::fixed << std::setprecision(1) << stats.max << "%" << std::endl;
+    std::cout << "StdDev:  " << std::fixed << std::setprecision(1) << stats.stddev << "%" << std::endl;
+    std::cout << "P50/P90/P99/P99.9: " << std::fixed << std::setprecision(1) << stats.percentiles << "%" << std::endl;
+    if (!stats.coreAverage.empty()) {
+        std::cout << "Cores:   " << stats.coreAverage.size() << std::endl;
+        std::cout << "Busiest: core " << stats.busiestCore
+                  << " (avg " << std::fixed << std::setprecision(1) << stats.coreAverage[stats.busiestCore]
+                  << "%, peak " << stats.corePeak[stats.busiestCore] << "%)" << std::endl;
+        std::cout << "Imbalance: " << std::fixed << std::setprecision(1) << stats.imbalance << " pp" << std::endl;
+    }
 }
 
 void writeCpuStatsToFile(const CpuStats& stats, const std::string& path) {
     std::ofstream out(path);
     if (out) {
-        out << "CPU Usage Statistics\n";
-        out << "Samples: " << stats.samples << "\n";
-        out << "Peak:    " << stats.peak << "%\n";
-        out << "Average: " << stats.average << "%\n";
-        out << "Min:     " << stats.min << "%\n";
-        out << "Max:     " << stats.max << "%\n";
+        renderCpuStats(out, stats);
         out.close();
         std::cout << "Results written to " << path << std::endl;
     } else {
@@ -35,17 +656,14 @@ void printMemoryStatsToConsole(const MemoryStats& stats) {
     std::cout << "Avg Used:    " << stats.avgUsedMB << " MB (" << std::fixed << std::setprecision(1) << stats.avgUsedPercent << "%)" << std::endl;
     std::cout << "Min Used:    " << stats.minUsedMB << " MB (" << std::fixed << std::setprecision(1) << stats.minUsedPercent << "%)" << std::endl;
     std::cout << "Max Used:    " << stats.maxUsedMB << " MB (" << std::fixed << std::setprecision(1) << stats.maxUsedPercent << "%)" << std::endl;
+    std::cout << "StdDev:      " << std::fixed << std::setprecision(1) << stats.stddevUsedMB << " MB (" << stats.stddevUsedPercent << "%)" << std::endl;
+    std::cout << "P50/P90/P99/P99.9: " << std::fixed << std::setprecision(0) << stats.usedMBPercentiles << " MB" << std::endl;
 }
 
 void writeMemoryStatsToFile(const MemoryStats& stats, const std::string& path) {
     std::ofstream out(path, std::ios::app); // Append mode
     if (out) {
-        out << "\nMemory Usage Statistics\n";
-        out << "Samples:     " << stats.samples << "\n";
-        out << "Peak Used:   " << stats.peakUsedMB << " MB (" << stats.peakUsedPercent << "%)\n";
-        out << "Avg Used:    " << stats.avgUsedMB << " MB (" << stats.avgUsedPercent << "%)\n";
-        out << "Min Used:    " << stats.minUsedMB << " MB (" << stats.minUsedPercent << "%)\n";
-        out << "Max Used:    " << stats.maxUsedMB << " MB (" << stats.maxUsedPercent << "%)\n";
+        renderMemoryStats(out, stats);
         out.close();
     } else {
         std::cerr << "Failed to write memory stats to " << path << std::endl;
@@ -60,18 +678,14 @@ void printGpuStatsToConsole(const GpuStats& stats) {
     std::cout << "Avg GPU:         " << std::fixed << std::setprecision(1) << stats.avgUtilization << "%" << std::endl;
     std::cout << "Min GPU:         " << std::fixed << std::setprecision(1) << stats.minUtilization << "%" << std::endl;
     std::cout << "Max GPU:         " << std::fixed << std::setprecision(1) << stats.maxUtilization << "%" << std::endl;
+    std::cout << "StdDev GPU:      " << std::fixed << std::setprecision(1) << stats.stddevUtilization << "%" << std::endl;
+    std::cout << "P50/P90/P99/P99.9: " << std::fixed << std::setprecision(1) << stats.percentiles << "%" << std::endl;
 }
 
 void writeGpuStatsToFile(const GpuStats& stats, const std::string& path) {
     std::ofstream out(path, std::ios::app); // Append mode
     if (out) {
-        out << "\nGPU Usage Statistics\n";
-        out << "GPUs Found:      " << stats.gpuCount << "\n";
-        out << "Samples:         " << stats.samples << "\n";
-        out << "Peak GPU:        " << stats.peakUtilization << "%\n";
-        out << "Avg GPU:         " << stats.avgUtilization << "%\n";
-        out << "Min GPU:         " << stats.minUtilization << "%\n";
-        out << "Max GPU:         " << stats.maxUtilization << "%\n";
+        renderGpuStats(out, stats);
         out.close();
     } else {
         std::cerr << "Failed to write GPU stats to " << path << std::endl;
@@ -87,6 +701,8 @@ void printNpuStatsToConsole(const NpuStats& stats) {
         std::cout << "Avg NPU:         " << std::fixed << std::setprecision(1) << stats.avgUtilization << "%" << std::endl;
         std::cout << "Min NPU:         " << std::fixed << std::setprecision(1) << stats.minUtilization << "%" << std::endl;
         std::cout << "Max NPU:         " << std::fixed << std::setprecision(1) << stats.maxUtilization << "%" << std::endl;
+        std::cout << "StdDev NPU:      " << std::fixed << std::setprecision(1) << stats.stddevUtilization << "%" << std::endl;
+        std::cout << "P50/P90/P99/P99.9: " << std::fixed << std::setprecision(1) << stats.percentiles << "%" << std::endl;
     } else {
         std::cout << "\n--- NPU Usage Statistics ---\n";
         std::cout << "NPU:             " << (stats.npuName.empty() ? "Not available" : stats.npuName) << std::endl;
@@ -97,35 +713,237 @@ void printNpuStatsToConsole(const NpuStats& stats) {
 void writeNpuStatsToFile(const NpuStats& stats, const std::string& path) {
     std::ofstream out(path, std::ios::app); // Append mode
     if (out) {
-        out << "\nNPU Usage Statistics\n";
-        out << "NPU:             " << (stats.npuName.empty() ? "Not available" : stats.npuName) << "\n";
-        out << "Samples:         " << stats.samples << "\n";
-        if (stats.samples > 0) {
-            out << "Peak NPU:        " << stats.peakUtilization << "%\n";
-            out << "Avg NPU:         " << stats.avgUtilization << "%\n";
-            out << "Min NPU:         " << stats.minUtilization << "%\n";
-            out << "Max NPU:         " << stats.maxUtilization << "%\n";
-        }
+        renderNpuStats(out, stats);
         out.close();
     } else {
         std::cerr << "Failed to write NPU stats to " << path << std::endl;
     }
 }
 
-void printSystemStatsToConsole(const SystemStats& stats) {
-    printCpuStatsToConsole(stats.cpu);
-    printMemoryStatsToConsole(stats.memory);
-    printGpuStatsToConsole(stats.gpu);
+void printProcessStatsToConsole(const ProcessStats& stats) {
+    if (stats.samples == 0) return;
+    std::cout << "\n--- Process Usage Statistics ---\n";
+    std::cout << "Application:     " << stats.name << " (" << stats.peakProcesses << " processes at peak)" << std::endl;
+    std::cout << "Samples:         " << stats.samples << std::endl;
+    std::cout << "Peak CPU:        " << std::fixed << std::setprecision(1) << stats.peakCpu << "%" << std::endl;
+    std::cout << "Avg CPU:         " << std::fixed << std::setprecision(1) << stats.avgCpu << "%" << std::endl;
+    std::cout << "Peak RSS:        " << std::fixed << std::setprecision(1) << stats.peakRssKB / 1024.0 << " MB (PSS "
+              << stats.peakPssKB / 1024.0 << " MB)" << std::endl;
+    std::cout << "Avg RSS:         " << std::fixed << std::setprecision(1) << stats.avgRssKB / 1024.0 << " MB (PSS "
+              << stats.avgPssKB / 1024.0 << " MB)" << std::endl;
+    std::cout << "Page Faults:     " << stats.minorFaults << " minor, " << stats.majorFaults << " major" << std::endl;
+    std::cout << "Disk I/O:        " << std::fixed << std::setprecision(1) << stats.readBytes / 1048576.0 << " MB read, "
+              << stats.writeBytes / 1048576.0 << " MB written" << std::endl;
+}
+
+void writeProcessStatsToFile(const ProcessStats& stats, const std::string& path) {
+    if (stats.samples == 0) return;
+    std::ofstream out(path, std::ios::app); // Append mode
+    if (out) {
+        renderProcessStats(out, stats);
+        out.close();
+    } else {
+        std::cerr << "Failed to write process stats to " << path << std::endl;
+    }
+}
+
+void printCommandStatsToConsole(const CommandStats& stats) {
+    if (stats.command.empty()) return;
+    std::cout << "\n--- Command Resource Totals ---\n";
+    std::cout << "Command:         " << stats.command << std::endl;
+    std::cout << "Exit Code:       " << stats.exitCode << std::endl;
+    std::cout << "Wall Time:       " << std::fixed << std::setprecision(3) << stats.wallSeconds << " s" << std::endl;
+    std::cout << "CPU Time:        " << std::fixed << std::setprecision(3) << stats.userSeconds << " s user, "
+              << stats.systemSeconds << " s system" << std::endl;
+    std::cout << "Max RSS:         " << std::fixed << std::setprecision(1) << stats.maxRssKB / 1024.0 << " MB" << std::endl;
+    std::cout << "Page Faults:     " << stats.minorFaults << " minor, " << stats.majorFaults << " major" << std::endl;
+    std::cout << "Context Switches: " << stats.voluntarySwitches << " voluntary, " << stats.involuntarySwitches
+              << " involuntary" << std::endl;
+    std::cout << "Block I/O:       " << stats.blockInputOps << " in, " << stats.blockOutputOps << " out" << std::endl;
+}
+
+void writeCommandStatsToFile(const CommandStats& stats, const std::string& path) {
+    if (stats.command.empty()) return;
+    std::ofstream out(path, std::ios::app); // Append mode
+    if (out) {
+        renderCommandStats(out, stats);
+        out.close();
+    } else {
+        std::cerr << "Failed to write command totals to " << path << std::endl;
+    }
+}
+
+void printLatencyStatsToConsole(const LatencyStats& stats) {
+    if (stats.samples == 0) return;
+    std::cout << "\n--- Collector Latency (avg / max) ---\n";
+    std::cout << "CPU:             " << std::fixed << std::setprecision(2) << stats.average.cpuMs << " / " << stats.max.cpuMs << " ms" << std::endl;
+    std::cout << "Memory:          " << std::fixed << std::setprecision(2) << stats.average.memoryMs << " / " << stats.max.memoryMs << " ms" << std::endl;
+    std::cout << "GPU:             " << std::fixed << std::setprecision(2) << stats.average.gpuMs << " / " << stats.max.gpuMs << " ms" << std::endl;
 #ifdef _WIN32
-    printNpuStatsToConsole(stats.npu);
+    std::cout << "NPU:             " << std::fixed << std::setprecision(2) << stats.average.npuMs << " / " << stats.max.npuMs << " ms" << std::endl;
 #endif
 }
 
-void writeSystemStatsToFile(const SystemStats& stats, const std::string& path) {
-    writeCpuStatsToFile(stats.cpu, path);
-    writeMemoryStatsToFile(stats.memory, path);
-    writeGpuStatsToFile(stats.gpu, path);
+void writeLatencyStatsToFile(const LatencyStats& stats, const std::string& path) {
+    if (stats.samples == 0) return;
+    std::ofstream out(path, std::ios::app); // Append mode
+    if (out) {
+        renderLatencyStats(out, stats);
+        out.close();
+    } else {
+        std::cerr << "Failed to write collector latency to " << path << std::endl;
+    }
+}
+
+void printTimingStatsToConsole(const TimingStats& stats) {
+    if (stats.ticks == 0) return;
+    std::cout << "\n--- Sampling Timing ---\n";
+    std::cout << "Ticks:           " << stats.ticks << std::endl;
+    if (stats.maxIntervalMs > 0.0) {
+        std::cout << "Interval:        adaptive " << std::fixed << std::setprecision(0) << stats.intervalMs << "-"
+                  << stats.maxIntervalMs << " ms (avg " << std::setprecision(1) << stats.meanIntervalMs << " ms)"
+                  << std::endl;
+        std::cout << "Samples/hour:    " << std::setprecision(0) << stats.samplesPerHour << " (" << stats.tightenings
+                  << " tightenings)" << std::endl;
+    } else {
+        std::cout << "Interval:        " << std::fixed << std::setprecision(1) << stats.intervalMs << " ms"
+                  << std::endl;
+    }
+    std::cout << "Overruns:        " << stats.overruns << " (" << stats.skippedTicks << " ticks skipped)" << std::endl;
+    std::cout << "Jitter:          " << std::fixed << std::setprecision(1) << stats.meanJitterUs << " us avg, "
+              << stats.maxJitterUs << " us max" << std::endl;
+}
+
+void writeTimingStatsToFile(const TimingStats& stats, const std::string& path) {
+    if (stats.ticks == 0) return;
+    std::ofstream out(path, std::ios::app); // Append mode
+    if (out) {
+        renderTimingStats(out, stats);
+        out.close();
+    } else {
+        std::cerr << "Failed to write sampling timing to " << path << std::endl;
+    }
+}
+
+void printOverheadStatsToConsole(const OverheadStats& stats) {
+    if (stats.ticks == 0) return;
+    std::cout << "\n--- Monitor Overhead (thread CPU per tick) ---\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Tick CPU:        " << stats.averageTickCpuMs << " / " << stats.maxTickCpuMs << " ms ("
+              << stats.tickCpuPercent(stats.averageTickCpuMs) << "% of one core)" << std::endl;
+    std::cout << "Collection CPU:  " << stats.averageCollectCpuMs << " ms (CPU " << stats.averageCollectorCpu.cpuMs
+              << ", Memory " << stats.averageCollectorCpu.memoryMs << ", GPU " << stats.averageCollectorCpu.gpuMs
 #ifdef _WIN32
-    writeNpuStatsToFile(stats.npu, path);
+              << ", NPU " << stats.averageCollectorCpu.npuMs
 #endif
-} 
\ No newline at end of file
+              << ")" << std::endl;
+    std::cout << "Output:          " << stats.averageOutputWallMs << " / " << stats.maxOutputWallMs << " ms wall, "
+              << stats.averageOutputCpuMs << " ms CPU" << std::endl;
+    std::cout << "Process CPU:     " << stats.processCpuSeconds << " s over " << std::setprecision(1)
+              << stats.wallSeconds << " s (" << std::setprecision(3) << stats.processCpuPercent() << "% of one core)"
+              << std::endl;
+    std::cout << "RSS:             " << std::setprecision(1) << stats.averageRssKB / 1024.0 << " MB avg, "
+              << stats.peakRssKB / 1024.0 << " MB peak" << std::endl;
+    if (stats.averageSyscalls > 0.0) {
+        std::cout << "Syscalls:        " << stats.averageSyscalls << " per tick (read/write class)" << std::endl;
+    }
+    if (stats.budgetPercent > 0.0) {
+        std::cout << "Budget:          " << std::setprecision(2) << stats.budgetPercent << "% of one core, exceeded on "
+                  << stats.overBudgetTicks << " ticks" << std::endl;
+    }
+}
+
+void writeOverheadStatsToFile(const OverheadStats& stats, const std::string& path) {
+    if (stats.ticks == 0) return;
+    std::ofstream out(path, std::ios::app); // Append mode
+    if (out) {
+        renderOverheadStats(out, stats);
+        out.close();
+    } else {
+        std::cerr << "Failed to write monitor overhead to " << path << std::endl;
+    }
+}
+
+void printHistoryStatsToConsole(const HistoryStats& stats) {
+    if (stats.footprintBytes == 0) return;
+    std::cout << "\n--- Retained History ---\n";
+    std::cout << "Full resolution: " << stats.rawSamples << " / " << stats.rawCapacity << " samples" << std::endl;
+    for (const auto& tier : stats.tiers) {
+        std::cout << std::left << std::setw(17) << (bucketLabel(tier.bucketSeconds) + " buckets:") << std::right
+                  << tier.buckets << " / " << tier.capacity << std::endl;
+    }
+    std::cout << "Footprint:       " << std::fixed << std::setprecision(1)
+              << stats.footprintBytes / 1024.0 << " KB (fixed)" << std::endl;
+}
+
+void writeHistoryStatsToFile(const HistoryStats& stats, const std::string& path) {
+    if (stats.footprintBytes == 0) return;
+    std::ofstream out(path, std::ios::app); // Append mode
+    if (out) {
+        renderHistoryStats(out, stats);
+        out.close();
+    } else {
+        std::cerr << "Failed to write retained history to " << path << std::endl;
+    }
+}
+
+void formatSystemStats(const SystemStats& stats, OutputFormat format, SummaryBuffer& out) {
+    out.clear();
+    switch (format) {
+    case OutputFormat::Json: {
+        JsonSink sink(out);
+        visitSystemStats(stats, sink);
+        break;
+    }
+    case OutputFormat::Csv: {
+        FlatSink sink(out, ',', true);
+        visitSystemStats(stats, sink);
+        break;
+    }
+    case OutputFormat::Kv: {
+        FlatSink sink(out, '=', false);
+        visitSystemStats(stats, sink);
+        break;
+    }
+    case OutputFormat::Text: {
+        // The human-readable report keeps its iostream formatting, but all
+        // sections are still rendered once and written in a single step
+        std::ostringstream text;
+        if (stats.sections.cpu) renderCpuStats(text, stats.cpu);
+        if (stats.sections.memory) renderMemoryStats(text, stats.memory);
+        if (stats.sections.gpu) renderGpuStats(text, stats.gpu);
+        if (stats.sections.npu) renderNpuStats(text, stats.npu);
+        if (stats.sections.process) renderProcessStats(text, stats.process);
+        renderCommandStats(text, stats.command);
+        renderLatencyStats(text, stats.latency);
+        renderTimingStats(text, stats.timing);
+        renderOverheadStats(text, stats.overhead);
+        renderHistoryStats(text, stats.history);
+        out.append(text.str());
+        break;
+    }
+    }
+}
+
+void printSystemStatsToConsole(const SystemStats& stats) {
+    if (stats.sections.cpu) printCpuStatsToConsole(stats.cpu);
+    if (stats.sections.memory) printMemoryStatsToConsole(stats.memory);
+    if (stats.sections.gpu) printGpuStatsToConsole(stats.gpu);
+    if (stats.sections.npu) printNpuStatsToConsole(stats.npu);
+    if (stats.sections.process) printProcessStatsToConsole(stats.process);
+    printCommandStatsToConsole(stats.command);
+    printLatencyStatsToConsole(stats.latency);
+    printTimingStatsToConsole(stats.timing);
+    printOverheadStatsToConsole(stats.overhead);
+    printHistoryStatsToConsole(stats.history);
+}
+
+void writeSystemStatsToFile(const SystemStats& stats, const std::string& path, OutputFormat format) {
+    SummaryBuffer out(summaryReserveBytes(stats));
+    formatSystemStats(stats, format, out);
+    if (writeFileAtomically(path, out.data(), out.size())) {
+        std::cout << "Results written to " << path << std::endl;
+    } else {
+        std::cerr << "Failed to write to " << path << std::endl;
+    }
+}
@@ -0,0 +1,192 @@
+#include "utils/proc_reader.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+bool parsePidStat(const char* p, const char* end, PidStat& stat) {
+    const char* q = end;
+    while (q > p && q[-1] != ')') --q;
+    if (q == p) return false;
+    const char* open = p;
+    while (open < q && *open != '(') ++open;
+    if (open < q) {
+        stat.name = open + 1;
+        stat.nameLength = static_cast<std::size_t>(q - 1 - stat.name);
+    }
+    q = procscan::skipSpaces(q, end);
+    if (q >= end) return false;
+    stat.state = *q++;
+    for (int field = 4; field <= 24; ++field) {
+        q = procscan::skipSpaces(q, end);
+        // tpgid, priority and nice may be negative; none of them is kept
+        if (q < end && *q == '-') ++q;
+        uint64_t value = 0;
+        q = procscan::parseUint64(q, end, value);
+        if (!q) return false;
+        switch (field) {
+        case 4: stat.parent = static_cast<int>(value); break;
+        case 10: stat.minorFaults = value; break;
+        case 12: stat.majorFaults = value; break;
+        case 14: stat.userTicks = value; break;
+        case 15: stat.systemTicks = value; break;
+        case 22: stat.startTime = value; break;
+        case 24: stat.rssPages = value; break;
+        default: break;
+        }
+    }
+    return true;
+}
+
+bool parseAggregateCpuTicks(const char* p, const char* end, uint64_t& total) {
+    if (!procscan::startsWith(p, end, "cpu ", 4)) return false;
+    p += 4;
+    total = 0;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t value = 0;
+        const char* next = procscan::parseUint64(p, end, value);
+        if (!next) break;
+        total += value;
+        p = next;
+    }
+    return true;
+}
+
+std::size_t countCpuLines(const char* p, const char* end) {
+    std::size_t cpus = 0;
+    p = procscan::skipToNextLine(p, end);
+    while (p < end && procscan::startsWith(p, end, "cpu", 3)) {
+        ++cpus;
+        p = procscan::skipToNextLine(p, end);
+    }
+    return cpus;
+}
+
+#ifndef _WIN32
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = other.fd_;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+bool ProcFile::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    return fd_ >= 0;
+}
+
+void ProcFile::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+long ProcFile::readAll(char* buf, std::size_t size) const {
+    if (fd_ < 0 || size == 0) return -1;
+    std::size_t total = 0;
+    // procfs may hand out the contents in several short reads
+    while (total < size - 1) {
+        ssize_t n = ::pread(fd_, buf + total, size - 1 - total, static_cast<off_t>(total));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) break;
+        total += static_cast<std::size_t>(n);
+    }
+    buf[total] = '\0';
+    return static_cast<long>(total);
+}
+
+long ProcFile::readAll(std::vector<char>& buf) const {
+    if (buf.size() < 4096) buf.resize(4096);
+    while (true) {
+        long len = readAll(buf.data(), buf.size());
+        if (len < 0 || static_cast<std::size_t>(len) + 1 < buf.size()) return len;
+        buf.resize(buf.size() * 2);
+    }
+}
+#endif
+
+#ifdef __linux__
+namespace {
+// Layout returned by getdents64; glibc only exposes it through readdir
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+}
+
+bool ProcDirectory::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    return fd_ >= 0;
+}
+
+void ProcDirectory::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool ProcDirectory::listPids(std::vector<int>& pids) {
+    pids.clear();
+    if (fd_ < 0 || lseek(fd_, 0, SEEK_SET) != 0) return false;
+    while (true) {
+        long n = syscall(SYS_getdents64, fd_, buffer_, sizeof(buffer_));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return true;
+        for (long offset = 0; offset < n;) {
+            const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer_ + offset);
+            offset += entry->d_reclen;
+            const char* name = entry->d_name;
+            if (*name < '1' || *name > '9') continue;
+            int pid = 0;
+            while (*name >= '0' && *name <= '9') pid = pid * 10 + (*name++ - '0');
+            if (*name == '\0') pids.push_back(pid);
+        }
+    }
+}
+
+bool PidAllocationWatch::allocatedSinceLastCheck() {
+    rangeKnown_ = false;
+    long len = loadavg_.readAll(buffer_, sizeof(buffer_));
+    if (len <= 0) return true;
+    // "0.00 0.01 0.05 1/123 45678"
+    const char* end = buffer_ + len;
+    const char* p = end;
+    while (p > buffer_ && (p[-1] == '\n' || p[-1] == ' ')) --p;
+    while (p > buffer_ && p[-1] != ' ') --p;
+    uint64_t pid = 0;
+    if (!procscan::parseUint64(p, end, pid)) return true;
+    bool allocated = pid != lastPid_;
+    previousPid_ = lastPid_;
+    rangeKnown_ = lastPid_ != 0;
+    lastPid_ = pid;
+    return allocated;
+}
+
+bool PidAllocationWatch::mayHaveAllocated(int pid) const {
+    if (!rangeKnown_ || pid <= 0) return false;
+    uint64_t value = static_cast<uint64_t>(pid);
+    if (lastPid_ >= previousPid_) return value > previousPid_ && value <= lastPid_;
+    return value > previousPid_ || value <= lastPid_; // The counter wrapped
+}
+#endif
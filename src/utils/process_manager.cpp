@@ -2,11 +2,29 @@
 #include <cstdlib>
 #include <string>
 #include <algorithm>
+#include <vector>
 
 #ifdef _WIN32
     #include <windows.h>
     #include <tlhelp32.h>
 #endif
+#ifdef __linux__
+    #include <dirent.h>
+    #include <poll.h>
+    #include <sys/syscall.h>
+#endif
+#ifndef _WIN32
+    #include <cerrno>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <spawn.h>
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+
+extern char** environ;
+#endif
 
 void launchApp(const std::string& appName) {
     if (appName.empty()) {
@@ -67,10 +85,234 @@ bool isAppRunning(const std::string& appName) {
 
     CloseHandle(hProcessSnap);
     return found;
+#elif defined(__linux__)
+    // Linux: Scan /proc directly instead of forking a shell and pgrep
+    return !findProcessIds(appName).empty();
 #else
-    // macOS/Linux: Use pgrep
+    // macOS: Use pgrep
     std::string pgrepCmd = "pgrep -x '" + appName + "' > /dev/null";
     int ret = system(pgrepCmd.c_str());
     return ret == 0;
 #endif
-} 
\ No newline at end of file
+}
+
+std::vector<int> findProcessIds(const std::string& appName, const std::string& procRoot) {
+    std::vector<int> pids;
+#ifdef __linux__
+    if (appName.empty()) return pids;
+    // The kernel keeps only the first 15 characters of the name
+    const std::string name = appName.substr(0, 15);
+    DIR* dir = opendir(procRoot.c_str());
+    if (!dir) return pids;
+    std::string path;
+    // pid, "(name)" and the state all fit; the fields after it contain no ')'
+    char stat[128];
+    while (dirent* entry = readdir(dir)) {
+        const char* id = entry->d_name;
+        if (*id < '1' || *id > '9') continue;
+        path.assign(procRoot).append("/").append(id).append("/stat");
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue; // Exited between readdir and open
+        ssize_t len = read(fd, stat, sizeof(stat));
+        close(fd);
+        if (len <= 0) continue;
+        // stat reads "<pid> (<name>) <state> ..."; the name may itself contain ')'
+        const char* nameBegin = static_cast<const char*>(std::memchr(stat, '(', static_cast<size_t>(len)));
+        const char* nameEnd = stat + len;
+        while (nameEnd > stat && nameEnd[-1] != ')') --nameEnd;
+        if (!nameBegin || nameEnd <= nameBegin + 1 || nameEnd + 1 >= stat + len) continue;
+        ++nameBegin;
+        --nameEnd; // At the closing ')'
+        size_t nameLength = static_cast<size_t>(nameEnd - nameBegin);
+        char state = nameEnd[2];
+        if (state == 'Z' || state == 'X') continue; // Exited, waiting to be reaped
+        if (nameLength == name.size() && name.compare(0, name.size(), nameBegin, nameLength) == 0) {
+            pids.push_back(std::atoi(id));
+        }
+    }
+    closedir(dir);
+    std::sort(pids.begin(), pids.end());
+#else
+    (void)appName;
+    (void)procRoot;
+#endif
+    return pids;
+}
+
+AppWatcher::AppWatcher(const std::string& appName) : appName_(appName) {}
+
+AppWatcher::~AppWatcher() {
+    closePidfds();
+}
+
+bool AppWatcher::isRunning() {
+#ifdef __linux__
+    if (pids_.empty()) {
+        rescan();
+        return !pids_.empty();
+    }
+    bool exited = false;
+    pollfd fds[64];
+    for (size_t start = 0; start < pids_.size() && !exited; start += 64) {
+        size_t count = std::min<size_t>(pids_.size() - start, 64);
+        nfds_t watched = 0;
+        for (size_t i = start; i < start + count; ++i) {
+            if (pidfds_[i] >= 0) {
+                fds[watched].fd = pidfds_[i];
+                fds[watched].events = POLLIN;
+                fds[watched].revents = 0;
+                ++watched;
+            } else if (kill(pids_[i], 0) != 0 && errno == ESRCH) {
+                exited = true;
+            }
+        }
+        // A pidfd becomes readable once its process has exited
+        if (!exited && watched > 0 && poll(fds, watched, 0) > 0) {
+            exited = true;
+        }
+    }
+    if (exited) rescan();
+    return !pids_.empty();
+#else
+    return isAppRunning(appName_);
+#endif
+}
+
+void AppWatcher::rescan() {
+    closePidfds();
+    pids_ = findProcessIds(appName_);
+    ++generation_;
+#ifdef __linux__
+    pidfds_.assign(pids_.size(), -1);
+#ifdef SYS_pidfd_open
+    for (size_t i = 0; i < pids_.size(); ++i) {
+        pidfds_[i] = static_cast<int>(syscall(SYS_pidfd_open, pids_[i], 0));
+    }
+#endif
+#endif
+}
+
+void AppWatcher::closePidfds() {
+#ifdef __linux__
+    for (int fd : pidfds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+    pidfds_.clear();
+}
+
+#ifndef _WIN32
+namespace {
+// Self-pipe for kernels without pidfd_open; the handler only writes one byte
+int sigchldPipe[2] = {-1, -1};
+
+void onSigchld(int) {
+    int saved = errno;
+    char byte = 1;
+    ssize_t ignored = write(sigchldPipe[1], &byte, 1);
+    (void)ignored;
+    errno = saved;
+}
+
+bool installSigchldPipe() {
+    if (sigchldPipe[0] >= 0) return true;
+    if (pipe(sigchldPipe) != 0) return false;
+    for (int fd : sigchldPipe) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    struct sigaction action = {};
+    action.sa_handler = onSigchld;
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&action.sa_mask);
+    return sigaction(SIGCHLD, &action, nullptr) == 0;
+}
+
+double seconds(const timeval& tv) {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+}
+}
+#endif
+
+ChildProcess::~ChildProcess() {
+#ifndef _WIN32
+    if (ownsExitFd_) close(exitFd_);
+#endif
+}
+
+bool ChildProcess::start(const std::vector<std::string>& command) {
+    if (command.empty()) {
+        error_ = "no command given";
+        return false;
+    }
+#ifdef _WIN32
+    error_ = "running a command is not supported on Windows";
+    return false;
+#else
+    std::vector<char*> argv;
+    argv.reserve(command.size() + 1);
+    for (const auto& arg : command) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    // Installed before spawning, so an immediate exit is never missed when pidfds are unavailable
+    if (!installSigchldPipe()) {
+        error_ = std::string("cannot watch for child exit: ") + std::strerror(errno);
+        return false;
+    }
+    pid_t pid = -1;
+    int rc = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+    if (rc != 0) {
+        error_ = std::string("cannot run ") + command[0] + ": " + std::strerror(rc);
+        return false;
+    }
+    started_ = std::chrono::steady_clock::now();
+    pid_ = pid;
+    stats_.command = command[0];
+    for (std::size_t i = 1; i < command.size(); ++i) stats_.command += " " + command[i];
+
+    exitFd_ = -1;
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    exitFd_ = static_cast<int>(syscall(SYS_pidfd_open, pid_, 0));
+    ownsExitFd_ = exitFd_ >= 0;
+#endif
+    if (exitFd_ < 0) exitFd_ = sigchldPipe[0];
+    return true;
+#endif
+}
+
+const CommandStats& ChildProcess::wait() {
+#ifndef _WIN32
+    if (!isRunning()) return stats_;
+    int status = 0;
+    rusage usage = {};
+    pid_t reaped;
+    do {
+        reaped = wait4(pid_, &status, 0, &usage);
+    } while (reaped < 0 && errno == EINTR);
+    int waitErrno = errno;
+    stats_.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    reaped_ = true;
+    if (reaped != pid_) {
+        // The status is lost (e.g. someone else reaped the child), so do not report success
+        error_ = std::string("cannot wait for ") + stats_.command + ": " + std::strerror(waitErrno);
+        stats_.exitCode = 1;
+        return stats_;
+    }
+
+    stats_.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    stats_.userSeconds = seconds(usage.ru_utime);
+    stats_.systemSeconds = seconds(usage.ru_stime);
+#ifdef __APPLE__
+    stats_.maxRssKB = static_cast<uint64_t>(usage.ru_maxrss) / 1024; // Bytes on macOS
+#else
+    stats_.maxRssKB = static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+    stats_.minorFaults = static_cast<uint64_t>(usage.ru_minflt);
+    stats_.majorFaults = static_cast<uint64_t>(usage.ru_majflt);
+    stats_.voluntarySwitches = static_cast<uint64_t>(usage.ru_nvcsw);
+    stats_.involuntarySwitches = static_cast<uint64_t>(usage.ru_nivcsw);
+    stats_.blockInputOps = static_cast<uint64_t>(usage.ru_inblock);
+    stats_.blockOutputOps = static_cast<uint64_t>(usage.ru_oublock);
+#endif
+    return stats_;
+}
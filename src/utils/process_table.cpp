@@ -0,0 +1,200 @@
+#include "utils/process_table.hpp"
+
+#ifdef __linux__
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+ProcessTable::ProcessTable(const std::string& procRoot, std::size_t maxOpenFiles)
+    : maxOpenFiles_(maxOpenFiles), pageKB_(static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024) {
+    dir_.open(procRoot);
+    statFile_.open(procRoot + "/stat");
+    allocations_.open(procRoot);
+    if (maxOpenFiles_ == 0) {
+        rlimit limit{};
+        maxOpenFiles_ = getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+            ? static_cast<std::size_t>(limit.rlim_cur) / 2 : 512;
+    }
+    std::vector<char> scratch;
+    long len = statFile_.readAll(scratch);
+    if (len > 0) {
+        cores_ = countCpuLines(scratch.data(), scratch.data() + len);
+        parseAggregateCpuTicks(scratch.data(), scratch.data() + len, lastSystemTicks_);
+    }
+    grow();
+}
+
+ProcessTable::~ProcessTable() {
+    for (Slot& slot : slots_) {
+        if (slot.fd >= 0) ::close(slot.fd);
+    }
+}
+
+bool ProcessTable::refresh() {
+    if (allocations_.allocatedSinceLastCheck()) {
+        if (!dir_.isOpen() || !dir_.listPids(pids_)) return false;
+    } else {
+        // No process was created, so the table already holds every live one
+        pids_.clear();
+        for (const Slot& slot : slots_) {
+            if (slot.pid != 0) pids_.push_back(slot.pid);
+        }
+    }
+    uint64_t systemTicks = 0;
+    uint64_t elapsedTicks = 0;
+    long len = statFile_.readAll(buffer_, sizeof(buffer_));
+    if (len > 0 && parseAggregateCpuTicks(buffer_, buffer_ + len, systemTicks)) {
+        elapsedTicks = systemTicks > lastSystemTicks_ ? systemTicks - lastSystemTicks_ : 0;
+        lastSystemTicks_ = systemTicks;
+    }
+
+    ++epoch_;
+    for (int pid : pids_) {
+        if ((size_ + 1) * 2 > slots_.size()) grow();
+        std::size_t index = findOrInsert(pid);
+        if (!sample(slots_[index], elapsedTicks)) erase(index); // Exited since the listing
+    }
+    // Drop processes that were not listed; erase() may shift a later slot into i
+    for (std::size_t i = 0; i < slots_.size();) {
+        if (slots_[i].pid != 0 && slots_[i].epoch != epoch_) {
+            erase(i);
+        } else {
+            ++i;
+        }
+    }
+    return true;
+}
+
+bool ProcessTable::sample(Slot& slot, uint64_t elapsedTicks) {
+    long len = -1;
+    if (slot.fd >= 0) {
+        len = ::pread(slot.fd, buffer_, sizeof(buffer_) - 1, 0);
+        if (len <= 0) {
+            // The kept descriptor belongs to an exited process; the PID may be reused
+            ::close(slot.fd);
+            slot.fd = -1;
+            --openFiles_;
+        }
+    }
+    if (len <= 0) {
+        char path[32];
+        std::snprintf(path, sizeof(path), "%d/stat", slot.pid);
+        int fd = openat(dir_.fd(), path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        len = ::pread(fd, buffer_, sizeof(buffer_) - 1, 0);
+        if (len > 0 && openFiles_ < maxOpenFiles_) {
+            slot.fd = fd;
+            ++openFiles_;
+        } else {
+            ::close(fd);
+        }
+        if (len <= 0) return false;
+    }
+
+    PidStat stat;
+    if (!parsePidStat(buffer_, buffer_ + len, stat)) return false;
+    uint64_t ticks = stat.userTicks + stat.systemTicks;
+    if (slot.epoch != 0 && stat.startTime == slot.startTime) {
+        // Read after /proc/stat, the process can run a tick ahead of the
+        // aggregate delta; cap it at every core busy
+        uint64_t used = ticks > slot.cpuTicks ? ticks - slot.cpuTicks : 0;
+        slot.cpuPercent = elapsedTicks > 0
+            ? std::min(100.0 * static_cast<double>(used) * static_cast<double>(cores_) / static_cast<double>(elapsedTicks),
+                       100.0 * static_cast<double>(cores_))
+            : 0.0;
+    } else {
+        // New process (or a new one behind a reused PID): CPU% starts with the next refresh
+        slot.cpuPercent = 0.0;
+    }
+    std::size_t nameLength = std::min(stat.nameLength, sizeof(slot.name) - 1);
+    std::memcpy(slot.name, stat.name, nameLength);
+    slot.name[nameLength] = '\0';
+    slot.startTime = stat.startTime;
+    slot.cpuTicks = ticks;
+    slot.rssKB = stat.rssPages * pageKB_;
+    slot.epoch = epoch_;
+    return true;
+}
+
+std::size_t ProcessTable::findOrInsert(int pid) {
+    std::size_t index = indexOf(pid);
+    while (slots_[index].pid != 0) {
+        if (slots_[index].pid == pid) return index;
+        index = (index + 1) & mask_;
+    }
+    slots_[index] = Slot();
+    slots_[index].pid = pid;
+    ++size_;
+    return index;
+}
+
+void ProcessTable::erase(std::size_t index) {
+    if (slots_[index].fd >= 0) {
+        ::close(slots_[index].fd);
+        --openFiles_;
+    }
+    --size_;
+    // Backward-shift deletion: later entries of the probe run move up into the
+    // hole unless their home slot lies after it, so no tombstones build up
+    std::size_t hole = index;
+    for (std::size_t next = (index + 1) & mask_; slots_[next].pid != 0; next = (next + 1) & mask_) {
+        std::size_t home = indexOf(slots_[next].pid);
+        bool reachable = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!reachable) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = Slot();
+}
+
+void ProcessTable::grow() {
+    std::vector<Slot> old(slots_.empty() ? 1024 : slots_.size() * 2);
+    old.swap(slots_);
+    mask_ = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.pid == 0) continue;
+        std::size_t index = indexOf(slot.pid);
+        while (slots_[index].pid != 0) index = (index + 1) & mask_;
+        slots_[index] = slot;
+    }
+}
+
+template <typename Heavier>
+void ProcessTable::top(std::size_t n, std::vector<TopProcess>& out, Heavier heavier) {
+    order_.clear();
+    for (uint32_t i = 0; i < slots_.size(); ++i) {
+        if (slots_[i].pid != 0) order_.push_back(i);
+    }
+    n = std::min(n, order_.size());
+    auto before = [&](uint32_t a, uint32_t b) {
+        const Slot& x = slots_[a];
+        const Slot& y = slots_[b];
+        if (heavier(x, y)) return true;
+        if (heavier(y, x)) return false;
+        return x.pid < y.pid;
+    };
+    // O(size) selection of the n heaviest, then only those n are ordered
+    if (n < order_.size()) std::nth_element(order_.begin(), order_.begin() + n, order_.end(), before);
+    std::sort(order_.begin(), order_.begin() + n, before);
+    out.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const Slot& slot = slots_[order_[i]];
+        out[i].pid = slot.pid;
+        std::memcpy(out[i].name, slot.name, sizeof(out[i].name));
+        out[i].cpuPercent = slot.cpuPercent;
+        out[i].rssKB = slot.rssKB;
+    }
+}
+
+void ProcessTable::topByCpu(std::size_t n, std::vector<TopProcess>& out) {
+    top(n, out, [](const Slot& a, const Slot& b) { return a.cpuPercent > b.cpuPercent; });
+}
+
+void ProcessTable::topByRss(std::size_t n, std::vector<TopProcess>& out) {
+    top(n, out, [](const Slot& a, const Slot& b) { return a.rssKB > b.rssKB; });
+}
+#endif
@@ -0,0 +1,158 @@
+#include "utils/process_tree.hpp"
+
+#ifdef __linux__
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcessTree::ProcessTree(const std::string& procRoot) {
+    dir_.open(procRoot);
+    // Optional; without it every refresh lists the directory
+    allocations_.open(procRoot);
+}
+
+bool ProcessTree::readEntry(int pid, Entry& entry) {
+    ++statReads_;
+    char path[32];
+    std::snprintf(path, sizeof(path), "%d/stat", pid);
+    int fd = openat(dir_.fd(), path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false; // Exited since the listing
+    ssize_t len = read(fd, buffer_, sizeof(buffer_) - 1);
+    close(fd);
+    if (len <= 0) return false;
+    PidStat stat;
+    if (!parsePidStat(buffer_, buffer_ + len, stat)) return false;
+    entry.pid = pid;
+    entry.parent = stat.parent;
+    entry.startTime = stat.startTime;
+    entry.member = false;
+    return true;
+}
+
+ProcessTree::Entry* ProcessTree::find(int pid) {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), pid,
+                               [](const Entry& entry, int value) { return entry.pid < value; });
+    return it != entries_.end() && it->pid == pid ? &*it : nullptr;
+}
+
+bool ProcessTree::refresh(const std::vector<int>& roots) {
+    statReads_ = 0;
+    listed_ = false;
+    std::vector<int> sortedRoots(roots);
+    std::sort(sortedRoots.begin(), sortedRoots.end());
+    bool rootsChanged = sortedRoots != roots_;
+    // Checked on every call so the PID baseline stays current
+    if (!allocations_.allocatedSinceLastCheck() && !rootsChanged) return false;
+    if (!dir_.isOpen() || !dir_.listPids(pids_)) return false;
+    listed_ = true;
+    // procfs lists processes in PID order already; fixture directories may not
+    if (!std::is_sorted(pids_.begin(), pids_.end())) std::sort(pids_.begin(), pids_.end());
+
+    bool changed = false;
+    merged_.clear();
+    merged_.reserve(pids_.size());
+    added_.clear();
+    std::size_t old = 0;
+    for (int pid : pids_) {
+        while (old < entries_.size() && entries_[old].pid < pid) {
+            changed = changed || entries_[old].member;
+            ++old;
+        }
+        if (old < entries_.size() && entries_[old].pid == pid) {
+            const Entry& cached = entries_[old++];
+            if (!allocations_.mayHaveAllocated(pid)) {
+                merged_.push_back(cached);
+                continue;
+            }
+            // The PID was handed out again since the last listing: if the start
+            // time moved it is a different process, resolved like a new one
+            Entry entry;
+            if (!readEntry(pid, entry)) {
+                changed = changed || cached.member;
+            } else if (entry.startTime == cached.startTime) {
+                merged_.push_back(cached);
+            } else {
+                changed = changed || cached.member;
+                added_.push_back(merged_.size());
+                merged_.push_back(entry);
+            }
+            continue;
+        }
+        Entry entry;
+        if (readEntry(pid, entry)) {
+            added_.push_back(merged_.size());
+            merged_.push_back(entry);
+        }
+    }
+    for (; old < entries_.size(); ++old) changed = changed || entries_[old].member;
+    entries_.swap(merged_);
+
+    if (rootsChanged) {
+        roots_.swap(sortedRoots);
+        changed = recomputeMembership() || changed;
+    } else if (!added_.empty()) {
+        changed = resolveNewEntries() || changed;
+    }
+
+    if (changed) {
+        members_.clear();
+        for (const Entry& entry : entries_) {
+            if (entry.member) members_.push_back(entry.pid);
+        }
+    }
+    return changed;
+}
+
+bool ProcessTree::resolveNewEntries() {
+    // A child is usually listed after its parent, but PIDs wrap, so repeat
+    // until a pass adds nothing; only the new entries are visited
+    bool changed = false;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (std::size_t index : added_) {
+            Entry& entry = entries_[index];
+            if (entry.member) continue;
+            bool root = std::binary_search(roots_.begin(), roots_.end(), entry.pid);
+            const Entry* parent = root ? nullptr : find(entry.parent);
+            if (root || (parent && parent->member)) {
+                entry.member = true;
+                progress = true;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+bool ProcessTree::recomputeMembership() {
+    std::vector<int> before;
+    for (const Entry& entry : entries_) {
+        if (entry.member) before.push_back(entry.pid);
+    }
+    // One pass per tree level; runs only when the roots change
+    for (Entry& entry : entries_) {
+        entry.member = std::binary_search(roots_.begin(), roots_.end(), entry.pid);
+    }
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (Entry& entry : entries_) {
+            if (entry.member) continue;
+            const Entry* parent = find(entry.parent);
+            if (parent && parent->member) {
+                entry.member = true;
+                progress = true;
+            }
+        }
+    }
+    std::size_t i = 0;
+    for (const Entry& entry : entries_) {
+        if (!entry.member) continue;
+        if (i >= before.size() || before[i] != entry.pid) return true;
+        ++i;
+    }
+    return i != before.size();
+}
+#endif
@@ -0,0 +1,143 @@
+#include "utils/recording.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+// Steps of lossy compression (--compress=lossy): percentages are rounded to
+// 1/128 of a percentage point and latencies to 1/1024 ms, so the XOR of
+// neighbouring values leaves long runs of zero bits. Timestamps and memory MB
+// are always stored exactly, and without quantization so is everything else
+constexpr double kPercentScale = 128.0;
+constexpr double kLatencyScale = 1024.0;
+
+// A scale of 0 leaves the value untouched
+double quantize(double value, double scale) {
+    return scale > 0.0 ? std::nearbyint(value * scale) / scale : value;
+}
+
+template <typename T>
+T load(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void store(char* p, T value) {
+    std::memcpy(p, &value, sizeof(value));
+}
+
+// Column order within a block: time, the two memory MB columns, the fixed
+// double columns, the four float latencies, then per-core and per-GPU values
+constexpr std::size_t kUintColumns[] = {offsetof(SampleRecord, memoryUsedMB), offsetof(SampleRecord, memoryTotalMB)};
+constexpr std::size_t kPercentColumns[] = {offsetof(SampleRecord, cpuPercent), offsetof(SampleRecord, memoryUsedPercent),
+                                           offsetof(SampleRecord, gpuPercent), offsetof(SampleRecord, npuPercent)};
+constexpr std::size_t kLatencyColumns[] = {offsetof(SampleRecord, cpuLatencyMs), offsetof(SampleRecord, memoryLatencyMs),
+                                           offsetof(SampleRecord, gpuLatencyMs), offsetof(SampleRecord, npuLatencyMs)};
+}
+
+void SampleBlockEncoder::reset(std::size_t coreCount, std::size_t gpuCount, bool lossy) {
+    recordBytes_ = recordingRecordBytes(coreCount, gpuCount);
+    quantize_ = lossy;
+    pending_.clear();
+    pending_.reserve(kRecordingBlockSamples * recordBytes_);
+    block_.clear();
+    count_ = 0;
+}
+
+void SampleBlockEncoder::add(const char* record) {
+    pending_.insert(pending_.end(), record, record + recordBytes_);
+    ++count_;
+}
+
+const std::vector<uint8_t>& SampleBlockEncoder::finish() {
+    block_.assign(sizeof(RecordingBlockHeader), 0);
+    double percentScale = quantize_ ? kPercentScale : 0.0;
+    double latencyScale = quantize_ ? kLatencyScale : 0.0;
+    const char* base = pending_.data();
+    BitWriter bits(block_);
+
+    int64_t first = count_ ? load<int64_t>(base) : 0;
+    TimestampColumnCodec timestamps;
+    timestamps.reset(first);
+    for (std::size_t i = 0; i < count_; ++i) timestamps.encode(bits, load<int64_t>(base + i * recordBytes_));
+
+    for (std::size_t offset : kUintColumns) {
+        UintColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) column.encode(bits, load<uint64_t>(base + i * recordBytes_ + offset));
+    }
+    for (std::size_t offset : kPercentColumns) {
+        FloatColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) {
+            column.encode(bits, quantize(load<double>(base + i * recordBytes_ + offset), percentScale));
+        }
+    }
+    for (std::size_t offset : kLatencyColumns) {
+        FloatColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) {
+            column.encode(bits, quantize(load<float>(base + i * recordBytes_ + offset), latencyScale));
+        }
+    }
+    for (std::size_t offset = sizeof(SampleRecord); offset < recordBytes_; offset += sizeof(double)) {
+        FloatColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) {
+            column.encode(bits, quantize(load<double>(base + i * recordBytes_ + offset), percentScale));
+        }
+    }
+    bits.flush();
+
+    RecordingBlockHeader header = {};
+    std::memcpy(header.magic, kRecordingBlockMagic, sizeof(header.magic));
+    header.sampleCount = static_cast<uint32_t>(count_);
+    header.payloadBytes = static_cast<uint32_t>(block_.size() - sizeof(header));
+    header.firstTimestampNs = first;
+    header.lastTimestampNs = count_ ? load<int64_t>(base + (count_ - 1) * recordBytes_) : 0;
+    std::memcpy(block_.data(), &header, sizeof(header));
+    pending_.clear();
+    count_ = 0;
+    return block_;
+}
+
+void SampleBlockDecoder::reset(std::size_t coreCount, std::size_t gpuCount) {
+    recordBytes_ = recordingRecordBytes(coreCount, gpuCount);
+    count_ = 0;
+}
+
+bool SampleBlockDecoder::decode(const RecordingBlockHeader& header, const uint8_t* payload) {
+    payload_.assign(payload, payload + header.payloadBytes);
+    payload_.resize(header.payloadBytes + kBitReaderPadding, 0);
+    BitReader bits(payload_.data(), header.payloadBytes);
+    count_ = header.sampleCount;
+    decoded_.resize(count_ * recordBytes_);
+    char* base = decoded_.data();
+
+    TimestampColumnCodec timestamps;
+    timestamps.reset(header.firstTimestampNs);
+    for (std::size_t i = 0; i < count_; ++i) store(base + i * recordBytes_, timestamps.decode(bits));
+
+    for (std::size_t offset : kUintColumns) {
+        UintColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) store(base + i * recordBytes_ + offset, column.decode(bits));
+    }
+    for (std::size_t offset : kPercentColumns) {
+        FloatColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) store(base + i * recordBytes_ + offset, column.decode(bits));
+    }
+    for (std::size_t offset : kLatencyColumns) {
+        FloatColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) {
+            store(base + i * recordBytes_ + offset, static_cast<float>(column.decode(bits)));
+        }
+    }
+    for (std::size_t offset = sizeof(SampleRecord); offset < recordBytes_; offset += sizeof(double)) {
+        FloatColumnCodec column;
+        for (std::size_t i = 0; i < count_; ++i) store(base + i * recordBytes_ + offset, column.decode(bits));
+    }
+    // A corrupt payload runs out of bits before its sample count
+    if (bits.overrun()) {
+        count_ = 0;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,220 @@
+#include "utils/recording.hpp"
+#include <cstring>
+
+#ifdef _WIN32
+    #include <fstream>
+    #include <iterator>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+void RecordingReader::startDecoding() {
+    produced_ = 0;
+    consumed_ = 0;
+    decodeDone_ = false;
+    decodeStop_ = false;
+    current_ = nullptr;
+    for (auto& decoder : decoders_) decoder.reset(header_.coreCount, header_.gpuCount);
+    decodeThread_ = std::thread(&RecordingReader::decodeLoop, this, nextBlock_);
+}
+
+void RecordingReader::stopDecoding() {
+    if (decodeThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex_);
+            decodeStop_ = true;
+        }
+        decodeCv_.notify_all();
+        decodeThread_.join();
+    }
+    current_ = nullptr;
+    blockPos_ = 0;
+}
+
+void RecordingReader::decodeLoop(std::size_t firstBlock) {
+    for (std::size_t b = firstBlock; b < blocks_.size(); ++b) {
+        std::size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(decodeMutex_);
+            decodeCv_.wait(lock, [this] { return decodeStop_ || produced_ - consumed_ < 2; });
+            if (decodeStop_) return;
+            slot = produced_ % 2;
+        }
+        RecordingBlockHeader block;
+        std::memcpy(&block, data_ + blocks_[b], sizeof(block));
+        bool ok = decoders_[slot].decode(block, reinterpret_cast<const uint8_t*>(data_ + blocks_[b] + sizeof(block)));
+        std::lock_guard<std::mutex> lock(decodeMutex_);
+        if (!ok) break;
+        ++produced_;
+        decodeCv_.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(decodeMutex_);
+    decodeDone_ = true;
+    decodeCv_.notify_all();
+}
+
+bool RecordingReader::nextBlock() {
+    if (!decodeThread_.joinable()) startDecoding();
+    std::unique_lock<std::mutex> lock(decodeMutex_);
+    if (current_) {
+        ++consumed_; // Hand the finished slot back to the helper
+        current_ = nullptr;
+        decodeCv_.notify_all();
+    }
+    decodeCv_.wait(lock, [this] { return decodeDone_ || produced_ > consumed_; });
+    if (produced_ == consumed_) return false;
+    current_ = &decoders_[consumed_ % 2];
+    blockPos_ = 0;
+    return true;
+}
+
+bool RecordingReader::fail(const std::string& message) {
+    close();
+    error_ = message;
+    return false;
+}
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+    error_.clear();
+
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail("cannot open " + path);
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail("cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return fail(path + " is empty");
+    }
+    void* map = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (map == MAP_FAILED) return fail("cannot map " + path);
+    map_ = map;
+    data_ = static_cast<const char*>(map);
+    size_ = static_cast<std::size_t>(st.st_size);
+#endif
+
+    if (size_ < sizeof(RecordingHeader)) return fail(path + " is too short to be a recording");
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (std::memcmp(header_.magic, kRecordingMagic, sizeof(header_.magic)) != 0) {
+        return fail(path + " is not a CrossMon recording");
+    }
+    if (header_.version < 1 || header_.version > kRecordingVersion) {
+        return fail(path + " has unsupported recording version " + std::to_string(header_.version));
+    }
+    bool gorilla = header_.encoding == static_cast<uint32_t>(RecordingEncoding::Gorilla);
+    if (header_.encoding != static_cast<uint32_t>(RecordingEncoding::Raw) && !gorilla) {
+        return fail(path + " uses an unknown encoding");
+    }
+    if (header_.headerBytes < sizeof(RecordingHeader) || header_.headerBytes > size_ ||
+        header_.recordBytes != recordingRecordBytes(header_.coreCount, header_.gpuCount)) {
+        return fail(path + " has an inconsistent header");
+    }
+    // Before version 3 every Gorilla recording was quantized
+    if (header_.version < 3) header_.quantized = gorilla ? 1 : 0;
+    if (gorilla) {
+        indexBlocks();
+    }
+    rewind();
+    return true;
+}
+
+void RecordingReader::indexBlocks() {
+    // Complete blocks only: a torn or zero-filled tail ends the index
+    std::size_t pos = header_.headerBytes;
+    RecordingBlockHeader block;
+    while (size_ - pos >= sizeof(block)) {
+        std::memcpy(&block, data_ + pos, sizeof(block));
+        if (std::memcmp(block.magic, kRecordingBlockMagic, sizeof(block.magic)) != 0 || block.sampleCount == 0 ||
+            size_ - pos - sizeof(block) < block.payloadBytes) {
+            break;
+        }
+        blocks_.push_back(pos);
+        pos += sizeof(block) + block.payloadBytes;
+    }
+}
+
+void RecordingReader::rewind() {
+    stopDecoding();
+    pos_ = header_.headerBytes;
+    nextBlock_ = 0;
+}
+
+bool RecordingReader::seekBlock(std::size_t block) {
+    if (block >= blocks_.size()) return false;
+    stopDecoding();
+    nextBlock_ = block;
+    return true;
+}
+
+bool RecordingReader::seekTime(int64_t timestampNs) {
+    std::size_t lo = 0;
+    std::size_t hi = blocks_.size();
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        RecordingBlockHeader block;
+        std::memcpy(&block, data_ + blocks_[mid], sizeof(block));
+        if (block.lastTimestampNs < timestampNs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return seekBlock(lo);
+}
+
+void RecordingReader::close() {
+    stopDecoding();
+#ifdef _WIN32
+    buffer_.clear();
+#else
+    if (map_) {
+        munmap(map_, size_);
+        map_ = nullptr;
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    pos_ = 0;
+    blocks_.clear();
+    nextBlock_ = 0;
+}
+
+bool RecordingReader::next(SampleRecord& record, double* cores, double* gpus) {
+    if (header_.encoding == static_cast<uint32_t>(RecordingEncoding::Gorilla)) {
+        while (!current_ || blockPos_ >= current_->sampleCount()) {
+            if (!nextBlock()) return false;
+        }
+        const char* p = current_->record(blockPos_++);
+        std::memcpy(&record, p, sizeof(record));
+        p += sizeof(record);
+        if (header_.coreCount > 0) std::memcpy(cores, p, header_.coreCount * sizeof(double));
+        p += header_.coreCount * sizeof(double);
+        if (header_.gpuCount > 0) std::memcpy(gpus, p, header_.gpuCount * sizeof(double));
+        return true;
+    }
+    if (!data_ || size_ - pos_ < header_.recordBytes) return false;
+    const char* p = data_ + pos_;
+    std::memcpy(&record, p, sizeof(record));
+    // An untrimmed file ends in zero-filled records
+    if (record.timestampNs == 0) return false;
+    p += sizeof(record);
+    if (header_.coreCount > 0) std::memcpy(cores, p, header_.coreCount * sizeof(double));
+    p += header_.coreCount * sizeof(double);
+    if (header_.gpuCount > 0) std::memcpy(gpus, p, header_.gpuCount * sizeof(double));
+    pos_ += header_.recordBytes;
+    return true;
+}
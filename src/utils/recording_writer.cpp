@@ -0,0 +1,237 @@
+#include "utils/recording.hpp"
+#include "utils/host_info.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+void copyField(char* dest, std::size_t size, const std::string& value) {
+    std::size_t n = std::min(value.size(), size - 1);
+    std::memcpy(dest, value.data(), n);
+    dest[n] = '\0';
+}
+
+std::size_t pageSize() {
+#ifdef _WIN32
+    return 4096;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+}
+
+RecordingHeader makeRecordingHeader(uint32_t intervalMs, std::size_t coreCount, std::size_t gpuCount,
+                                    const std::string& npuName, RecordingEncoding encoding) {
+    RecordingHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kRecordingMagic, sizeof(header.magic));
+    header.version = kRecordingVersion;
+    header.headerBytes = static_cast<uint32_t>(kRecordingHeaderBytes);
+    header.recordBytes = static_cast<uint32_t>(recordingRecordBytes(coreCount, gpuCount));
+    header.encoding = static_cast<uint32_t>(encoding);
+    header.blockSamples = encoding == RecordingEncoding::Gorilla ? kRecordingBlockSamples : 0;
+    header.intervalMs = intervalMs;
+    header.coreCount = static_cast<uint32_t>(coreCount);
+    header.gpuCount = static_cast<uint32_t>(gpuCount);
+    header.startTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    HostInfo host = queryHostInfo();
+    copyField(header.host, sizeof(header.host), host.hostName);
+    copyField(header.kernel, sizeof(header.kernel), host.kernel);
+    copyField(header.cpuModel, sizeof(header.cpuModel), host.cpuModel);
+    copyField(header.npuName, sizeof(header.npuName), npuName);
+    return header;
+}
+
+RecordingWriter::RecordingWriter(std::size_t chunkBytes, std::size_t queueRecords)
+    : queueRecords_(std::max<std::size_t>(queueRecords, 1)) {
+    // Chunks are whole pages so each one can be synced on its own
+    std::size_t page = pageSize();
+    chunkBytes_ = std::max<std::size_t>((chunkBytes + page - 1) / page * page, page);
+}
+
+RecordingWriter::~RecordingWriter() {
+    close();
+}
+
+bool RecordingWriter::open(const std::string& path, const RecordingHeader& header) {
+    if (running_) return false;
+    coreCount_ = header.coreCount;
+    gpuCount_ = header.gpuCount;
+    recordBytes_ = recordingRecordBytes(coreCount_, gpuCount_);
+    blockSamples_ = header.encoding == static_cast<uint32_t>(RecordingEncoding::Gorilla) ? header.blockSamples : 0;
+    encoder_.reset(coreCount_, gpuCount_, header.quantized != 0);
+    queue_.assign(queueRecords_ * recordBytes_, 0);
+    head_ = 0;
+    tail_ = 0;
+    written_ = 0;
+    dropped_ = 0;
+    writePos_ = 0;
+    syncedPos_ = 0;
+    fileSize_ = 0;
+
+#ifdef _WIN32
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+#else
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) return false;
+#endif
+
+    char block[kRecordingHeaderBytes] = {};
+    std::memcpy(block, &header, sizeof(header));
+    if (!writeAt(0, block, sizeof(block))) {
+        closeFile();
+        return false;
+    }
+    writePos_ = sizeof(block);
+    syncChunk(true);
+
+    stopping_ = false;
+    running_ = true;
+    writer_ = std::thread(&RecordingWriter::writerLoop, this);
+    return true;
+}
+
+bool RecordingWriter::append(const SampleRecord& record, const double* cores, const double* gpus) {
+    if (!running_) return false;
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= queueRecords_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    char* slot = queue_.data() + (head % queueRecords_) * recordBytes_;
+    std::memcpy(slot, &record, sizeof(record));
+    slot += sizeof(record);
+    if (coreCount_ > 0) std::memcpy(slot, cores, coreCount_ * sizeof(double));
+    slot += coreCount_ * sizeof(double);
+    if (gpuCount_ > 0) std::memcpy(slot, gpus, gpuCount_ * sizeof(double));
+    head_.store(head + 1, std::memory_order_release);
+    // Notifying without the mutex never blocks; a missed wakeup only delays the
+    // writer until its next timed poll
+    wakeCv_.notify_one();
+    return true;
+}
+
+void RecordingWriter::close() {
+    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCv_.notify_one();
+    writer_.join();
+    running_ = false;
+}
+
+void RecordingWriter::writerLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCv_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                return stopping_ || head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_relaxed);
+            });
+        }
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail < head; ++tail) {
+            writeRecord(queue_.data() + (tail % queueRecords_) * recordBytes_);
+        }
+        tail_.store(tail, std::memory_order_release);
+        syncChunk(false);
+        if (stopping_ && head_.load(std::memory_order_acquire) == tail) break;
+    }
+    if (encoder_.sampleCount() > 0) writeBlock();
+    syncChunk(true);
+    closeFile();
+}
+
+void RecordingWriter::writeRecord(const char* record) {
+    if (blockSamples_ > 0) {
+        encoder_.add(record);
+        written_.fetch_add(1, std::memory_order_relaxed);
+        if (encoder_.sampleCount() >= blockSamples_) writeBlock();
+        return;
+    }
+    if (writeAt(writePos_, record, recordBytes_)) {
+        writePos_ += recordBytes_;
+        written_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RecordingWriter::writeBlock() {
+    std::size_t samples = encoder_.sampleCount();
+    const std::vector<uint8_t>& block = encoder_.finish();
+    if (writeAt(writePos_, block.data(), block.size())) {
+        writePos_ += block.size();
+    } else {
+        written_.fetch_sub(samples, std::memory_order_relaxed);
+        dropped_.fetch_add(samples, std::memory_order_relaxed);
+    }
+}
+
+#ifdef _WIN32
+bool RecordingWriter::writeAt(std::size_t, const void* data, std::size_t size) {
+    // stdio appends sequentially, which is the only order records are written in
+    return std::fwrite(data, 1, size, file_) == size;
+}
+
+void RecordingWriter::syncChunk(bool final) {
+    if (!final && writePos_ - syncedPos_ < chunkBytes_) return;
+    std::fflush(file_);
+    syncedPos_ = writePos_;
+}
+
+void RecordingWriter::closeFile() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+#else
+bool RecordingWriter::writeAt(std::size_t offset, const void* data, std::size_t size) {
+    if (offset + size > fileSize_) {
+        // Grow by whole chunks and remap; only ever happens on the writer thread
+        std::size_t newSize = (offset + size + chunkBytes_ - 1) / chunkBytes_ * chunkBytes_;
+        if (ftruncate(fd_, static_cast<off_t>(newSize)) != 0) return false;
+        void* map = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) return false;
+        if (map_) munmap(map_, fileSize_);
+        map_ = static_cast<char*>(map);
+        fileSize_ = newSize;
+    }
+    std::memcpy(map_ + offset, data, size);
+    return true;
+}
+
+void RecordingWriter::syncChunk(bool final) {
+    if (!map_ || writePos_ == syncedPos_) return;
+    if (!final && writePos_ - syncedPos_ < chunkBytes_) return;
+    std::size_t start = syncedPos_ / pageSize() * pageSize();
+    msync(map_ + start, writePos_ - start, MS_SYNC);
+    syncedPos_ = writePos_;
+}
+
+void RecordingWriter::closeFile() {
+    if (map_) {
+        munmap(map_, fileSize_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        // Drop the zero-filled remainder of the last chunk
+        if (ftruncate(fd_, static_cast<off_t>(writePos_)) == 0) fsync(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    fileSize_ = 0;
+}
+#endif
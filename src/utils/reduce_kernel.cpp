@@ -0,0 +1,213 @@
+#include "utils/reduce_kernel.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CROSSMON_REDUCE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CROSSMON_REDUCE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CROSSMON_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CROSSMON_TARGET(isa)
+#endif
+
+double ReduceResult::variance() const {
+    if (count == 0) return 0.0;
+    double mean = sum / count;
+    double v = sumSquares / count - mean * mean;
+    return v > 0.0 ? v : 0.0;
+}
+
+namespace {
+ReduceResult reduceScalar(const double* values, std::size_t count, double shift) {
+    ReduceResult r;
+    r.count = count;
+    r.shift = shift;
+    if (count == 0) return r;
+    double mn = values[0], mx = values[0], sum = 0.0, sq = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        double v = values[i];
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        double d = v - shift;
+        sum += d;
+        sq += d * d;
+    }
+    r.min = mn;
+    r.max = mx;
+    r.sum = sum;
+    r.sumSquares = sq;
+    return r;
+}
+
+#ifdef CROSSMON_REDUCE_X86
+CROSSMON_TARGET("sse2")
+ReduceResult reduceSse2(const double* values, std::size_t count, double shift) {
+    if (count < 4) return reduceScalar(values, count, shift);
+    // Two independent accumulator sets hide the add latency
+    __m128d vshift = _mm_set1_pd(shift);
+    __m128d mn0 = _mm_loadu_pd(values), mn1 = mn0, mx0 = mn0, mx1 = mn0;
+    __m128d s0 = _mm_setzero_pd(), s1 = s0, q0 = s0, q1 = s0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd(values + i);
+        __m128d b = _mm_loadu_pd(values + i + 2);
+        mn0 = _mm_min_pd(mn0, a);
+        mn1 = _mm_min_pd(mn1, b);
+        mx0 = _mm_max_pd(mx0, a);
+        mx1 = _mm_max_pd(mx1, b);
+        a = _mm_sub_pd(a, vshift);
+        b = _mm_sub_pd(b, vshift);
+        s0 = _mm_add_pd(s0, a);
+        s1 = _mm_add_pd(s1, b);
+        q0 = _mm_add_pd(q0, _mm_mul_pd(a, a));
+        q1 = _mm_add_pd(q1, _mm_mul_pd(b, b));
+    }
+    alignas(16) double mn[2], mx[2], s[2], q[2];
+    _mm_store_pd(mn, _mm_min_pd(mn0, mn1));
+    _mm_store_pd(mx, _mm_max_pd(mx0, mx1));
+    _mm_store_pd(s, _mm_add_pd(s0, s1));
+    _mm_store_pd(q, _mm_add_pd(q0, q1));
+
+    ReduceResult tail = reduceScalar(values + i, count - i, shift);
+    ReduceResult r;
+    r.count = count;
+    r.shift = shift;
+    r.min = std::min(mn[0], mn[1]);
+    r.max = std::max(mx[0], mx[1]);
+    r.sum = s[0] + s[1] + tail.sum;
+    r.sumSquares = q[0] + q[1] + tail.sumSquares;
+    if (tail.count) {
+        r.min = std::min(r.min, tail.min);
+        r.max = std::max(r.max, tail.max);
+    }
+    return r;
+}
+
+CROSSMON_TARGET("avx2")
+ReduceResult reduceAvx2(const double* values, std::size_t count, double shift) {
+    if (count < 8) return reduceScalar(values, count, shift);
+    __m256d vshift = _mm256_set1_pd(shift);
+    __m256d mn0 = _mm256_loadu_pd(values), mn1 = mn0, mx0 = mn0, mx1 = mn0;
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, q0 = s0, q1 = s0;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        mn0 = _mm256_min_pd(mn0, a);
+        mn1 = _mm256_min_pd(mn1, b);
+        mx0 = _mm256_max_pd(mx0, a);
+        mx1 = _mm256_max_pd(mx1, b);
+        a = _mm256_sub_pd(a, vshift);
+        b = _mm256_sub_pd(b, vshift);
+        s0 = _mm256_add_pd(s0, a);
+        s1 = _mm256_add_pd(s1, b);
+        q0 = _mm256_add_pd(q0, _mm256_mul_pd(a, a));
+        q1 = _mm256_add_pd(q1, _mm256_mul_pd(b, b));
+    }
+    alignas(32) double mn[4], mx[4], s[4], q[4];
+    _mm256_store_pd(mn, _mm256_min_pd(mn0, mn1));
+    _mm256_store_pd(mx, _mm256_max_pd(mx0, mx1));
+    _mm256_store_pd(s, _mm256_add_pd(s0, s1));
+    _mm256_store_pd(q, _mm256_add_pd(q0, q1));
+
+    ReduceResult tail = reduceScalar(values + i, count - i, shift);
+    ReduceResult r;
+    r.count = count;
+    r.shift = shift;
+    r.min = std::min(std::min(mn[0], mn[1]), std::min(mn[2], mn[3]));
+    r.max = std::max(std::max(mx[0], mx[1]), std::max(mx[2], mx[3]));
+    r.sum = (s[0] + s[1]) + (s[2] + s[3]) + tail.sum;
+    r.sumSquares = (q[0] + q[1]) + (q[2] + q[3]) + tail.sumSquares;
+    if (tail.count) {
+        r.min = std::min(r.min, tail.min);
+        r.max = std::max(r.max, tail.max);
+    }
+    return r;
+}
+
+bool cpuHasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    // The OS must save the YMM registers on context switch
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+}
+
+ReduceIsa detectReduceIsa() {
+#ifdef CROSSMON_REDUCE_X86
+    static const ReduceIsa isa = cpuHasAvx2() ? ReduceIsa::Avx2 : ReduceIsa::Sse2;
+    return isa;
+#else
+    return ReduceIsa::Scalar;
+#endif
+}
+
+bool isReduceIsaSupported(ReduceIsa isa) {
+    return static_cast<int>(isa) <= static_cast<int>(detectReduceIsa());
+}
+
+const char* reduceIsaName(ReduceIsa isa) {
+    switch (isa) {
+    case ReduceIsa::Avx2: return "avx2";
+    case ReduceIsa::Sse2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+ReduceResult reduceFusedWith(ReduceIsa isa, const double* values, std::size_t count, double shift) {
+    switch (isa) {
+#ifdef CROSSMON_REDUCE_X86
+    case ReduceIsa::Avx2: return reduceAvx2(values, count, shift);
+    case ReduceIsa::Sse2: return reduceSse2(values, count, shift);
+#endif
+    default: return reduceScalar(values, count, shift);
+    }
+}
+
+ReduceResult reduceFused(const double* values, std::size_t count, double shift) {
+    return reduceFusedWith(detectReduceIsa(), values, count, shift);
+}
+
+ReduceResult reduceFused(const uint64_t* values, std::size_t count, double shift, uint64_t& exactSum) {
+    ReduceResult r;
+    r.count = count;
+    r.shift = shift;
+    exactSum = 0;
+    if (count == 0) return r;
+    // No unsigned 64-bit min/max below AVX-512, so this stays scalar
+    uint64_t mn = values[0], mx = values[0], sum = 0;
+    double sq = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        uint64_t v = values[i];
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+        double d = static_cast<double>(v) - shift;
+        sq += d * d;
+    }
+    exactSum = sum;
+    r.min = static_cast<double>(mn);
+    r.max = static_cast<double>(mx);
+    r.sum = static_cast<double>(sum) - shift * count;
+    r.sumSquares = sq;
+    return r;
+}
@@ -0,0 +1,137 @@
+#include "utils/sample_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <poll.h>
+#endif
+
+ISchedulerClock::time_point SteadySchedulerClock::now() {
+    return std::chrono::steady_clock::now();
+}
+
+bool SteadySchedulerClock::sleepUntil(time_point deadline) {
+    std::this_thread::sleep_until(deadline);
+    return true;
+}
+
+#ifndef _WIN32
+bool WakeableSchedulerClock::sleepUntil(time_point deadline) {
+    if (wakeFd_ < 0) return SteadySchedulerClock::sleepUntil(deadline);
+    pollfd pfd = {wakeFd_, POLLIN, 0};
+    while (true) {
+        auto remaining = deadline - now();
+        if (remaining < std::chrono::nanoseconds::zero()) remaining = std::chrono::nanoseconds::zero();
+#ifdef __linux__
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        timespec timeout = {static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        int ready = ppoll(&pfd, 1, &timeout, nullptr);
+#else
+        // poll() only takes whole milliseconds; the sub-millisecond rest is slept
+        // off on the next pass with a zero-timeout check first
+        int ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count());
+        int ready = poll(&pfd, 1, ms);
+        if (ready == 0 && ms == 0) {
+            std::this_thread::sleep_until(deadline);
+            ready = poll(&pfd, 1, 0);
+        }
+#endif
+        if (ready > 0) return false;
+        if (ready < 0 && errno != EINTR) return SteadySchedulerClock::sleepUntil(deadline);
+        if (ready == 0 && now() >= deadline) return true;
+    }
+}
+#endif
+
+SampleScheduler::SampleScheduler(std::chrono::nanoseconds interval, OverrunPolicy policy, ISchedulerClock& clock)
+    : interval_(interval.count() > 0 ? interval : std::chrono::nanoseconds(1)), policy_(policy), clock_(clock) {
+    next_ = clock_.now() + interval_;
+    current_ = next_;
+    stats_.intervalMs = std::chrono::duration<double, std::milli>(interval_).count();
+}
+
+bool SampleScheduler::waitNext() {
+    auto now = clock_.now();
+    if (now > next_) {
+        // The previous tick ran past this deadline
+        ++stats_.overruns;
+        if (policy_ == OverrunPolicy::Skip) {
+            auto missed = (now - next_) / interval_;
+            next_ += missed * interval_;
+            stats_.skippedTicks += static_cast<std::size_t>(missed);
+        }
+    }
+
+    if (!clock_.sleepUntil(next_)) {
+        return false;
+    }
+
+    auto woke = clock_.now();
+    double jitterUs = woke > next_ ? std::chrono::duration<double, std::micro>(woke - next_).count() : 0.0;
+    ++stats_.ticks;
+    jitterSumUs_ += jitterUs;
+    stats_.meanJitterUs = jitterSumUs_ / stats_.ticks;
+    if (jitterUs > stats_.maxJitterUs) stats_.maxJitterUs = jitterUs;
+
+    current_ = next_;
+    next_ += interval_;
+    return true;
+}
+
+void SampleScheduler::setInterval(std::chrono::nanoseconds interval) {
+    interval_ = interval.count() > 0 ? interval : std::chrono::nanoseconds(1);
+    next_ = current_ + interval_;
+}
+
+AdaptiveInterval::AdaptiveInterval(std::chrono::nanoseconds minInterval, std::chrono::nanoseconds maxInterval,
+                                   double step, std::size_t signalCount)
+    : min_(minInterval),
+      max_(std::max(maxInterval, minInterval)),
+      step_(step),
+      signals_(signalCount),
+      interval_(minInterval) {}
+
+std::chrono::nanoseconds AdaptiveInterval::observe(const double* signals) {
+    // Weight of the newest sample in the running mean and variance
+    constexpr double kAlpha = 0.2;
+    constexpr double kDeviations = 3.0;
+
+    bool moved = false;
+    for (std::size_t i = 0; i < signals_.size(); ++i) {
+        Signal& s = signals_[i];
+        double value = signals[i];
+        if (!primed_) {
+            s.last = s.mean = value;
+            continue;
+        }
+        double deviation = value - s.mean;
+        // A deviation test against a near-zero variance would fire on noise,
+        // so the spread is never taken as less than a quarter step
+        double spread = std::max(std::sqrt(s.variance), step_ / 4.0);
+        if (std::abs(value - s.last) >= step_ || std::abs(deviation) > kDeviations * spread) {
+            moved = true;
+        }
+        s.mean += kAlpha * deviation;
+        s.variance = (1.0 - kAlpha) * (s.variance + kAlpha * deviation * deviation);
+        s.last = value;
+    }
+    primed_ = true;
+
+    if (moved) {
+        if (interval_ > min_) ++tightenings_;
+        interval_ = min_;
+        hold_ = kHoldTicks;
+    } else if (hold_ > 0) {
+        --hold_;
+    } else {
+        interval_ = std::min(interval_ * 2, max_);
+    }
+    return interval_;
+}
+
+double sampleWeight(int64_t previousNs, int64_t timestampNs, std::chrono::nanoseconds minInterval) {
+    if (previousNs == 0 || timestampNs <= previousNs || minInterval.count() <= 0) return 1.0;
+    return static_cast<double>(timestampNs - previousNs) / static_cast<double>(minInterval.count());
+}
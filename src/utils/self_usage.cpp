@@ -0,0 +1,100 @@
+#include "utils/self_usage.hpp"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <time.h>
+    #include <unistd.h>
+#endif
+#ifdef __APPLE__
+    #include <mach/mach.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+// FILETIME counts 100 ns units
+uint64_t fileTimeNs(const FILETIME& time) {
+    return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100;
+}
+#else
+uint64_t clockNs(clockid_t clock) {
+    timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+#endif
+}
+
+uint64_t threadCpuTimeNs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0;
+    return fileTimeNs(kernel) + fileTimeNs(user);
+#else
+    return clockNs(CLOCK_THREAD_CPUTIME_ID);
+#endif
+}
+
+uint64_t processCpuTimeNs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+    return fileTimeNs(kernel) + fileTimeNs(user);
+#else
+    return clockNs(CLOCK_PROCESS_CPUTIME_ID);
+#endif
+}
+
+SelfUsageReader::SelfUsageReader() {
+#ifdef __linux__
+    statm_.open("/proc/self/statm");
+    io_.open("/proc/self/io");
+    long page = sysconf(_SC_PAGESIZE);
+    if (page > 0) pageKB_ = static_cast<uint64_t>(page) / 1024;
+#endif
+}
+
+bool SelfUsageReader::read(SelfUsage& usage) {
+#ifdef __linux__
+    long len = statm_.readAll(buffer_, sizeof(buffer_));
+    if (len <= 0) return false;
+    // "size resident shared ..." in pages
+    const char* end = buffer_ + len;
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    const char* p = procscan::parseUint64(buffer_, end, sizePages);
+    if (!p || !procscan::parseUint64(p, end, residentPages)) return false;
+    usage.rssKB = residentPages * pageKB_;
+
+    usage.syscalls = 0;
+    len = io_.readAll(buffer_, sizeof(buffer_));
+    for (p = buffer_, end = buffer_ + (len > 0 ? len : 0); p < end; p = procscan::skipToNextLine(p, end)) {
+        uint64_t value = 0;
+        if (procscan::startsWith(p, end, "syscr:", 6) || procscan::startsWith(p, end, "syscw:", 6)) {
+            procscan::parseUint64(p + 6, end, value);
+            usage.syscalls += value;
+        }
+    }
+    return true;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+        KERN_SUCCESS) {
+        return false;
+    }
+    usage.rssKB = info.resident_size / 1024;
+    usage.syscalls = 0;
+    return true;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return false;
+    usage.rssKB = counters.WorkingSetSize / 1024;
+    usage.syscalls = 0;
+    return true;
+#else
+    (void)usage;
+    return false;
+#endif
+}
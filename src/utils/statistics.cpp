@@ -1,16 +1,409 @@
 #include "utils/statistics.hpp"
+#include "utils/reduce_kernel.hpp"
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <string>
 
+void RunningStats::add(double value, double weight) {
+    if (weight <= 0.0) return;
+    ++count_;
+    if (count_ == 1) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    // West's weighted update; with unit weights this is Welford's
+    weight_ += weight;
+    double delta = value - mean_;
+    mean_ += delta * weight / weight_;
+    m2_ += weight * delta * (value - mean_);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    double total = weight_ + other.weight_;
+    double delta = other.mean_ - mean_;
+    mean_ += delta * other.weight_ / total;
+    m2_ += other.m2_ + delta * delta * (weight_ * other.weight_ / total);
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    count_ += other.count_;
+    weight_ = total;
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+QuantileSketch::QuantileSketch(double resolution, double maxValue, int precisionBits)
+    : resolution_(resolution > 0.0 ? resolution : 1.0),
+      precisionBits_(std::min(std::max(precisionBits, 1), 20)) {
+    double units = std::ceil(std::max(maxValue, 0.0) / resolution_);
+    maxUnits_ = units >= 9.0e18 ? UINT64_MAX >> 1 : static_cast<uint64_t>(units);
+    counts_.assign(indexOf(maxUnits_) + 1, 0);
+}
+
+std::size_t QuantileSketch::indexOf(uint64_t units) const {
+    uint64_t linearLimit = uint64_t(2) << precisionBits_;
+    if (units < linearLimit) return static_cast<std::size_t>(units);
+    // Portable floor(log2(units)) by halving steps
+    int highestBit = 0;
+    uint64_t rest = units;
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if (rest >> shift) {
+            rest >>= shift;
+            highestBit += shift;
+        }
+    }
+    int exponent = highestBit - precisionBits_;
+    uint64_t mantissa = units >> exponent; // in [2^p, 2^(p+1))
+    return static_cast<std::size_t>((uint64_t(exponent) << precisionBits_) + mantissa);
+}
+
+double QuantileSketch::valueAt(std::size_t index) const {
+    uint64_t linearLimit = uint64_t(2) << precisionBits_;
+    if (index < linearLimit) return index * resolution_;
+    uint64_t subBuckets = uint64_t(1) << precisionBits_;
+    uint64_t exponent = index / subBuckets - 1;
+    uint64_t mantissa = index - exponent * subBuckets;
+    // Report the middle of the bucket to halve the worst-case error
+    uint64_t lower = mantissa << exponent;
+    uint64_t width = uint64_t(1) << exponent;
+    return (static_cast<double>(lower) + (width - 1) / 2.0) * resolution_;
+}
+
+void QuantileSketch::add(double value, uint64_t count) {
+    if (count == 0) return;
+    double units = value > 0.0 ? std::floor(value / resolution_ + 0.5) : 0.0;
+    uint64_t quantised = units >= static_cast<double>(maxUnits_) ? maxUnits_ : static_cast<uint64_t>(units);
+    // The extremes see the same clamping as the buckets
+    double clamped = std::min(std::max(value, 0.0), static_cast<double>(maxUnits_) * resolution_);
+    if (total_ == 0) {
+        min_ = max_ = clamped;
+    } else {
+        min_ = std::min(min_, clamped);
+        max_ = std::max(max_, clamped);
+    }
+    counts_[indexOf(quantised)] += count;
+    total_ += static_cast<std::size_t>(count);
+}
+
+bool QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.resolution_ != resolution_ || other.precisionBits_ != precisionBits_ ||
+        other.maxUnits_ != maxUnits_) {
+        return false;
+    }
+    if (other.total_ == 0) return true;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    min_ = total_ ? std::min(min_, other.min_) : other.min_;
+    max_ = total_ ? std::max(max_, other.max_) : other.max_;
+    total_ += other.total_;
+    return true;
+}
+
+void QuantileSketch::clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    min_ = max_ = 0.0;
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (total_ == 0) return 0.0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    std::size_t rank = static_cast<std::size_t>(std::ceil(q * total_));
+    if (rank == 0) rank = 1;
+    // The first and last ranks are the exact extremes
+    if (rank == 1) return min_;
+    if (rank >= total_) return max_;
+    std::size_t seen = 0;
+    std::size_t index = counts_.size() - 1;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            index = i;
+            break;
+        }
+    }
+    return std::min(std::max(valueAt(index), min_), max_);
+}
+
+Percentiles computePercentiles(const QuantileSketch& sketch) {
+    Percentiles p;
+    p.p50 = sketch.quantile(0.50);
+    p.p90 = sketch.quantile(0.90);
+    p.p99 = sketch.quantile(0.99);
+    p.p999 = sketch.quantile(0.999);
+    return p;
+}
+
+void PerCoreAccumulator::reset(std::size_t coreCount) {
+    peak_.assign(coreCount, 0.0);
+    sum_.assign(coreCount, 0.0);
+    samples_ = 0;
+    weight_ = 0.0;
+    imbalanceSum_ = 0.0;
+}
+
+void PerCoreAccumulator::add(const double* row, double weight) {
+    std::size_t cores = peak_.size();
+    if (cores == 0) return;
+    double rowMax = 0.0;
+    double rowSum = 0.0;
+    for (std::size_t c = 0; c < cores; ++c) {
+        double v = row[c];
+        peak_[c] = std::max(peak_[c], v);
+        sum_[c] += v * weight;
+        rowMax = std::max(rowMax, v);
+        rowSum += v;
+    }
+    imbalanceSum_ += (rowMax - rowSum / cores) * weight;
+    weight_ += weight;
+    ++samples_;
+}
+
+void PerCoreSeries::reset(std::size_t coreCount) {
+    data_.clear();
+    cores_ = coreCount;
+    samples_ = 0;
+    capacity_ = 0;
+}
+
+void PerCoreSeries::append(const double* row) {
+    if (cores_ == 0) return;
+    if (samples_ == capacity_) {
+        // Re-lay the columns out at twice the stride; amortised O(cores) per sample
+        std::size_t newCapacity = capacity_ ? capacity_ * 2 : 64;
+        std::vector<double> grown(cores_ * newCapacity);
+        for (std::size_t c = 0; c < cores_; ++c) {
+            std::copy(data_.begin() + c * capacity_, data_.begin() + c * capacity_ + samples_,
+                      grown.begin() + c * newCapacity);
+        }
+        data_.swap(grown);
+        capacity_ = newCapacity;
+    }
+    for (std::size_t c = 0; c < cores_; ++c) {
+        data_[c * capacity_ + samples_] = row[c];
+    }
+    ++samples_;
+}
+
+namespace {
+// One fused (vectorised where available) pass over a recorded series
+ReduceResult reduce(const std::vector<double>& values) {
+    return reduceFused(values.data(), values.size(), values.empty() ? 0.0 : values[0]);
+}
+}
+
+CpuStats computeCpuStats(const RunningStats& cpu) {
+    CpuStats stats;
+    stats.samples = cpu.count();
+    if (stats.samples == 0) return stats;
+    stats.peak = cpu.max();
+    stats.average = cpu.mean();
+    stats.min = cpu.min();
+    stats.max = stats.peak;
+    stats.stddev = cpu.stddev();
+    return stats;
+}
+
+CpuStats computeCpuStats(const RunningStats& cpu, const PerCoreAccumulator& perCore) {
+    CpuStats stats = computeCpuStats(cpu);
+    std::size_t cores = perCore.coreCount();
+    if (cores == 0 || perCore.sampleCount() == 0) return stats;
+
+    stats.corePeak.resize(cores);
+    stats.coreAverage.resize(cores);
+    for (std::size_t c = 0; c < cores; ++c) {
+        stats.corePeak[c] = perCore.peak(c);
+        stats.coreAverage[c] = perCore.average(c);
+        if (stats.coreAverage[c] > stats.coreAverage[stats.busiestCore]) stats.busiestCore = c;
+    }
+    stats.imbalance = perCore.averageImbalance();
+    return stats;
+}
+
+MemoryStats computeMemoryStats(const RunningStats& usedMB, const RunningStats& usedPercent) {
+    MemoryStats stats;
+    stats.samples = usedMB.count();
+    if (usedMB.count() == 0 || usedPercent.count() == 0) return stats;
+    
+    // Memory usage in MB
+    stats.peakUsedMB = static_cast<uint64_t>(usedMB.max());
+    stats.avgUsedMB = static_cast<uint64_t>(usedMB.mean());
+    stats.minUsedMB = static_cast<uint64_t>(usedMB.min());
+    stats.maxUsedMB = stats.peakUsedMB;
+    stats.stddevUsedMB = usedMB.stddev();
+    
+    // Memory usage in percentage
+    stats.peakUsedPercent = usedPercent.max();
+    stats.avgUsedPercent = usedPercent.mean();
+    stats.minUsedPercent = usedPercent.min();
+    stats.maxUsedPercent = stats.peakUsedPercent;
+    stats.stddevUsedPercent = usedPercent.stddev();
+    
+    return stats;
+}
+
+GpuStats computeGpuStats(const RunningStats& utilization, std::size_t gpuCount) {
+    GpuStats stats;
+    stats.samples = utilization.count();
+    stats.gpuCount = gpuCount;
+    
+    if (stats.samples == 0) {
+        return stats;
+    }
+    
+    // GPU utilization stats
+    stats.peakUtilization = utilization.max();
+    stats.avgUtilization = utilization.mean();
+    stats.minUtilization = utilization.min();
+    stats.maxUtilization = stats.peakUtilization;
+    stats.stddevUtilization = utilization.stddev();
+    
+    return stats;
+}
+
+GpuStats computeGpuStats(const RunningStats& utilization, std::size_t gpuCount, const PerCoreAccumulator& perGpu) {
+    GpuStats stats = computeGpuStats(utilization, gpuCount);
+    std::size_t gpus = perGpu.coreCount();
+    if (gpus == 0 || perGpu.sampleCount() == 0) return stats;
+
+    stats.devicePeak.resize(gpus);
+    stats.deviceAverage.resize(gpus);
+    for (std::size_t g = 0; g < gpus; ++g) {
+        stats.devicePeak[g] = perGpu.peak(g);
+        stats.deviceAverage[g] = perGpu.average(g);
+    }
+    return stats;
+}
+
+NpuStats computeNpuStats(const RunningStats& utilization, const std::string& npuName) {
+    NpuStats stats;
+    stats.samples = utilization.count();
+    stats.npuName = npuName;
+    
+    if (stats.samples == 0) {
+        return stats;
+    }
+    
+    // NPU utilization stats
+    stats.peakUtilization = utilization.max();
+    stats.avgUtilization = utilization.mean();
+    stats.minUtilization = utilization.min();
+    stats.maxUtilization = stats.peakUtilization;
+    stats.stddevUtilization = utilization.stddev();
+    
+    return stats;
+}
+
+ProcessStats computeProcessStats(const RunningStats& cpu, const RunningStats& rssKB, const RunningStats& pssKB,
+                                 const ProcessStats& totals) {
+    ProcessStats stats = totals;
+    stats.samples = cpu.count();
+    
+    if (stats.samples == 0) {
+        return stats;
+    }
+    
+    stats.peakCpu = cpu.max();
+    stats.avgCpu = cpu.mean();
+    stats.peakRssKB = static_cast<uint64_t>(rssKB.max());
+    stats.avgRssKB = static_cast<uint64_t>(rssKB.mean());
+    stats.peakPssKB = static_cast<uint64_t>(pssKB.max());
+    stats.avgPssKB = static_cast<uint64_t>(pssKB.mean());
+    
+    return stats;
+}
+
+void accumulateLatency(LatencyStats& stats, const CollectorLatency& sample) {
+    ++stats.samples;
+    double n = static_cast<double>(stats.samples);
+    stats.average.cpuMs += (sample.cpuMs - stats.average.cpuMs) / n;
+    stats.average.memoryMs += (sample.memoryMs - stats.average.memoryMs) / n;
+    stats.average.gpuMs += (sample.gpuMs - stats.average.gpuMs) / n;
+    stats.average.npuMs += (sample.npuMs - stats.average.npuMs) / n;
+    stats.max.cpuMs = std::max(stats.max.cpuMs, sample.cpuMs);
+    stats.max.memoryMs = std::max(stats.max.memoryMs, sample.memoryMs);
+    stats.max.gpuMs = std::max(stats.max.gpuMs, sample.gpuMs);
+    stats.max.npuMs = std::max(stats.max.npuMs, sample.npuMs);
+}
+
+bool accumulateOverhead(OverheadStats& stats, const TickOverhead& tick) {
+    ++stats.ticks;
+    double n = static_cast<double>(stats.ticks);
+    double tickCpuMs = tick.collectCpuMs + tick.outputCpuMs;
+    stats.averageCollectorCpu.cpuMs += (tick.collectorCpu.cpuMs - stats.averageCollectorCpu.cpuMs) / n;
+    stats.averageCollectorCpu.memoryMs += (tick.collectorCpu.memoryMs - stats.averageCollectorCpu.memoryMs) / n;
+    stats.averageCollectorCpu.gpuMs += (tick.collectorCpu.gpuMs - stats.averageCollectorCpu.gpuMs) / n;
+    stats.averageCollectorCpu.npuMs += (tick.collectorCpu.npuMs - stats.averageCollectorCpu.npuMs) / n;
+    stats.averageTickCpuMs += (tickCpuMs - stats.averageTickCpuMs) / n;
+    stats.maxTickCpuMs = std::max(stats.maxTickCpuMs, tickCpuMs);
+    stats.averageCollectCpuMs += (tick.collectCpuMs - stats.averageCollectCpuMs) / n;
+    stats.averageOutputWallMs += (tick.outputWallMs - stats.averageOutputWallMs) / n;
+    stats.maxOutputWallMs = std::max(stats.maxOutputWallMs, tick.outputWallMs);
+    stats.averageOutputCpuMs += (tick.outputCpuMs - stats.averageOutputCpuMs) / n;
+    stats.averageRssKB += (static_cast<double>(tick.rssKB) - stats.averageRssKB) / n;
+    stats.peakRssKB = std::max(stats.peakRssKB, tick.rssKB);
+    stats.averageSyscalls += (static_cast<double>(tick.syscalls) - stats.averageSyscalls) / n;
+
+    if (stats.budgetPercent <= 0.0 || stats.tickCpuPercent(tickCpuMs) <= stats.budgetPercent) return true;
+    ++stats.overBudgetTicks;
+    return false;
+}
+
 CpuStats computeCpuStats(const std::vector<double>& values) {
     CpuStats stats;
     stats.samples = values.size();
     if (values.empty()) return stats;
-    stats.peak = *std::max_element(values.begin(), values.end());
-    stats.average = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
-    stats.min = *std::min_element(values.begin(), values.end());
+    ReduceResult r = reduce(values);
+    stats.peak = r.max;
+    stats.average = r.mean();
+    stats.min = r.min;
     stats.max = stats.peak;
+    stats.stddev = std::sqrt(r.variance());
+    return stats;
+}
+
+CpuStats computeCpuStats(const std::vector<double>& values, const PerCoreSeries& perCore) {
+    CpuStats stats = computeCpuStats(values);
+    std::size_t cores = perCore.coreCount();
+    std::size_t n = perCore.sampleCount();
+    if (cores == 0 || n == 0) return stats;
+
+    stats.corePeak.assign(cores, 0.0);
+    stats.coreAverage.assign(cores, 0.0);
+    // Walk column by column; the per-sample max and sum are folded in as we go
+    std::vector<double> rowMax(n, 0.0);
+    std::vector<double> rowSum(n, 0.0);
+    for (std::size_t c = 0; c < cores; ++c) {
+        const double* column = perCore.column(c);
+        double peak = 0.0;
+        double sum = 0.0;
+        for (std::size_t t = 0; t < n; ++t) {
+            double v = column[t];
+            peak = std::max(peak, v);
+            sum += v;
+            rowMax[t] = std::max(rowMax[t], v);
+            rowSum[t] += v;
+        }
+        stats.corePeak[c] = peak;
+        stats.coreAverage[c] = sum / n;
+        if (stats.coreAverage[c] > stats.coreAverage[stats.busiestCore]) stats.busiestCore = c;
+    }
+
+    double imbalanceSum = 0.0;
+    for (std::size_t t = 0; t < n; ++t) {
+        imbalanceSum += rowMax[t] - rowSum[t] / cores;
+    }
+    stats.imbalance = imbalanceSum / n;
     return stats;
 }
 
@@ -20,16 +413,21 @@ MemoryStats computeMemoryStats(const std::vector<uint64_t>& usedMB, const std::v
     if (usedMB.empty() || usedPercent.empty()) return stats;
     
     // Memory usage in MB
-    stats.peakUsedMB = *std::max_element(usedMB.begin(), usedMB.end());
-    stats.avgUsedMB = std::accumulate(usedMB.begin(), usedMB.end(), 0ULL) / usedMB.size();
-    stats.minUsedMB = *std::min_element(usedMB.begin(), usedMB.end());
+    uint64_t totalMB = 0;
+    ReduceResult mb = reduceFused(usedMB.data(), usedMB.size(), static_cast<double>(usedMB[0]), totalMB);
+    stats.peakUsedMB = static_cast<uint64_t>(mb.max);
+    stats.avgUsedMB = totalMB / usedMB.size();
+    stats.minUsedMB = static_cast<uint64_t>(mb.min);
     stats.maxUsedMB = stats.peakUsedMB;
+    stats.stddevUsedMB = std::sqrt(mb.variance());
     
     // Memory usage in percentage
-    stats.peakUsedPercent = *std::max_element(usedPercent.begin(), usedPercent.end());
-    stats.avgUsedPercent = std::accumulate(usedPercent.begin(), usedPercent.end(), 0.0) / usedPercent.size();
-    stats.minUsedPercent = *std::min_element(usedPercent.begin(), usedPercent.end());
+    ReduceResult percent = reduce(usedPercent);
+    stats.peakUsedPercent = percent.max;
+    stats.avgUsedPercent = percent.mean();
+    stats.minUsedPercent = percent.min;
     stats.maxUsedPercent = stats.peakUsedPercent;
+    stats.stddevUsedPercent = std::sqrt(percent.variance());
     
     return stats;
 }
@@ -44,10 +442,12 @@ GpuStats computeGpuStats(const std::vector<double>& utilization, std::size_t gpu
     }
     
     // GPU utilization stats
-    stats.peakUtilization = *std::max_element(utilization.begin(), utilization.end());
-    stats.avgUtilization = std::accumulate(utilization.begin(), utilization.end(), 0.0) / utilization.size();
-    stats.minUtilization = *std::min_element(utilization.begin(), utilization.end());
+    ReduceResult r = reduce(utilization);
+    stats.peakUtilization = r.max;
+    stats.avgUtilization = r.mean();
+    stats.minUtilization = r.min;
     stats.maxUtilization = stats.peakUtilization;
+    stats.stddevUtilization = std::sqrt(r.variance());
     
     return stats;
 }
@@ -62,14 +462,22 @@ NpuStats computeNpuStats(const std::vector<double>& utilization, const std::stri
     }
     
     // NPU utilization stats
-    stats.peakUtilization = *std::max_element(utilization.begin(), utilization.end());
-    stats.avgUtilization = std::accumulate(utilization.begin(), utilization.end(), 0.0) / utilization.size();
-    stats.minUtilization = *std::min_element(utilization.begin(), utilization.end());
+    ReduceResult r = reduce(utilization);
+    stats.peakUtilization = r.max;
+    stats.avgUtilization = r.mean();
+    stats.minUtilization = r.min;
     stats.maxUtilization = stats.peakUtilization;
+    stats.stddevUtilization = std::sqrt(r.variance());
     
     return stats;
 }
 
+LatencyStats computeLatencyStats(const std::vector<CollectorLatency>& latencies) {
+    LatencyStats stats;
+    for (const auto& l : latencies) accumulateLatency(stats, l);
+    return stats;
+}
+
 double computePeak(const std::vector<double>& values) {
     return values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
 }
@@ -84,4 +492,4 @@ double computeMin(const std::vector<double>& values) {
 
 double computeMax(const std::vector<double>& values) {
     return values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
-} 
\ No newline at end of file
+}
@@ -0,0 +1,69 @@
+#include "utils/timeseries_store.hpp"
+#include <algorithm>
+#include <cmath>
+
+TimeSeriesStore::TimeSeriesStore(const TimeSeriesConfig& config)
+    : tierConfig_(config.tiers), rawTimestamps_(config.rawCapacity) {
+    for (auto& tier : tierConfig_) {
+        if (tier.bucketMs <= 0) tier.bucketMs = 1;
+    }
+    rawValues_.reserve(MetricCount);
+    for (int m = 0; m < MetricCount; ++m) {
+        rawValues_.emplace_back(config.rawCapacity);
+    }
+    tiers_.reserve(MetricCount * tierConfig_.size());
+    for (int m = 0; m < MetricCount; ++m) {
+        for (const auto& tier : tierConfig_) {
+            tiers_.push_back(MetricTier{RingBuffer<RollupBucket>(tier.capacity), RollupBucket()});
+        }
+    }
+}
+
+void TimeSeriesStore::add(int64_t timestampMs, const double* values) {
+    rawTimestamps_.push(timestampMs);
+    std::size_t tierCount = tierConfig_.size();
+    for (int m = 0; m < MetricCount; ++m) {
+        double value = values[m];
+        rawValues_[m].push(value);
+        if (std::isnan(value)) continue;
+        for (std::size_t t = 0; t < tierCount; ++t) {
+            int64_t width = tierConfig_[t].bucketMs;
+            int64_t start = timestampMs - ((timestampMs % width) + width) % width;
+            MetricTier& tier = tiers_[m * tierCount + t];
+            RollupBucket& open = tier.open;
+            if (open.count > 0 && open.startMs != start) {
+                tier.closed.push(open);
+                open.count = 0;
+            }
+            if (open.count == 0) {
+                open.startMs = start;
+                open.min = open.max = value;
+                open.sum = 0.0;
+            } else {
+                open.min = std::min(open.min, value);
+                open.max = std::max(open.max, value);
+            }
+            open.sum += value;
+            ++open.count;
+        }
+    }
+}
+
+const RingBuffer<RollupBucket>& TimeSeriesStore::tier(Metric metric, std::size_t tier) const {
+    return tiers_[metric * tierConfig_.size() + tier].closed;
+}
+
+const RollupBucket& TimeSeriesStore::openBucket(Metric metric, std::size_t tier) const {
+    return tiers_[metric * tierConfig_.size() + tier].open;
+}
+
+std::size_t TimeSeriesStore::footprintBytes() const {
+    std::size_t bytes = rawTimestamps_.capacity() * sizeof(int64_t);
+    for (const auto& values : rawValues_) {
+        bytes += values.capacity() * sizeof(double);
+    }
+    for (const auto& tier : tiers_) {
+        bytes += (tier.closed.capacity() + 1) * sizeof(RollupBucket);
+    }
+    return bytes;
+}
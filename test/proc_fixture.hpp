@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Helpers for building a fake procfs tree under the temp directory, shared by
+// the tests of the readers that take a proc root
+namespace procfixture {
+
+inline std::filesystem::path makeFixtureRoot(const std::string& name) {
+    auto root = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    return root;
+}
+
+// Rewrites the file in place so an already open descriptor sees the new contents
+inline void writeFile(const std::filesystem::path& path, const std::string& contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::trunc);
+    out << contents;
+}
+
+// The /proc/PID/stat fields the readers parse; the rest are fixed
+struct PidStat {
+    int ppid = 1;
+    uint64_t minorFaults = 10;
+    uint64_t majorFaults = 0;
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    uint64_t startTime = 100;
+    uint64_t rssPages = 64;
+};
+
+// A full /proc/PID/stat line; tpgid, priority and nice are negative as they
+// are for many real processes
+inline std::string pidStatLine(int pid, const std::string& comm, const PidStat& fields) {
+    std::string id = std::to_string(pid);
+    return id + " (" + comm + ") S " + std::to_string(fields.ppid) + " " + id + " " + id + " 0 -1 4194304 " +
+           std::to_string(fields.minorFaults) + " 0 " + std::to_string(fields.majorFaults) + " 0 " +
+           std::to_string(fields.utime) + " " + std::to_string(fields.stime) + " 0 0 -2 -5 4 0 " +
+           std::to_string(fields.startTime) + " 104857600 " + std::to_string(fields.rssPages) +
+           " 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 1 0 0 0 0 0\n";
+}
+
+inline void writePidStat(const std::filesystem::path& root, int pid, const std::string& comm,
+                         const PidStat& fields) {
+    writeFile(root / std::to_string(pid) / "stat", pidStatLine(pid, comm, fields));
+}
+
+} // namespace procfixture
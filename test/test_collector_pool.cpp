@@ -0,0 +1,80 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include "utils/collector_pool.hpp"
+#include "utils/self_usage.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST_CASE("CollectorPool runs every job once per tick", "[pool]") {
+    CollectorPool pool;
+    int counts[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        pool.addJob([&counts, i] { ++counts[i]; });
+    }
+    REQUIRE(pool.jobCount() == 4);
+
+    for (int tick = 0; tick < 100; ++tick) {
+        pool.runAll();
+        // runAll is a barrier, so every job has finished this tick
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(counts[i] == tick + 1);
+        }
+    }
+}
+
+TEST_CASE("CollectorPool tick costs the slowest job, not the sum", "[pool]") {
+    CollectorPool pool;
+    for (int i = 0; i < 4; ++i) {
+        pool.addJob([] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); });
+    }
+    pool.runAll(); // spin up workers outside the timed tick
+
+    auto begin = std::chrono::steady_clock::now();
+    pool.runAll();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    // Sequentially this would take 200 ms
+    REQUIRE(elapsed < std::chrono::milliseconds(150));
+}
+
+TEST_CASE("CollectorPool records per-job latency", "[pool]") {
+    CollectorPool pool;
+    std::size_t fast = pool.addJob([] {});
+    std::size_t slow = pool.addJob([] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    pool.runAll();
+    REQUIRE(pool.lastLatencyMs(slow) >= 19.0);
+    REQUIRE(pool.lastLatencyMs(fast) < pool.lastLatencyMs(slow));
+}
+
+TEST_CASE("CollectorPool records per-job thread CPU time", "[pool]") {
+    CollectorPool pool;
+    std::size_t sleeper = pool.addJob([] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    // Spins on its own CPU clock, so it uses 20 ms of CPU however busy the host is
+    std::size_t spinner = pool.addJob([] {
+        uint64_t until = threadCpuTimeNs() + 20000000;
+        while (threadCpuTimeNs() < until) {
+        }
+    });
+    pool.runAll();
+    // Sleeping costs wall time but next to no CPU; spinning costs both
+    REQUIRE(pool.lastLatencyMs(sleeper) >= 19.0);
+    REQUIRE(pool.lastCpuMs(spinner) >= 19.0);
+    REQUIRE(pool.lastCpuMs(spinner) <= pool.lastLatencyMs(spinner) + 1.0);
+    REQUIRE(pool.lastCpuMs(sleeper) < pool.lastCpuMs(spinner));
+}
+
+TEST_CASE("SelfUsageReader reports the process's own footprint", "[pool]") {
+    SelfUsageReader reader;
+    SelfUsage usage;
+    REQUIRE(reader.read(usage));
+    REQUIRE(usage.rssKB > 0);
+    uint64_t threadNs = threadCpuTimeNs();
+    REQUIRE(threadNs > 0);
+    REQUIRE(processCpuTimeNs() >= threadNs);
+}
+
+TEST_CASE("CollectorPool without jobs is a no-op", "[pool]") {
+    CollectorPool pool;
+    pool.runAll();
+    REQUIRE(pool.jobCount() == 0);
+}
@@ -0,0 +1,128 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/console_line.hpp"
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace {
+std::string fixed1(double value) {
+    LineBuffer line;
+    line.appendFixed1(value);
+    return std::string(line.data(), line.size());
+}
+
+std::string render(double cpu, const MemoryUsage& memory, const GpuUsage& gpu, const double* npu = nullptr) {
+    LineBuffer line;
+    formatTickLine(line, &cpu, &memory, &gpu, npu);
+    return std::string(line.data(), line.size());
+}
+
+MemoryUsage memoryOf(uint64_t usedMB, double percent) {
+    MemoryUsage memory = {};
+    memory.usedPhysicalMB = usedMB;
+    memory.usedPercentage = percent;
+    return memory;
+}
+
+GpuUsage gpusOf(std::initializer_list<double> values, double average) {
+    GpuUsage gpu;
+    for (double v : values) gpu.gpus.push_back({"GPU", v, 0, 0});
+    gpu.averageUtilization = average;
+    return gpu;
+}
+}
+
+TEST_CASE("appendFixed1 matches iostream fixed formatting", "[console]") {
+    REQUIRE(fixed1(0.0) == "0.0");
+    REQUIRE(fixed1(12.34) == "12.3");
+    REQUIRE(fixed1(99.96) == "100.0");
+    REQUIRE(fixed1(7.0) == "7.0");
+    REQUIRE(fixed1(-3.27) == "-3.3");
+    REQUIRE(fixed1(-0.01) == "-0.0");
+    REQUIRE(fixed1(std::numeric_limits<double>::quiet_NaN()) == "nan");
+    REQUIRE(fixed1(std::numeric_limits<double>::infinity()) == "inf");
+
+    for (double v : {0.04, 1.26, 33.333, 50.07, 87.61, 100.0, 1234.56}) {
+        std::ostringstream expected;
+        expected << std::fixed << std::setprecision(1) << v;
+        INFO(v);
+        REQUIRE(fixed1(v) == expected.str());
+    }
+}
+
+TEST_CASE("formatTickLine renders the single GPU status line", "[console]") {
+    REQUIRE(render(12.5, memoryOf(8192, 50.0), gpusOf({20.0}, 20.0)) ==
+            "CPU: 12.5% | Memory: 8192 MB (50.0%) | GPU: 20.0%\n");
+    REQUIRE(render(3.0, memoryOf(1024, 6.26), gpusOf({}, 0.0)) ==
+            "CPU: 3.0% | Memory: 1024 MB (6.3%) | GPU: 0.0%\n");
+}
+
+TEST_CASE("formatTickLine lists every GPU and the NPU when present", "[console]") {
+    double npu = 4.44;
+    REQUIRE(render(1.0, memoryOf(2048, 25.0), gpusOf({10.0, 30.0}, 20.0), &npu) ==
+            "CPU: 1.0% | Memory: 2048 MB (25.0%) | GPUs: 10.0%, 30.0% (avg: 20.0%) | NPU: 4.4%\n");
+}
+
+TEST_CASE("formatTickLine leaves out sources that are not collected", "[console]") {
+    LineBuffer line;
+    double cpu = 7.25;
+    MemoryUsage memory = memoryOf(512, 3.0);
+    formatTickLine(line, &cpu, nullptr, nullptr, nullptr);
+    REQUIRE(std::string(line.data(), line.size()) == "CPU: 7.2%\n");
+    formatTickLine(line, nullptr, &memory, nullptr, nullptr);
+    REQUIRE(std::string(line.data(), line.size()) == "Memory: 512 MB (3.0%)\n");
+}
+
+TEST_CASE("LineBuffer truncates instead of overflowing", "[console]") {
+    LineBuffer line;
+    std::string chunk(100, 'x');
+    for (int i = 0; i < 10; ++i) line.append(chunk.data(), chunk.size());
+    line.appendUint(12345);
+    REQUIRE(line.size() == LineBuffer::kCapacity);
+}
+
+TEST_CASE("DisplayThrottle lets at most N lines through per second", "[console]") {
+    using namespace std::chrono;
+    steady_clock::time_point t0{};
+
+    DisplayThrottle every;
+    REQUIRE(every.shouldDisplay(t0));
+    REQUIRE(every.shouldDisplay(t0));
+
+    // 100 Hz sampling displayed at 4 lines per second
+    DisplayThrottle throttle(4.0);
+    int shown = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (throttle.shouldDisplay(t0 + milliseconds(10 * i))) ++shown;
+    }
+    REQUIRE(shown == 4);
+    REQUIRE(throttle.shouldDisplay(t0 + milliseconds(1000)));
+    REQUIRE_FALSE(throttle.shouldDisplay(t0 + milliseconds(1100)));
+}
+
+TEST_CASE("Console line formatting, to_chars vs iostream", "[.][benchmark]") {
+    MemoryUsage memory = memoryOf(12345, 61.7);
+    GpuUsage gpu = gpusOf({12.3, 45.6}, 28.95);
+    double npu = 3.2;
+
+    BENCHMARK("LineBuffer") {
+        LineBuffer line;
+        double cpu = 42.42;
+        formatTickLine(line, &cpu, &memory, &gpu, &npu);
+        return line.size();
+    };
+    BENCHMARK("ostringstream") {
+        std::ostringstream out;
+        out << "CPU: " << std::fixed << std::setprecision(1) << 42.42 << "% | Memory: " << memory.usedPhysicalMB
+            << " MB (" << memory.usedPercentage << "%) | GPUs: ";
+        for (std::size_t i = 0; i < gpu.gpus.size(); ++i) {
+            if (i > 0) out << ", ";
+            out << gpu.gpus[i].utilizationPercent << "%";
+        }
+        out << " (avg: " << gpu.averageUtilization << "%) | NPU: " << npu << "%\n";
+        return out.str().size();
+    };
+}
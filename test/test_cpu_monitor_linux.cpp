@@ -0,0 +1,109 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "cpu_monitor.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+extern ICpuMonitor* createCpuMonitor();
+
+namespace {
+std::filesystem::path makeFixtureRoot(const std::string& name) {
+    auto root = std::filesystem::temp_directory_path() / name;
+    std::filesystem::create_directories(root);
+    return root;
+}
+
+// Rewrites the file in place so an already open descriptor sees the new contents
+void writeStat(const std::filesystem::path& root, const std::string& cpuLine,
+               const std::string& coreLines = "cpu0 1 2 3 4 5 6 7 8 0 0\n") {
+    std::ofstream out(root / "stat", std::ios::trunc);
+    out << cpuLine << "\n"
+        << coreLines
+        << "intr 12345 0 0 0\n"
+        << "ctxt 6789\n";
+}
+}
+
+TEST_CASE("LinuxCpuMonitor basic functionality", "[linux][cpu]") {
+    ICpuMonitor* monitor = createCpuMonitor();
+    REQUIRE(monitor->isSupported());
+    // Take two samples to allow delta calculation
+    monitor->getCpuBusy();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    double busy = monitor->getCpuBusy();
+    // CPU busy should be between 0 and 100
+    REQUIRE(busy >= 0.0);
+    REQUIRE(busy <= 100.0);
+    delete monitor;
+}
+
+TEST_CASE("LinuxCpuMonitor computes busy from /proc/stat tick deltas", "[linux][cpu]") {
+    auto root = makeFixtureRoot("crossmon_cpu_fixture");
+    //                user nice system idle iowait irq softirq steal guest guest_nice
+    writeStat(root, "cpu  100 0 100 700 100 0 0 0 50 0");
+    ICpuMonitor* monitor = createLinuxCpuMonitor(root.string());
+    REQUIRE(monitor->isSupported());
+
+    // +300 busy ticks (user/system/irq) and +100 idle/iowait ticks
+    writeStat(root, "cpu  250 0 200 750 150 50 0 0 80 0");
+    REQUIRE(monitor->getCpuBusy() == Catch::Approx(75.0));
+
+    // No progress at all reports idle instead of dividing by zero
+    REQUIRE(monitor->getCpuBusy() == 0.0);
+
+    // Fully idle interval
+    writeStat(root, "cpu  250 0 200 850 150 50 0 0 80 0");
+    REQUIRE(monitor->getCpuBusy() == Catch::Approx(0.0));
+
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxCpuMonitor tolerates kernels with fewer columns", "[linux][cpu]") {
+    auto root = makeFixtureRoot("crossmon_cpu_fixture_old");
+    writeStat(root, "cpu  10 0 10 80");
+    ICpuMonitor* monitor = createLinuxCpuMonitor(root.string());
+    writeStat(root, "cpu  30 0 30 120");
+    REQUIRE(monitor->getCpuBusy() == Catch::Approx(50.0));
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxCpuMonitor reports unsupported without /proc/stat", "[linux][cpu]") {
+    ICpuMonitor* monitor = createLinuxCpuMonitor("/nonexistent-crossmon-root");
+    REQUIRE_FALSE(monitor->isSupported());
+    REQUIRE(monitor->getCpuBusy() == 0.0);
+    delete monitor;
+}
+
+TEST_CASE("LinuxCpuMonitor reports per-core busy into a caller buffer", "[linux][cpu][percore]") {
+    auto root = makeFixtureRoot("crossmon_cpu_fixture_cores");
+    writeStat(root, "cpu  0 0 0 400 0 0 0 0 0 0",
+              "cpu0 0 0 0 100 0 0 0 0 0 0\n"
+              "cpu1 0 0 0 100 0 0 0 0 0 0\n"
+              "cpu3 0 0 0 100 0 0 0 0 0 0\n"); // cpu2 offline
+    ICpuMonitor* monitor = createLinuxCpuMonitor(root.string());
+    REQUIRE(monitor->getCoreCount() == 4);
+
+    writeStat(root, "cpu  150 0 0 650 0 0 0 0 0 0",
+              "cpu0 100 0 0 100 0 0 0 0 0 0\n"  // pegged
+              "cpu1 25 0 0 175 0 0 0 0 0 0\n"   // 25%
+              "cpu3 25 0 0 175 0 0 0 0 0 0\n");
+    double busy[4] = {-1.0, -1.0, -1.0, -1.0};
+    REQUIRE(monitor->getPerCoreBusy(busy, 4) == 4);
+    REQUIRE(busy[0] == Catch::Approx(100.0));
+    REQUIRE(busy[1] == Catch::Approx(25.0));
+    REQUIRE(busy[2] == 0.0);
+    REQUIRE(busy[3] == Catch::Approx(25.0));
+
+    // A smaller caller buffer is filled up to its capacity only
+    double first[2] = {-1.0, -1.0};
+    REQUIRE(monitor->getPerCoreBusy(first, 2) == 2);
+    REQUIRE(first[0] == 0.0);
+
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
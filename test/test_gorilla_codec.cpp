@@ -0,0 +1,112 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include "utils/gorilla_codec.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+TEST_CASE("BitWriter and BitReader round-trip arbitrary widths", "[gorilla]") {
+    std::vector<uint8_t> bytes;
+    BitWriter out(bytes);
+    std::mt19937_64 rng(7);
+    std::vector<std::pair<uint64_t, int>> written;
+    for (int i = 0; i < 5000; ++i) {
+        int width = 1 + static_cast<int>(rng() % 64);
+        uint64_t value = rng();
+        if (width < 64) value &= (uint64_t(1) << width) - 1;
+        out.writeBits(value, width);
+        written.emplace_back(value, width);
+    }
+    out.flush();
+    bytes.resize(bytes.size() + kBitReaderPadding);
+
+    BitReader in(bytes.data(), bytes.size() - kBitReaderPadding);
+    for (const auto& entry : written) {
+        REQUIRE(in.readBits(entry.second) == entry.first);
+    }
+    REQUIRE_FALSE(in.overrun());
+}
+
+TEST_CASE("TimestampColumnCodec is lossless and one bit per regular tick", "[gorilla]") {
+    std::vector<int64_t> timestamps;
+    int64_t t = 1700000000000000000LL;
+    for (int i = 0; i < 1000; ++i) {
+        timestamps.push_back(t);
+        t += 1000000000LL;
+    }
+    // Jitter, a long pause and a clock step backwards
+    timestamps.push_back(t + 153211);
+    timestamps.push_back(t + 1000000000LL);
+    timestamps.push_back(t + 3600LL * 1000000000LL);
+    timestamps.push_back(t - 5000000000LL);
+
+    std::vector<uint8_t> bytes;
+    BitWriter out(bytes);
+    TimestampColumnCodec encoder;
+    encoder.reset(timestamps[0]);
+    for (int64_t ts : timestamps) encoder.encode(out, ts);
+    out.flush();
+    bytes.resize(bytes.size() + kBitReaderPadding);
+    // ~1000 one-bit ticks plus one first delta and a handful of irregular ones
+    REQUIRE(bytes.size() - kBitReaderPadding < 160);
+
+    BitReader in(bytes.data(), bytes.size() - kBitReaderPadding);
+    TimestampColumnCodec decoder;
+    decoder.reset(timestamps[0]);
+    for (int64_t ts : timestamps) REQUIRE(decoder.decode(in) == ts);
+}
+
+TEST_CASE("FloatColumnCodec preserves exact bit patterns", "[gorilla]") {
+    std::vector<double> values = {0.0, 0.0, 12.5, 12.5, 12.625, 100.0, -0.0, 3.141592653589793,
+                                  std::numeric_limits<double>::infinity(), 1e-300, 1e300, 42.0};
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    for (int i = 0; i < 1000; ++i) values.push_back(dist(rng));
+
+    std::vector<uint8_t> bytes;
+    BitWriter out(bytes);
+    FloatColumnCodec encoder;
+    for (double v : values) encoder.encode(out, v);
+    out.flush();
+    bytes.resize(bytes.size() + kBitReaderPadding);
+
+    BitReader in(bytes.data(), bytes.size() - kBitReaderPadding);
+    FloatColumnCodec decoder;
+    for (double v : values) {
+        double decoded = decoder.decode(in);
+        REQUIRE(std::memcmp(&decoded, &v, sizeof(v)) == 0);
+    }
+}
+
+TEST_CASE("FloatColumnCodec compresses slowly changing utilization", "[gorilla]") {
+    // Per-core busy values from 100 Hz tick counters are whole percentages
+    std::vector<uint8_t> bytes;
+    BitWriter out(bytes);
+    FloatColumnCodec encoder;
+    std::mt19937 rng(3);
+    double value = 20.0;
+    const int count = 10000;
+    for (int i = 0; i < count; ++i) {
+        if (rng() % 4 == 0) value = std::fmin(100.0, std::fmax(0.0, value + static_cast<int>(rng() % 5) - 2));
+        encoder.encode(out, value);
+    }
+    out.flush();
+    bytes.resize(bytes.size() + kBitReaderPadding);
+    REQUIRE((bytes.size() - kBitReaderPadding) * 4 < count * sizeof(double));
+}
+
+TEST_CASE("UintColumnCodec round-trips deltas in both directions", "[gorilla]") {
+    std::vector<uint64_t> values = {0, 16384, 16384, 16390, 16000, 0, ~uint64_t(0), 5, 5, 5};
+    std::vector<uint8_t> bytes;
+    BitWriter out(bytes);
+    UintColumnCodec encoder;
+    for (uint64_t v : values) encoder.encode(out, v);
+    out.flush();
+    bytes.resize(bytes.size() + kBitReaderPadding);
+
+    BitReader in(bytes.data(), bytes.size() - kBitReaderPadding);
+    UintColumnCodec decoder;
+    for (uint64_t v : values) REQUIRE(decoder.decode(in) == v);
+}
@@ -0,0 +1,113 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "gpu_monitor.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+extern IGpuMonitor* createGpuMonitor();
+
+namespace {
+uint64_t fakeNowNs = 0;
+uint64_t fakeClock() { return fakeNowNs; }
+
+// Works on a copy, so the checked-in fixture can be edited between samples
+std::filesystem::path copyFixture(const std::string& name) {
+    auto root = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(root);
+    std::filesystem::copy(std::filesystem::path(CROSSMON_FIXTURE_DIR) / "linux_gpu", root,
+                          std::filesystem::copy_options::recursive | std::filesystem::copy_options::copy_symlinks);
+    return root;
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& text) {
+    std::ofstream(path) << text;
+}
+
+std::string i915Client(int id, uint64_t renderNs, uint64_t videoNs) {
+    return "pos:\t0\nflags:\t02100002\ndrm-driver:\ti915\ndrm-client-id:\t" + std::to_string(id) +
+           "\ndrm-pdev:\t0000:00:02.0\ndrm-engine-render:\t" + std::to_string(renderNs) +
+           " ns\ndrm-engine-video:\t" + std::to_string(videoNs) + " ns\ndrm-engine-capacity-video:\t2\n";
+}
+}
+
+TEST_CASE("LinuxGpuMonitor basic functionality", "[linux][gpu]") {
+    IGpuMonitor* monitor = createGpuMonitor();
+    REQUIRE(monitor != nullptr);
+    GpuUsage usage = monitor->getGpuUsage();
+    REQUIRE(usage.gpus.size() == monitor->getGpuCount());
+    REQUIRE(monitor->isSupported() == (monitor->getGpuCount() > 0));
+    REQUIRE(usage.averageUtilization >= 0.0);
+    REQUIRE(usage.averageUtilization <= 100.0);
+    delete monitor;
+}
+
+TEST_CASE("LinuxGpuMonitor reads DRM sysfs and client engine counters", "[linux][gpu]") {
+    auto root = copyFixture("crossmon_gpu_fixture");
+    auto sys = root / "sys";
+    auto proc = root / "proc";
+    fakeNowNs = 1000000000;
+    IGpuMonitor* monitor = createLinuxGpuMonitor(sys.string(), proc.string(), fakeClock);
+    REQUIRE(monitor->isSupported());
+    REQUIRE(monitor->getGpuCount() == 2); // Connectors and render nodes are not cards
+
+    // One second later: the client behind fds 4 and 5 (the same client id)
+    // ran 250 ms of render work; client 9 kept both video engines half busy
+    fakeNowNs += 1000000000;
+    writeFile(proc / "1200/fdinfo/4", i915Client(7, 2250000000, 0));
+    writeFile(proc / "1200/fdinfo/5", i915Client(7, 2250000000, 0));
+    writeFile(proc / "1300/fdinfo/3", i915Client(9, 500000000, 9000000000));
+    writeFile(sys / "class/drm/card1/device/hwmon/hwmon5/energy1_input", "1040000000\n");
+
+    GpuUsage usage = monitor->getGpuUsage();
+    REQUIRE(usage.gpus.size() == 2);
+    const GpuInfo& amd = usage.gpus[0];
+    REQUIRE(amd.name == "AMD Radeon RX 6800 XT");
+    REQUIRE(amd.utilizationPercent == Catch::Approx(37.0));
+    REQUIRE(amd.temperature == 54);
+    REQUIRE(amd.powerUsage == 87);
+    const GpuInfo& intel = usage.gpus[1];
+    REQUIRE(intel.name == "i915 0000:00:02.0");
+    REQUIRE(intel.utilizationPercent == Catch::Approx(50.0)); // Video: 1 s over 2 engines beats render's 25%
+    REQUIRE(intel.temperature == 61);
+    REQUIRE(intel.powerUsage == 40); // 40 J over 1 s
+    REQUIRE(usage.averageUtilization == Catch::Approx(43.5));
+
+    // Client 9 goes away; client 7 runs 100 ms of render work in half a second
+    fakeNowNs += 500000000;
+    writeFile(proc / "1300/fdinfo/3", "");
+    writeFile(proc / "1200/fdinfo/4", i915Client(7, 2350000000, 0));
+    writeFile(proc / "1200/fdinfo/5", i915Client(7, 2350000000, 0));
+    usage = monitor->getGpuUsage();
+    REQUIRE(usage.gpus[1].utilizationPercent == Catch::Approx(20.0));
+    REQUIRE(usage.gpus[1].powerUsage == 0); // Energy counter did not move
+
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxGpuMonitor without DRM cards", "[linux][gpu]") {
+    auto root = std::filesystem::temp_directory_path() / "crossmon_gpu_empty";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "class/drm");
+    IGpuMonitor* monitor = createLinuxGpuMonitor(root.string(), root.string());
+    REQUIRE_FALSE(monitor->isSupported());
+    REQUIRE(monitor->getGpuCount() == 0);
+    GpuUsage usage = monitor->getGpuUsage();
+    REQUIRE(usage.gpus.empty());
+    REQUIRE(usage.averageUtilization == 0.0);
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxGpuMonitor sample cost", "[.][benchmark][gpu]") {
+    auto root = copyFixture("crossmon_gpu_bench");
+    IGpuMonitor* monitor = createLinuxGpuMonitor((root / "sys").string(), (root / "proc").string());
+    BENCHMARK("getGpuUsage, two cards and two fdinfo clients") {
+        return monitor->getGpuUsage();
+    };
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,114 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "memory_monitor.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+extern IMemoryMonitor* createMemoryMonitor();
+
+namespace {
+// Trimmed from a 16 GB host with most of its RAM in page cache
+const char* kMeminfo =
+    "MemTotal:       16384000 kB\n"
+    "MemFree:          512000 kB\n"
+    "MemAvailable:   12288000 kB\n"
+    "Buffers:          204800 kB\n"
+    "Cached:         11264000 kB\n"
+    "SwapCached:            0 kB\n"
+    "Active:          4096000 kB\n"
+    "Inactive:        8192000 kB\n"
+    "SwapTotal:       2097152 kB\n"
+    "SwapFree:        1048576 kB\n"
+    "Dirty:             10240 kB\n"
+    "Writeback:          2048 kB\n"
+    "AnonPages:       3072000 kB\n"
+    "Shmem:            524288 kB\n"
+    "HugePages_Total:       0\n"
+    "Hugepagesize:       2048 kB\n";
+}
+
+TEST_CASE("LinuxMemoryMonitor basic functionality", "[linux][memory]") {
+    IMemoryMonitor* monitor = createMemoryMonitor();
+    REQUIRE(monitor->isSupported());
+    MemoryUsage usage = monitor->getMemoryUsage();
+    REQUIRE(usage.totalPhysicalMB > 0);
+    REQUIRE(usage.usedPhysicalMB + usage.availablePhysicalMB <= usage.totalPhysicalMB);
+    REQUIRE(usage.usedPercentage >= 0.0);
+    REQUIRE(usage.usedPercentage <= 100.0);
+    delete monitor;
+}
+
+TEST_CASE("parseMeminfo uses MemAvailable for the used/available split", "[linux][memory]") {
+    MemoryUsage usage = {};
+    REQUIRE(parseMeminfo(kMeminfo, std::strlen(kMeminfo), usage));
+    REQUIRE(usage.totalPhysicalMB == 16000);
+    REQUIRE(usage.availablePhysicalMB == 12000);
+    REQUIRE(usage.usedPhysicalMB == 4000);
+    REQUIRE(usage.usedPercentage == Catch::Approx(25.0));
+
+    REQUIRE(usage.totalVirtualMB == 2048);
+    REQUIRE(usage.availableVirtualMB == 1024);
+    REQUIRE(usage.usedVirtualMB == 1024);
+
+    REQUIRE(usage.pageCacheMB == 11000);
+    REQUIRE(usage.buffersMB == 200);
+    REQUIRE(usage.dirtyMB == 10);
+    REQUIRE(usage.writebackMB == 2);
+    REQUIRE(usage.shmemMB == 512);
+}
+
+TEST_CASE("parseMeminfo falls back when MemAvailable is missing", "[linux][memory]") {
+    const char* oldKernel =
+        "MemTotal:        1024000 kB\n"
+        "MemFree:          102400 kB\n"
+        "Buffers:          102400 kB\n"
+        "Cached:           307200 kB\n";
+    MemoryUsage usage = {};
+    REQUIRE(parseMeminfo(oldKernel, std::strlen(oldKernel), usage));
+    REQUIRE(usage.availablePhysicalMB == 500);
+    REQUIRE(usage.usedPhysicalMB == 500);
+}
+
+TEST_CASE("parseMeminfo rejects input without MemTotal", "[linux][memory]") {
+    const char* garbage = "Cached: 100 kB\n";
+    MemoryUsage usage = {};
+    REQUIRE_FALSE(parseMeminfo(garbage, std::strlen(garbage), usage));
+    REQUIRE_FALSE(parseMeminfo("", 0, usage));
+}
+
+TEST_CASE("LinuxMemoryMonitor re-reads a kept-open meminfo file", "[linux][memory]") {
+    auto root = std::filesystem::temp_directory_path() / "crossmon_meminfo_fixture";
+    std::filesystem::create_directories(root);
+    std::ofstream(root / "meminfo") << kMeminfo;
+
+    IMemoryMonitor* monitor = createLinuxMemoryMonitor(root.string());
+    REQUIRE(monitor->isSupported());
+    REQUIRE(monitor->getMemoryUsage().usedPhysicalMB == 4000);
+
+    std::ofstream(root / "meminfo", std::ios::trunc) << "MemTotal: 2048000 kB\nMemAvailable: 1024000 kB\n";
+    REQUIRE(monitor->getMemoryUsage().usedPhysicalMB == 1000);
+
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Meminfo sampling cost", "[.][benchmark][linux][memory]") {
+    std::size_t length = std::strlen(kMeminfo);
+    IMemoryMonitor* monitor = createMemoryMonitor();
+
+    BENCHMARK("parseMeminfo") {
+        MemoryUsage usage = {};
+        parseMeminfo(kMeminfo, length, usage);
+        return usage.usedPhysicalMB;
+    };
+
+    BENCHMARK("getMemoryUsage (/proc/meminfo)") {
+        return monitor->getMemoryUsage().usedPhysicalMB;
+    };
+
+    delete monitor;
+}
@@ -0,0 +1,111 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/metric_sources.hpp"
+#include <set>
+#include <string>
+#include <thread>
+#include <chrono>
+
+namespace {
+// Opens the sources --metrics would select for args in a fresh snapshot
+struct OpenedSources {
+    explicit OpenedSources(const MonitorArgs& args) : watcher(args.appName) {
+        MetricSourceContext context{args, child, watcher};
+        opened = sources.open(context, snapshot);
+    }
+
+    ChildProcess child;
+    AppWatcher watcher;
+    TickSnapshot snapshot;
+    MetricSourceSet sources;
+    bool opened = false;
+};
+
+MonitorArgs argsWithMetrics(std::vector<std::string> metrics) {
+    MonitorArgs args;
+    args.metrics = std::move(metrics);
+    return args;
+}
+}
+
+TEST_CASE("Every registered source has a unique name and its own slot", "[metrics]") {
+    std::set<std::string> names;
+    std::set<MetricSlot> slots;
+    REQUIRE(metricSourceCount() > 0);
+    for (std::size_t i = 0; i < metricSourceCount(); ++i) {
+        const MetricDescriptor& d = metricDescriptor(i);
+        REQUIRE(names.insert(d.name).second);
+        REQUIRE(slots.insert(d.slot).second);
+        REQUIRE(findMetricDescriptor(d.name) == &d);
+        REQUIRE(metricSourceNames().find(d.name) != std::string::npos);
+    }
+    REQUIRE(findMetricDescriptor("cpu") != nullptr);
+    REQUIRE(findMetricDescriptor("nosuch") == nullptr);
+}
+
+TEST_CASE("Only the named sources are opened", "[metrics]") {
+    OpenedSources set(argsWithMetrics({"cpu"}));
+    REQUIRE(set.opened);
+    REQUIRE(set.sources.size() == 1);
+    REQUIRE(std::string(set.sources[0].descriptor().name) == "cpu");
+    REQUIRE(set.snapshot.has(MetricSlot::Cpu));
+    REQUIRE_FALSE(set.snapshot.has(MetricSlot::Memory));
+    REQUIRE_FALSE(set.snapshot.has(MetricSlot::Gpu));
+    REQUIRE_FALSE(set.snapshot.has(MetricSlot::Top));
+    REQUIRE_FALSE(set.snapshot.coreBusy.empty());
+}
+
+TEST_CASE("The plain system sources are opened when none are named", "[metrics]") {
+    OpenedSources set(argsWithMetrics({}));
+    REQUIRE(set.opened);
+    REQUIRE(set.snapshot.has(MetricSlot::Cpu));
+    REQUIRE(set.snapshot.has(MetricSlot::Memory));
+    REQUIRE_FALSE(set.snapshot.has(MetricSlot::Process));
+    REQUIRE_FALSE(set.snapshot.has(MetricSlot::Top));
+}
+
+TEST_CASE("Other options imply the sources they need", "[metrics]") {
+    MonitorArgs args = argsWithMetrics({"mem"});
+    args.top = 3;
+    OpenedSources set(args);
+    REQUIRE(set.opened);
+    REQUIRE(set.sources.size() == 2);
+    REQUIRE(set.snapshot.has(MetricSlot::Memory));
+    REQUIRE(set.snapshot.has(MetricSlot::Top));
+    REQUIRE_FALSE(set.snapshot.has(MetricSlot::Cpu));
+}
+
+TEST_CASE("An unknown source name is rejected before anything is opened", "[metrics]") {
+    OpenedSources set(argsWithMetrics({"cpu", "nosuch"}));
+    REQUIRE_FALSE(set.opened);
+    REQUIRE(set.sources.size() == 0);
+    REQUIRE(set.snapshot.present == 0);
+    REQUIRE(set.sources.error().find("nosuch") != std::string::npos);
+}
+
+TEST_CASE("Sources fill only their own slot", "[metrics]") {
+    OpenedSources set(argsWithMetrics({"mem"}));
+    REQUIRE(set.opened);
+    for (std::size_t i = 0; i < set.sources.size(); ++i) set.sources[i].collect(set.snapshot);
+    REQUIRE(set.snapshot.mem.totalPhysicalMB > 0);
+    REQUIRE(set.snapshot.cpu == 0.0);
+}
+
+TEST_CASE("collectorLatencyFromSlots maps slots onto the fixed collectors", "[metrics]") {
+    double bySlot[static_cast<std::size_t>(MetricSlot::Count)] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    CollectorLatency latency = collectorLatencyFromSlots(bySlot);
+    REQUIRE(latency.cpuMs == 1.0);
+    REQUIRE(latency.memoryMs == 2.0);
+    REQUIRE(latency.gpuMs == 3.0);
+    REQUIRE(latency.npuMs == 4.0);
+}
+
+TEST_CASE("Benchmark cpu source collect", "[metrics][benchmark]") {
+    OpenedSources set(argsWithMetrics({"cpu"}));
+    REQUIRE(set.opened);
+    BENCHMARK("cpu collect") {
+        set.sources[0].collect(set.snapshot);
+        return set.snapshot.cpu;
+    };
+}
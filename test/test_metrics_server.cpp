@@ -0,0 +1,169 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/metrics_server.hpp"
+#include <string>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+MetricsSnapshot sampleSnapshot() {
+    MetricsSnapshot snapshot;
+    snapshot.timestampMs = 1700000000500;
+    snapshot.cpuPercent = 12.5;
+    snapshot.corePercent = {10.0, 15.0};
+    snapshot.memoryUsedMB = 2048;
+    snapshot.memoryTotalMB = 8192;
+    snapshot.memoryUsedPercent = 25.0;
+    snapshot.gpuPercent = 40.0;
+    snapshot.gpuPercentPerDevice = {30.0, 50.0};
+    snapshot.latency.cpuMs = 1.5;
+    snapshot.samples = 42;
+    snapshot.overruns = 1;
+    snapshot.skippedTicks = 2;
+    return snapshot;
+}
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+#ifndef _WIN32
+int connectLoopback(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+// Sends one request and reads exactly one response (headers plus Content-Length body)
+std::string exchange(int fd, const std::string& request) {
+    REQUIRE(send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+    std::string response;
+    char chunk[4096];
+    for (;;) {
+        std::size_t headerEnd = response.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            std::size_t lengthAt = response.find("Content-Length: ");
+            std::size_t length = std::stoul(response.substr(lengthAt + 16));
+            if (response.size() >= headerEnd + 4 + length) return response;
+        }
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return response;
+        response.append(chunk, static_cast<std::size_t>(n));
+    }
+}
+#endif
+}
+
+TEST_CASE("renderOpenMetrics writes gauges, counters and the EOF marker", "[metrics]") {
+    SummaryBuffer out;
+    renderOpenMetrics(sampleSnapshot(), out);
+    std::string text(out.data(), out.size());
+    REQUIRE(contains(text, "# TYPE crossmon_cpu_utilization_percent gauge\n"
+                           "# UNIT crossmon_cpu_utilization_percent percent\n"));
+    REQUIRE(contains(text, "\ncrossmon_cpu_utilization_percent 12.5\n"));
+    REQUIRE(contains(text, "\ncrossmon_cpu_core_utilization_percent{core=\"1\"} 15\n"));
+    REQUIRE(contains(text, "\ncrossmon_memory_used_bytes 2147483648\n"));
+    REQUIRE(contains(text, "\ncrossmon_gpu_device_utilization_percent{gpu=\"0\"} 30\n"));
+    REQUIRE(contains(text, "\ncrossmon_collector_latency_seconds{collector=\"cpu\"} 0.0015\n"));
+    REQUIRE(contains(text, "# TYPE crossmon_samples counter\n"));
+    REQUIRE(contains(text, "\ncrossmon_samples_total 42\n"));
+    REQUIRE(contains(text, "\ncrossmon_last_sample_timestamp_seconds 1700000000.5\n"));
+    REQUIRE_FALSE(contains(text, "npu"));
+    REQUIRE(text.size() >= 6);
+    REQUIRE(text.substr(text.size() - 6) == "# EOF\n");
+}
+
+TEST_CASE("renderOpenMetrics leaves out sources that are not sampled", "[metrics]") {
+    SummaryBuffer out;
+    MetricsSnapshot snapshot = sampleSnapshot();
+    snapshot.memoryAvailable = false;
+    snapshot.gpuAvailable = false;
+    renderOpenMetrics(snapshot, out);
+    std::string text(out.data(), out.size());
+    REQUIRE(contains(text, "\ncrossmon_cpu_utilization_percent 12.5\n"));
+    REQUIRE(contains(text, "\ncrossmon_collector_latency_seconds{collector=\"cpu\"} 0.0015\n"));
+    REQUIRE_FALSE(contains(text, "crossmon_memory"));
+    REQUIRE_FALSE(contains(text, "crossmon_gpu"));
+    REQUIRE_FALSE(contains(text, "collector=\"memory\""));
+    REQUIRE_FALSE(contains(text, "collector=\"gpu\""));
+    REQUIRE(text.substr(text.size() - 6) == "# EOF\n");
+}
+
+TEST_CASE("renderOpenMetrics reuses its buffer across scrapes", "[metrics]") {
+    SummaryBuffer out;
+    MetricsSnapshot snapshot = sampleSnapshot();
+    renderOpenMetrics(snapshot, out);
+    const char* first = out.data();
+    snapshot.cpuPercent = 99.0;
+    renderOpenMetrics(snapshot, out);
+    REQUIRE(out.data() == first);
+}
+
+#ifndef _WIN32
+TEST_CASE("MetricsServer answers scrapes over loopback", "[metrics][server]") {
+    MetricsServer server;
+    REQUIRE(server.start("127.0.0.1:0"));
+    REQUIRE(server.port() != 0);
+    server.publish(sampleSnapshot());
+
+    int fd = connectLoopback(server.port());
+    std::string response = exchange(fd, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    REQUIRE(response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    REQUIRE(contains(response, "Content-Type: application/openmetrics-text; version=1.0.0"));
+    REQUIRE(contains(response, "\ncrossmon_samples_total 42\n"));
+
+    // Keep-alive: the same connection serves the next scrape with fresh values
+    MetricsSnapshot next = sampleSnapshot();
+    next.samples = 43;
+    server.publish(next);
+    response = exchange(fd, "GET /metrics?x=1 HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    REQUIRE(contains(response, "\ncrossmon_samples_total 43\n"));
+
+    response = exchange(fd, "GET /other HTTP/1.1\r\n\r\n");
+    REQUIRE(response.rfind("HTTP/1.1 404 Not Found\r\n", 0) == 0);
+    close(fd);
+
+    fd = connectLoopback(server.port());
+    response = exchange(fd, "POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    REQUIRE(response.rfind("HTTP/1.1 405", 0) == 0);
+    close(fd);
+
+    REQUIRE(server.scrapes() == 2);
+    server.stop();
+    REQUIRE_FALSE(server.isRunning());
+}
+
+TEST_CASE("MetricsServer rejects malformed addresses", "[metrics][server]") {
+    MetricsServer server;
+    REQUIRE_FALSE(server.start("9464"));
+    REQUIRE_FALSE(server.error().empty());
+    REQUIRE_FALSE(server.start("127.0.0.1:notaport"));
+}
+
+TEST_CASE("Scrape latency over a keep-alive connection", "[.][benchmark][server]") {
+    MetricsServer server;
+    REQUIRE(server.start("127.0.0.1:0"));
+    MetricsSnapshot snapshot = sampleSnapshot();
+    snapshot.corePercent.assign(64, 12.5);
+    server.publish(snapshot);
+    int fd = connectLoopback(server.port());
+    const std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+    BENCHMARK("GET /metrics, 64 cores") { return exchange(fd, request).size(); };
+    BENCHMARK("publish") {
+        server.publish(snapshot);
+        return snapshot.samples;
+    };
+    close(fd);
+}
+#endif
@@ -37,4 +37,252 @@ TEST_CASE("parseMonitorArgs: no app name provided", "[args]") {
     REQUIRE(parsed.interval == 100);
     REQUIRE(parsed.resultPath == "");
     REQUIRE(parsed.appName == "");
-} 
\ No newline at end of file
+} 
+TEST_CASE("parseMonitorArgs: catch-up overrun policy", "[args]") {
+    std::vector<std::string> args = {"prog", "--catch-up", "-i", "10"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE(parsed.catchUp);
+    REQUIRE(parsed.interval == 10);
+
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultArgv = make_argv(defaults);
+    REQUIRE_FALSE(parseMonitorArgs(defaults.size(), defaultArgv.data()).catchUp);
+}
+
+TEST_CASE("parseMonitorArgs: output format", "[args]") {
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultArgv = make_argv(defaults);
+    REQUIRE(parseMonitorArgs(defaults.size(), defaultArgv.data()).outputFormat == "text");
+
+    std::vector<std::string> args = {"prog", "-o", "out.json", "--format", "json"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE(parsed.outputFormat == "json");
+    REQUIRE(parsed.resultPath == "out.json");
+
+    std::vector<std::string> unknown = {"prog", "--format", "xml"};
+    auto unknownArgv = make_argv(unknown);
+    REQUIRE(parseMonitorArgs(unknown.size(), unknownArgv.data()).hasError);
+
+    std::vector<std::string> missing = {"prog", "--format"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: serve address", "[args]") {
+    std::vector<std::string> args = {"prog", "--serve", "127.0.0.1:9464", "-i", "1000"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE(parsed.serveAddress == "127.0.0.1:9464");
+    REQUIRE(parsed.interval == 1000);
+    REQUIRE(parsed.appName.empty());
+
+    std::vector<std::string> missing = {"prog", "--serve"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: display rate", "[args]") {
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultArgv = make_argv(defaults);
+    REQUIRE(parseMonitorArgs(defaults.size(), defaultArgv.data()).displayRate == 0.0);
+
+    std::vector<std::string> args = {"prog", "-i", "10", "--display-rate", "2.5"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE(parsed.displayRate == 2.5);
+    REQUIRE(parsed.interval == 10);
+
+    std::vector<std::string> missing = {"prog", "--display-rate"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+
+    std::vector<std::string> zero = {"prog", "--display-rate", "0"};
+    auto zeroArgv = make_argv(zero);
+    REQUIRE_FALSE(parseMonitorArgs(zero.size(), zeroArgv.data()).hasError);
+
+    for (const char* value : {"-1", "nan", "inf", "-inf"}) {
+        std::vector<std::string> invalid = {"prog", "--display-rate", value};
+        auto invalidArgv = make_argv(invalid);
+        MonitorArgs rejected = parseMonitorArgs(invalid.size(), invalidArgv.data());
+        INFO(value);
+        REQUIRE(rejected.hasError);
+        REQUIRE(rejected.errorMessage.find("--display-rate") != std::string::npos);
+    }
+}
+
+TEST_CASE("parseMonitorArgs: raw history is opt-in", "[args]") {
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultArgv = make_argv(defaults);
+    REQUIRE_FALSE(parseMonitorArgs(defaults.size(), defaultArgv.data()).keepHistory);
+
+    std::vector<std::string> args = {"prog", "--keep-history"};
+    auto argv = make_argv(args);
+    REQUIRE(parseMonitorArgs(args.size(), argv.data()).keepHistory);
+}
+
+TEST_CASE("parseMonitorArgs: full-resolution history window", "[args]") {
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultArgv = make_argv(defaults);
+    REQUIRE(parseMonitorArgs(defaults.size(), defaultArgv.data()).historyMinutes == 10);
+
+    std::vector<std::string> args = {"prog", "--history-minutes", "30", "Safari"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE(parsed.historyMinutes == 30);
+    REQUIRE(parsed.appName == "Safari");
+
+    std::vector<std::string> missing = {"prog", "--history-minutes"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: record path", "[args]") {
+    std::vector<std::string> args = {"prog", "--record", "run.bin", "-i", "50"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE(parsed.recordPath == "run.bin");
+    REQUIRE(parsed.interval == 50);
+    REQUIRE_FALSE(parsed.compressRecording);
+
+    std::vector<std::string> compressed = {"prog", "--record", "run.bin", "--compress"};
+    auto compressedArgv = make_argv(compressed);
+    MonitorArgs lossless = parseMonitorArgs(compressed.size(), compressedArgv.data());
+    REQUIRE(lossless.compressRecording);
+    REQUIRE_FALSE(lossless.lossyRecording);
+
+    std::vector<std::string> lossyArgs = {"prog", "--record", "run.bin", "--compress=lossy"};
+    auto lossyArgv = make_argv(lossyArgs);
+    MonitorArgs lossy = parseMonitorArgs(lossyArgs.size(), lossyArgv.data());
+    REQUIRE(lossy.compressRecording);
+    REQUIRE(lossy.lossyRecording);
+
+    std::vector<std::string> unknownMode = {"prog", "--record", "run.bin", "--compress=zstd"};
+    auto unknownModeArgv = make_argv(unknownMode);
+    REQUIRE(parseMonitorArgs(unknownMode.size(), unknownModeArgv.data()).hasError);
+
+    std::vector<std::string> missing = {"prog", "--record"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: replay subcommand", "[args]") {
+    std::vector<std::string> args = {"prog", "replay", "run.bin", "--realtime", "-o", "stats.txt"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE_FALSE(parsed.hasError);
+    REQUIRE(parsed.replayPath == "run.bin");
+    REQUIRE(parsed.realtime);
+    REQUIRE(parsed.resultPath == "stats.txt");
+    REQUIRE(parsed.appName.empty());
+
+    std::vector<std::string> missing = {"prog", "replay"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+
+TEST_CASE("parseMonitorArgs: command after --", "[args]") {
+    std::vector<std::string> args = {"prog", "-i", "100", "--", "make", "-j8", "-o", "out"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE_FALSE(parsed.hasError);
+    REQUIRE(parsed.interval == 100);
+    // Options after -- belong to the command
+    REQUIRE(parsed.command == std::vector<std::string>{"make", "-j8", "-o", "out"});
+    REQUIRE(parsed.resultPath.empty());
+    REQUIRE(parsed.appName.empty());
+
+    std::vector<std::string> missing = {"prog", "--"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: top processes", "[args]") {
+    std::vector<std::string> args = {"prog", "--top", "5", "-i", "2000"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE_FALSE(parsed.hasError);
+    REQUIRE(parsed.top == 5);
+    REQUIRE(parsed.interval == 2000);
+
+    std::vector<std::string> zero = {"prog", "--top", "0"};
+    auto zeroArgv = make_argv(zero);
+    REQUIRE(parseMonitorArgs(zero.size(), zeroArgv.data()).hasError);
+
+    std::vector<std::string> missing = {"prog", "--top"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: overhead budget", "[args]") {
+    std::vector<std::string> args = {"prog", "--overhead-budget", "0.5", "-i", "100"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE_FALSE(parsed.hasError);
+    REQUIRE(parsed.overheadBudget == 0.5);
+    REQUIRE(parsed.interval == 100);
+
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultsArgv = make_argv(defaults);
+    REQUIRE(parseMonitorArgs(defaults.size(), defaultsArgv.data()).overheadBudget == 0.0);
+
+    std::vector<std::string> negative = {"prog", "--overhead-budget", "-1"};
+    auto negativeArgv = make_argv(negative);
+    REQUIRE(parseMonitorArgs(negative.size(), negativeArgv.data()).hasError);
+
+    std::vector<std::string> missing = {"prog", "--overhead-budget"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: metric sources", "[args]") {
+    std::vector<std::string> args = {"prog", "--metrics", "cpu,mem", "-i", "100"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE_FALSE(parsed.hasError);
+    REQUIRE(parsed.metrics == std::vector<std::string>{"cpu", "mem"});
+    REQUIRE_FALSE(parsed.listMetrics);
+
+    std::vector<std::string> list = {"prog", "--metrics", "list"};
+    auto listArgv = make_argv(list);
+    MonitorArgs listed = parseMonitorArgs(list.size(), listArgv.data());
+    REQUIRE_FALSE(listed.hasError);
+    REQUIRE(listed.listMetrics);
+
+    std::vector<std::string> empty = {"prog", "--metrics", "cpu,,mem"};
+    auto emptyArgv = make_argv(empty);
+    REQUIRE(parseMonitorArgs(empty.size(), emptyArgv.data()).hasError);
+
+    std::vector<std::string> missing = {"prog", "--metrics"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
+
+TEST_CASE("parseMonitorArgs: adaptive interval", "[args]") {
+    std::vector<std::string> args = {"prog", "--adaptive", "2000", "-i", "100", "--adaptive-step", "2.5"};
+    auto argv = make_argv(args);
+    MonitorArgs parsed = parseMonitorArgs(args.size(), argv.data());
+    REQUIRE_FALSE(parsed.hasError);
+    REQUIRE(parsed.adaptiveMaxInterval == 2000);
+    REQUIRE(parsed.interval == 100);
+    REQUIRE(parsed.adaptiveStep == 2.5);
+
+    std::vector<std::string> defaults = {"prog"};
+    auto defaultsArgv = make_argv(defaults);
+    REQUIRE(parseMonitorArgs(defaults.size(), defaultsArgv.data()).adaptiveMaxInterval == 0);
+
+    // The maximum must exceed -i (1000 ms by default)
+    std::vector<std::string> shorter = {"prog", "--adaptive", "500"};
+    auto shorterArgv = make_argv(shorter);
+    REQUIRE(parseMonitorArgs(shorter.size(), shorterArgv.data()).hasError);
+
+    std::vector<std::string> step = {"prog", "--adaptive", "5000", "--adaptive-step", "0"};
+    auto stepArgv = make_argv(step);
+    REQUIRE(parseMonitorArgs(step.size(), stepArgv.data()).hasError);
+
+    std::vector<std::string> missing = {"prog", "--adaptive"};
+    auto missingArgv = make_argv(missing);
+    REQUIRE(parseMonitorArgs(missing.size(), missingArgv.data()).hasError);
+}
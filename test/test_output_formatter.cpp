@@ -0,0 +1,261 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/output_formatter.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace {
+SystemStats sampleStats() {
+    SystemStats stats;
+    stats.cpu.samples = 3;
+    stats.cpu.peak = 75.5;
+    stats.cpu.average = 25.25;
+    stats.cpu.max = 75.5;
+    stats.cpu.percentiles = {20.0, 70.0, 75.0, 75.5};
+    stats.cpu.coreAverage = {10.0, 40.5};
+    stats.cpu.corePeak = {20.0, 90.0};
+    stats.cpu.busiestCore = 1;
+    stats.memory.samples = 3;
+    stats.memory.peakUsedMB = 8192;
+    stats.memory.usedMBPercentiles = {4096.0, 8000.0, 8192.0, 8192.0};
+    stats.gpu.samples = 3;
+    stats.gpu.gpuCount = 2;
+    stats.gpu.avgUtilization = 12.5;
+    stats.gpu.deviceAverage = {5.0, 20.0};
+    stats.gpu.devicePeak = {8.0, 33.0};
+    stats.npu.npuName = "Test \"NPU\", rev 2";
+    stats.process.name = "server";
+    stats.process.samples = 3;
+    stats.process.peakProcesses = 4;
+    stats.process.peakCpu = 150.0;
+    stats.process.peakRssKB = 20480;
+    stats.process.majorFaults = 7;
+    stats.process.writeBytes = 1048576;
+    stats.command.command = "make -j8";
+    stats.command.exitCode = 2;
+    stats.command.userSeconds = 1.5;
+    stats.command.maxRssKB = 65536;
+    stats.command.involuntarySwitches = 12;
+    stats.timing.ticks = 3;
+    stats.timing.intervalMs = 1000.0;
+    stats.overhead.ticks = 3;
+    stats.overhead.intervalMs = 1000.0;
+    stats.overhead.averageTickCpuMs = 0.125;
+    stats.overhead.peakRssKB = 3072;
+    stats.overhead.budgetPercent = 0.5;
+    stats.overhead.overBudgetTicks = 1;
+    stats.history.rawSamples = 3;
+    stats.history.rawCapacity = 600;
+    stats.history.tiers = {{10.0, 0, 2160}};
+    stats.history.footprintBytes = 2048;
+    return stats;
+}
+
+std::string format(const SystemStats& stats, OutputFormat fmt) {
+    SummaryBuffer out;
+    formatSystemStats(stats, fmt, out);
+    return std::string(out.data(), out.size());
+}
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+}
+
+TEST_CASE("parseOutputFormat accepts the four format names", "[output]") {
+    OutputFormat format = OutputFormat::Text;
+    REQUIRE(parseOutputFormat("json", format));
+    REQUIRE(format == OutputFormat::Json);
+    REQUIRE(parseOutputFormat("csv", format));
+    REQUIRE(format == OutputFormat::Csv);
+    REQUIRE(parseOutputFormat("kv", format));
+    REQUIRE(format == OutputFormat::Kv);
+    REQUIRE(parseOutputFormat("text", format));
+    REQUIRE(format == OutputFormat::Text);
+    REQUIRE_FALSE(parseOutputFormat("xml", format));
+}
+
+TEST_CASE("SummaryBuffer numbers round-trip", "[output]") {
+    SummaryBuffer out;
+    out.appendUint(18446744073709551615ull);
+    out.append(" ");
+    out.appendDouble(0.1);
+    out.append(" ");
+    out.appendDouble(25.25);
+    std::istringstream in(std::string(out.data(), out.size()));
+    unsigned long long big = 0;
+    double a = 0.0;
+    double b = 0.0;
+    in >> big >> a >> b;
+    REQUIRE(big == 18446744073709551615ull);
+    REQUIRE(a == 0.1);
+    REQUIRE(b == 25.25);
+}
+
+TEST_CASE("Key=value summary carries percentiles and per-device breakdowns", "[output]") {
+    std::string kv = format(sampleStats(), OutputFormat::Kv);
+    REQUIRE(kv.rfind("schema_version=2\n", 0) == 0);
+    REQUIRE(contains(kv, "\ncpu.samples=3\n"));
+    REQUIRE(contains(kv, "\ncpu.p99=75\n"));
+    REQUIRE(contains(kv, "\ncpu.cores.1.average=40.5\n"));
+    REQUIRE(contains(kv, "\ncpu.cores.1.peak=90\n"));
+    REQUIRE(contains(kv, "\nmemory.used_mb_p50=4096\n"));
+    REQUIRE(contains(kv, "\ngpu.devices.0.peak=8\n"));
+    REQUIRE(contains(kv, "\ngpu.devices.1.average=20\n"));
+    REQUIRE(contains(kv, "\nnpu.name=Test \"NPU\", rev 2\n"));
+    REQUIRE(contains(kv, "\nprocess.name=server\n"));
+    REQUIRE(contains(kv, "\nprocess.peak_processes=4\n"));
+    REQUIRE(contains(kv, "\nprocess.peak_cpu=150\n"));
+    REQUIRE(contains(kv, "\nprocess.peak_rss_kb=20480\n"));
+    REQUIRE(contains(kv, "\nprocess.major_faults=7\n"));
+    REQUIRE(contains(kv, "\nprocess.write_bytes=1048576\n"));
+    REQUIRE(contains(kv, "\ncommand.command=make -j8\n"));
+    REQUIRE(contains(kv, "\ncommand.exit_code=2\n"));
+    REQUIRE(contains(kv, "\ncommand.user_seconds=1.5\n"));
+    REQUIRE(contains(kv, "\ncommand.max_rss_kb=65536\n"));
+    REQUIRE(contains(kv, "\ncommand.involuntary_context_switches=12\n"));
+    REQUIRE(contains(kv, "\ncollector_latency_ms.max.gpu=0\n"));
+    REQUIRE(contains(kv, "\nmonitor_overhead.average_tick_cpu_ms=0.125\n"));
+    REQUIRE(contains(kv, "\nmonitor_overhead.average_tick_cpu_percent=0.0125\n"));
+    REQUIRE(contains(kv, "\nmonitor_overhead.peak_rss_kb=3072\n"));
+    REQUIRE(contains(kv, "\nmonitor_overhead.over_budget_ticks=1\n"));
+    REQUIRE(contains(kv, "\nhistory.tiers.0.capacity=2160\n"));
+}
+
+TEST_CASE("CSV summary uses the same keys with quoted text", "[output]") {
+    std::string csv = format(sampleStats(), OutputFormat::Csv);
+    REQUIRE(csv.rfind("key,value\nschema_version,2\n", 0) == 0);
+    REQUIRE(contains(csv, "\ncpu.cores.0.average,10\n"));
+    REQUIRE(contains(csv, "\nnpu.name,\"Test \"\"NPU\"\", rev 2\"\n"));
+}
+
+TEST_CASE("JSON summary nests sections and escapes strings", "[output]") {
+    std::string json = format(sampleStats(), OutputFormat::Json);
+    REQUIRE(json.rfind("{\n  \"schema_version\": 2,\n  \"cpu\": {\n    \"samples\": 3,", 0) == 0);
+    REQUIRE(contains(json, "\"cores\": [\n      {\n        \"average\": 10,\n        \"peak\": 20\n      },"));
+    REQUIRE(contains(json, "\"name\": \"Test \\\"NPU\\\", rev 2\""));
+
+    // Brackets balance and nothing trails the closing brace
+    int depth = 0;
+    bool inString = false;
+    for (std::size_t i = 0; i < json.size(); ++i) {
+        char c = json[i];
+        if (inString) {
+            if (c == '\\') ++i;
+            else if (c == '"') inString = false;
+            continue;
+        }
+        if (c == '"') inString = true;
+        if (c == '{' || c == '[') ++depth;
+        if (c == '}' || c == ']') --depth;
+        REQUIRE(depth >= 0);
+    }
+    REQUIRE(depth == 0);
+    REQUIRE(json.substr(json.size() - 2) == "}\n");
+
+    SystemStats empty;
+    std::string minimal = format(empty, OutputFormat::Json);
+    REQUIRE(contains(minimal, "\"cores\": []"));
+    REQUIRE(contains(minimal, "\"devices\": []"));
+}
+
+TEST_CASE("Non-finite values become JSON null", "[output]") {
+    SystemStats stats;
+    stats.cpu.average = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE(contains(format(stats, OutputFormat::Json), "\"average\": null"));
+}
+
+TEST_CASE("Adaptive sampling shows its interval range and sample rate", "[output]") {
+    SystemStats stats = sampleStats();
+    stats.timing.intervalMs = 100.0;
+    stats.timing.maxIntervalMs = 2000.0;
+    stats.timing.meanIntervalMs = 800.0;
+    stats.timing.samplesPerHour = 4500.0;
+    stats.timing.tightenings = 6;
+    std::string kv = format(stats, OutputFormat::Kv);
+    REQUIRE(contains(kv, "\ntiming.max_interval_ms=2000\n"));
+    REQUIRE(contains(kv, "\ntiming.samples_per_hour=4500\n"));
+    REQUIRE(contains(kv, "\ntiming.tightenings=6\n"));
+    std::string text = format(stats, OutputFormat::Text);
+    REQUIRE(contains(text, "\nInterval:        adaptive 100-2000 ms (avg 800 ms)\n"));
+    REQUIRE(contains(text, "\nSamples/hour:    4500 (6 tightenings)\n"));
+}
+
+TEST_CASE("Sections of sources that were not sampled are left out", "[output]") {
+    SystemStats stats = sampleStats();
+    stats.sections.memory = false;
+    stats.sections.gpu = false;
+    stats.sections.npu = false;
+    std::string kv = format(stats, OutputFormat::Kv);
+    // Optional sections arrived with schema version 2
+    REQUIRE(kv.rfind("schema_version=2\ncpu.samples=3\n", 0) == 0);
+    REQUIRE_FALSE(contains(kv, "\nmemory."));
+    REQUIRE_FALSE(contains(kv, "\ngpu."));
+    REQUIRE_FALSE(contains(kv, "\nnpu."));
+    REQUIRE(contains(kv, "\nprocess.name=server\n"));
+    std::string json = format(stats, OutputFormat::Json);
+    REQUIRE(json.rfind("{\n  \"schema_version\": 2,\n", 0) == 0);
+    REQUIRE_FALSE(contains(json, "\"memory\": {"));
+    REQUIRE_FALSE(contains(json, "\"gpu\": {"));
+    REQUIRE(contains(format(stats, OutputFormat::Csv), "cpu.samples,3"));
+    REQUIRE_FALSE(contains(format(stats, OutputFormat::Csv), "memory."));
+    std::string text = format(stats, OutputFormat::Text);
+    REQUIRE(text.rfind("CPU Usage Statistics\n", 0) == 0);
+    REQUIRE_FALSE(contains(text, "Memory Usage Statistics"));
+    REQUIRE_FALSE(contains(text, "GPU Usage Statistics"));
+    REQUIRE_FALSE(contains(text, "NPU Usage Statistics"));
+}
+
+TEST_CASE("writeSystemStatsToFile replaces the file in one step", "[output]") {
+    const std::string path = std::string(P_tmpdir) + "/crossmon_summary_test.txt";
+    std::remove(path.c_str());
+    {
+        std::ofstream stale(path);
+        stale << "stale contents that are longer than nothing\n";
+    }
+
+    SystemStats stats = sampleStats();
+    writeSystemStatsToFile(stats, path, OutputFormat::Kv);
+    REQUIRE(readFile(path) == format(stats, OutputFormat::Kv));
+    REQUIRE_FALSE(std::ifstream(path + ".tmp").good());
+
+    writeSystemStatsToFile(stats, path);
+    std::string text = readFile(path);
+    REQUIRE(text.rfind("CPU Usage Statistics\n", 0) == 0);
+    REQUIRE(contains(text, "\nMemory Usage Statistics\n"));
+    REQUIRE(contains(text, "\nGPU 1: avg 20%, peak 33%\n"));
+    REQUIRE(contains(text, "\nSampling Timing\n"));
+    REQUIRE(contains(text, "\nMonitor Overhead (thread CPU per tick)\n"));
+    REQUIRE(contains(text, "\nBudget:          0.5% of one core, exceeded on 1 ticks\n"));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Summary serialization cost", "[.][benchmark]") {
+    SystemStats stats = sampleStats();
+    stats.cpu.coreAverage.assign(128, 12.5);
+    stats.cpu.corePeak.assign(128, 97.25);
+    SummaryBuffer out(64 * 1024);
+
+    BENCHMARK("json, 128 cores") {
+        formatSystemStats(stats, OutputFormat::Json, out);
+        return out.size();
+    };
+    BENCHMARK("kv, 128 cores") {
+        formatSystemStats(stats, OutputFormat::Kv, out);
+        return out.size();
+    };
+    BENCHMARK("text, 128 cores") {
+        formatSystemStats(stats, OutputFormat::Text, out);
+        return out.size();
+    };
+}
@@ -1,11 +1,36 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "utils/process_manager.hpp"
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+std::string selfName() {
+    std::string name;
+    std::getline(std::ifstream("/proc/self/comm"), name);
+    return name;
+}
+}
+#endif
 
 TEST_CASE("isAppRunning: system process should be running", "[process]") {
 #ifdef _WIN32
     // Windows Explorer should always be running
     REQUIRE(isAppRunning("explorer.exe"));
+#elif defined(__linux__)
+    // No desktop process is guaranteed on Linux, but this test binary is running
+    REQUIRE(isAppRunning(selfName()));
 #else
     // macOS Finder should always be running
     REQUIRE(isAppRunning("Finder"));
@@ -16,6 +41,139 @@ TEST_CASE("isAppRunning: fake app should not be running", "[process]") {
     REQUIRE_FALSE(isAppRunning("DefinitelyNotARealApp"));
 }
 
+#ifdef __linux__
+TEST_CASE("findProcessIds matches the name exactly, truncated like the kernel", "[process]") {
+    auto root = std::filesystem::temp_directory_path() / "crossmon_pid_fixture";
+    std::filesystem::remove_all(root);
+    auto addProcess = [&](const std::string& pid, const std::string& name, char state = 'S') {
+        std::filesystem::create_directories(root / pid);
+        std::ofstream(root / pid / "stat") << pid << " (" << name << ") " << state
+                                           << " 1 " << pid << " " << pid << " 0 -1 4194304 100 0 0 0\n";
+    };
+    addProcess("42", "server");
+    addProcess("7", "server");
+    addProcess("8", "server", 'Z');           // Zombies have exited
+    addProcess("99", "server-helper");
+    addProcess("120", "x) (server");          // Names may contain parentheses
+    addProcess("1234", "averyverylongna");    // "averyverylongname" as the kernel stores it
+    std::filesystem::create_directories(root / "self");
+    std::filesystem::create_directories(root / "sys");
+
+    REQUIRE(findProcessIds("server", root.string()) == std::vector<int>{7, 42});
+    REQUIRE(findProcessIds("x) (server", root.string()) == std::vector<int>{120});
+    REQUIRE(findProcessIds("averyverylongname", root.string()) == std::vector<int>{1234});
+    REQUIRE(findProcessIds("serv", root.string()).empty());
+    REQUIRE(findProcessIds("", root.string()).empty());
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("findProcessIds finds this test binary", "[process]") {
+    std::vector<int> pids = findProcessIds(selfName());
+    REQUIRE(std::find(pids.begin(), pids.end(), static_cast<int>(getpid())) != pids.end());
+}
+
+TEST_CASE("AppWatcher follows processes until the last one exits", "[process]") {
+    // A forked child keeps this binary's name, so the same scan finds it; it
+    // waits in pause() until killed
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    REQUIRE(child > 0);
+
+    AppWatcher watcher(selfName());
+    REQUIRE(watcher.isRunning());
+    REQUIRE(std::find(watcher.pids().begin(), watcher.pids().end(), static_cast<int>(child)) != watcher.pids().end());
+    uint64_t generation = watcher.generation();
+
+    // Nothing exited: no rescan
+    REQUIRE(watcher.isRunning());
+    REQUIRE(watcher.generation() == generation);
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    // The exit triggers a rescan that drops the child but keeps this process
+    REQUIRE(watcher.isRunning());
+    REQUIRE(watcher.generation() == generation + 1);
+    REQUIRE(std::find(watcher.pids().begin(), watcher.pids().end(), static_cast<int>(child)) == watcher.pids().end());
+    REQUIRE(std::find(watcher.pids().begin(), watcher.pids().end(), static_cast<int>(getpid())) != watcher.pids().end());
+
+    AppWatcher missing("DefinitelyNotARealApp");
+    REQUIRE_FALSE(missing.isRunning());
+}
+
+TEST_CASE("Liveness check cost per tick", "[.][benchmark][process]") {
+    const std::string name = selfName();
+    AppWatcher watcher(name);
+    REQUIRE(watcher.isRunning());
+    BENCHMARK("system(pgrep -x)") {
+        return system(("pgrep -x '" + name + "' > /dev/null").c_str());
+    };
+    BENCHMARK("findProcessIds (/proc scan)") {
+        return findProcessIds(name).size();
+    };
+    BENCHMARK("AppWatcher::isRunning (pidfd poll)") {
+        return watcher.isRunning();
+    };
+}
+#endif
+
+#ifndef _WIN32
+TEST_CASE("ChildProcess reports exit status and rusage totals", "[process][command]") {
+    ChildProcess child;
+    // Busy enough to accumulate measurable user time
+    REQUIRE(child.start({"sh", "-c", "i=0; while [ $i -lt 300000 ]; do i=$((i+1)); done; exit 3"}));
+    REQUIRE(child.pid() > 0);
+    REQUIRE(child.isRunning());
+    REQUIRE(child.exitFd() >= 0);
+
+    // The exit descriptor becomes readable once the child is done
+    pollfd pfd = {child.exitFd(), POLLIN, 0};
+    REQUIRE(poll(&pfd, 1, 30000) == 1);
+
+    const CommandStats& stats = child.wait();
+    REQUIRE_FALSE(child.isRunning());
+    REQUIRE(stats.command == "sh -c i=0; while [ $i -lt 300000 ]; do i=$((i+1)); done; exit 3");
+    REQUIRE(stats.exitCode == 3);
+    REQUIRE(stats.userSeconds + stats.systemSeconds > 0.0);
+    REQUIRE(stats.wallSeconds >= stats.userSeconds * 0.5);
+    REQUIRE(stats.maxRssKB > 0);
+    REQUIRE(stats.minorFaults > 0);
+    REQUIRE(stats.voluntarySwitches + stats.involuntarySwitches > 0);
+    // Later calls return the same totals
+    REQUIRE(child.wait().exitCode == 3);
+}
+
+TEST_CASE("ChildProcess maps signals and reports spawn failures", "[process][command]") {
+    ChildProcess killed;
+    REQUIRE(killed.start({"sleep", "30"}));
+    kill(killed.pid(), SIGKILL);
+    REQUIRE(killed.wait().exitCode == 128 + SIGKILL);
+
+    ChildProcess missing;
+    REQUIRE_FALSE(missing.start({"crossmon-definitely-not-a-command"}));
+    REQUIRE_FALSE(missing.error().empty());
+    REQUIRE_FALSE(missing.isRunning());
+
+    ChildProcess empty;
+    REQUIRE_FALSE(empty.start({}));
+}
+
+TEST_CASE("ChildProcess fails when the exit status cannot be collected", "[process][command]") {
+    ChildProcess child;
+    REQUIRE(child.start({"sh", "-c", "exit 0"}));
+    // Reaped behind its back, so wait4 fails with ECHILD
+    int status = 0;
+    REQUIRE(waitpid(child.pid(), &status, 0) == child.pid());
+
+    const CommandStats& stats = child.wait();
+    REQUIRE_FALSE(child.isRunning());
+    REQUIRE(stats.exitCode == 1);
+    REQUIRE_FALSE(child.error().empty());
+}
+#endif
+
 TEST_CASE("launchApp: launches app (manual check)", "[process]") {
 #ifdef _WIN32
     // This will open Calculator on Windows
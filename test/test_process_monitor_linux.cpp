@@ -0,0 +1,140 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "process_monitor.hpp"
+#include "proc_fixture.hpp"
+#include <chrono>
+#include <string>
+#include <unistd.h>
+
+namespace {
+using procfixture::makeFixtureRoot;
+using procfixture::writeFile;
+
+// Two cores, so one core's worth of ticks is half of the aggregate delta
+void writeSystemStat(const std::filesystem::path& root, uint64_t idle) {
+    writeFile(root / "stat", "cpu  100 0 100 " + std::to_string(idle) + " 0 0 0 0 0 0\n"
+                             "cpu0 50 0 50 0 0 0 0 0 0 0\n"
+                             "cpu1 50 0 50 0 0 0 0 0 0 0\n"
+                             "intr 12345 0 0 0\n");
+}
+
+std::string pidStat(int pid, const std::string& comm, uint64_t minflt, uint64_t majflt,
+                    uint64_t utime, uint64_t stime, uint64_t rssPages) {
+    procfixture::PidStat fields;
+    fields.minorFaults = minflt;
+    fields.majorFaults = majflt;
+    fields.utime = utime;
+    fields.stime = stime;
+    fields.rssPages = rssPages;
+    return procfixture::pidStatLine(pid, comm, fields);
+}
+
+std::string smapsRollup(uint64_t rssKB, uint64_t pssKB) {
+    return "55d0c0000000-7ffd00000000 ---p 00000000 00:00 0                          [rollup]\n"
+           "Rss:             " + std::to_string(rssKB) + " kB\n"
+           "Pss:             " + std::to_string(pssKB) + " kB\n"
+           "Pss_Anon:         1024 kB\n"
+           "Shared_Clean:      512 kB\n";
+}
+
+std::string io(uint64_t readBytes, uint64_t writeBytes) {
+    return "rchar: 999999\nwchar: 888888\nsyscr: 10\nsyscw: 20\n"
+           "read_bytes: " + std::to_string(readBytes) + "\n"
+           "write_bytes: " + std::to_string(writeBytes) + "\n"
+           "cancelled_write_bytes: 0\n";
+}
+}
+
+TEST_CASE("LinuxProcessMonitor sums deltas over the tracked processes", "[linux][process]") {
+    auto root = makeFixtureRoot("crossmon_process_fixture");
+    writeSystemStat(root, 1000);
+    // The name contains spaces and parentheses, as comm is allowed to
+    writeFile(root / "100" / "stat", pidStat(100, "my (app) 1", 500, 3, 40, 10, 256));
+    writeFile(root / "100" / "smaps_rollup", smapsRollup(4096, 2048));
+    writeFile(root / "100" / "io", io(1000, 2000));
+    // No smaps_rollup or io: RSS falls back to the page count in stat
+    writeFile(root / "200" / "stat", pidStat(200, "worker", 10, 0, 5, 5, 256));
+
+    IProcessMonitor* monitor = createLinuxProcessMonitor(root.string());
+    REQUIRE(monitor->isSupported());
+    monitor->track({100, 200, 300}); // 300 does not exist and is dropped
+
+    // 200 aggregate ticks = 100 ticks of one core; the processes used 30 + 20
+    writeSystemStat(root, 1200);
+    writeFile(root / "100" / "stat", pidStat(100, "my (app) 1", 520, 4, 60, 20, 256));
+    writeFile(root / "100" / "smaps_rollup", smapsRollup(8192, 4096));
+    writeFile(root / "100" / "io", io(5096, 2000));
+    writeFile(root / "200" / "stat", pidStat(200, "worker", 15, 1, 15, 15, 512));
+
+    ProcessUsage usage = monitor->getProcessUsage();
+    REQUIRE(usage.processes == 2);
+    REQUIRE(usage.cpuPercent == Catch::Approx(50.0));
+    const uint64_t pageKB = static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    REQUIRE(usage.rssKB == 8192 + 512 * pageKB);
+    REQUIRE(usage.pssKB == 4096);
+    REQUIRE(usage.minorFaults == 25);
+    REQUIRE(usage.majorFaults == 2);
+    REQUIRE(usage.readBytes == 4096);
+    REQUIRE(usage.writeBytes == 0);
+
+    // A process whose stat can no longer be read has exited and is dropped
+    writeSystemStat(root, 1400);
+    writeFile(root / "200" / "stat", "");
+    usage = monitor->getProcessUsage();
+    REQUIRE(usage.processes == 1);
+    REQUIRE(usage.cpuPercent == 0.0);
+    REQUIRE(usage.minorFaults == 0);
+    REQUIRE(usage.rssKB == 8192);
+
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxProcessMonitor caps CPU at every core busy", "[linux][process]") {
+    auto root = makeFixtureRoot("crossmon_process_cap");
+    writeSystemStat(root, 1000);
+    writeFile(root / "100" / "stat", pidStat(100, "spinner", 0, 0, 0, 0, 256));
+
+    IProcessMonitor* monitor = createLinuxProcessMonitor(root.string());
+    monitor->track({100});
+
+    // 100 ticks of wall time per core, but the process counters were read a
+    // little later and already show 300 ticks
+    writeSystemStat(root, 1200);
+    writeFile(root / "100" / "stat", pidStat(100, "spinner", 0, 0, 200, 100, 256));
+    ProcessUsage usage = monitor->getProcessUsage();
+    REQUIRE(usage.cpuPercent == Catch::Approx(200.0));
+
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxProcessMonitor reports nothing without tracked processes", "[linux][process]") {
+    auto root = makeFixtureRoot("crossmon_process_empty");
+    IProcessMonitor* monitor = createLinuxProcessMonitor(root.string());
+    REQUIRE_FALSE(monitor->isSupported());
+    monitor->track({1});
+    ProcessUsage usage = monitor->getProcessUsage();
+    REQUIRE(usage.processes == 0);
+    REQUIRE(usage.cpuPercent == 0.0);
+    delete monitor;
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("LinuxProcessMonitor measures its own process", "[linux][process]") {
+    IProcessMonitor* monitor = createLinuxProcessMonitor("/proc");
+    REQUIRE(monitor->isSupported());
+    monitor->track({static_cast<int>(getpid())});
+
+    // Busy-wait so the interval has CPU time to attribute
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    volatile uint64_t spin = 0;
+    while (std::chrono::steady_clock::now() < until) ++spin;
+
+    ProcessUsage usage = monitor->getProcessUsage();
+    REQUIRE(usage.processes == 1);
+    REQUIRE(usage.rssKB > 0);
+    REQUIRE(usage.cpuPercent > 10.0);
+    delete monitor;
+}
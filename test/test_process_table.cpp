@@ -0,0 +1,186 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/process_table.hpp"
+#include "proc_fixture.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+using procfixture::makeFixtureRoot;
+
+// Two CPUs; the aggregate line's eight fields sum to total
+void writeSystemStat(const std::filesystem::path& root, uint64_t total) {
+    procfixture::writeFile(root / "stat", "cpu  " + std::to_string(total) + " 0 0 0 0 0 0 0 0 0\n"
+                                          "cpu0 0 0 0 0 0 0 0 0 0 0\ncpu1 0 0 0 0 0 0 0 0 0 0\n");
+}
+
+void writeProcess(const std::filesystem::path& root, int pid, const std::string& name, uint64_t utime,
+                  uint64_t stime, uint64_t rssPages, uint64_t startTime = 100) {
+    procfixture::PidStat fields;
+    fields.utime = utime;
+    fields.stime = stime;
+    fields.rssPages = rssPages;
+    fields.startTime = startTime;
+    procfixture::writePidStat(root, pid, name, fields);
+}
+
+std::vector<int> pidsOf(const std::vector<TopProcess>& rows) {
+    std::vector<int> pids;
+    for (const TopProcess& row : rows) pids.push_back(row.pid);
+    return pids;
+}
+}
+
+TEST_CASE("ProcessTable ranks processes by CPU and RSS", "[linux][top]") {
+    auto root = makeFixtureRoot("crossmon_top_fixture");
+    const uint64_t pageKB = static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    writeSystemStat(root, 1000);
+    writeProcess(root, 10, "idle", 0, 0, 100);
+    writeProcess(root, 20, "busy worker", 50, 50, 300);
+    writeProcess(root, 30, "cc1plus", 10, 0, 900);
+    std::filesystem::create_directories(root / "self");
+
+    ProcessTable table(root.string());
+    REQUIRE(table.refresh());
+    REQUIRE(table.size() == 3);
+    REQUIRE(table.openFiles() == 3);
+
+    // 200 aggregate ticks over 2 CPUs = 100 ticks of wall time per core
+    writeSystemStat(root, 1200);
+    writeProcess(root, 20, "busy worker", 120, 80, 300); // +100 ticks: one full core
+    writeProcess(root, 30, "cc1plus", 35, 0, 900);       // +25 ticks
+    REQUIRE(table.refresh());
+
+    std::vector<TopProcess> rows;
+    table.topByCpu(2, rows);
+    REQUIRE(pidsOf(rows) == std::vector<int>{20, 30});
+    REQUIRE(std::strcmp(rows[0].name, "busy worker") == 0);
+    REQUIRE(rows[0].cpuPercent == Catch::Approx(100.0));
+    REQUIRE(rows[1].cpuPercent == Catch::Approx(25.0));
+
+    table.topByRss(10, rows);
+    REQUIRE(pidsOf(rows) == std::vector<int>{30, 20, 10});
+    REQUIRE(rows[0].rssKB == 900 * pageKB);
+
+    // PID 20 is reused by a new process: its counters restart
+    writeSystemStat(root, 1400);
+    writeProcess(root, 20, "sh", 5, 0, 50, 999);
+    std::filesystem::remove_all(root / "10");
+    REQUIRE(table.refresh());
+    REQUIRE(table.size() == 2);
+    table.topByCpu(10, rows);
+    REQUIRE(pidsOf(rows) == std::vector<int>{20, 30});
+    REQUIRE(rows[0].cpuPercent == Catch::Approx(0.0));
+    REQUIRE(std::strcmp(rows[0].name, "sh") == 0);
+
+    // Read after /proc/stat, a process can appear to run ahead of the wall
+    // clock; it is capped at both CPUs busy
+    writeSystemStat(root, 1600);
+    writeProcess(root, 30, "cc1plus", 335, 0, 900); // +300 ticks in 100 per core
+    REQUIRE(table.refresh());
+    table.topByCpu(1, rows);
+    REQUIRE(pidsOf(rows) == std::vector<int>{30});
+    REQUIRE(rows[0].cpuPercent == Catch::Approx(200.0));
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("ProcessTable keeps its table consistent as processes come and go", "[linux][top]") {
+    auto root = makeFixtureRoot("crossmon_top_churn");
+    writeSystemStat(root, 1000);
+    std::vector<int> alive;
+    for (int pid = 1; pid <= 3000; ++pid) {
+        writeProcess(root, pid, "p", 0, 0, static_cast<uint64_t>(pid));
+        alive.push_back(pid);
+    }
+    // Fewer descriptors than processes: the rest are opened per refresh
+    ProcessTable table(root.string(), 1000);
+    REQUIRE(table.refresh());
+    REQUIRE(table.openFiles() == 1000);
+
+    // Every third process exits and new PIDs above and in between appear
+    std::vector<int> next;
+    for (int pid : alive) {
+        if (pid % 3 == 0) {
+            std::filesystem::remove_all(root / std::to_string(pid));
+        } else {
+            next.push_back(pid);
+        }
+    }
+    for (int pid = 5000; pid < 5500; ++pid) {
+        writeProcess(root, pid, "q", 0, 0, static_cast<uint64_t>(pid));
+        next.push_back(pid);
+    }
+    REQUIRE(table.refresh());
+    REQUIRE(table.size() == next.size());
+    REQUIRE(table.openFiles() <= 1000);
+
+    std::vector<TopProcess> rows;
+    table.topByRss(next.size() + 10, rows);
+    std::vector<int> expected(next.rbegin(), next.rend());
+    REQUIRE(pidsOf(rows) == expected);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("ProcessTable lists /proc only after a PID was allocated", "[linux][top]") {
+    auto root = makeFixtureRoot("crossmon_top_loadavg");
+    writeSystemStat(root, 1000);
+    writeProcess(root, 10, "a", 0, 0, 100);
+    std::ofstream(root / "loadavg") << "0.00 0.00 0.00 1/1 10\n";
+
+    ProcessTable table(root.string());
+    REQUIRE(table.refresh());
+    writeProcess(root, 11, "b", 0, 0, 100);
+    REQUIRE(table.refresh());
+    REQUIRE(table.size() == 1);
+
+    std::ofstream(root / "loadavg") << "0.00 0.00 0.00 1/2 11\n";
+    REQUIRE(table.refresh());
+    REQUIRE(table.size() == 2);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("ProcessTable reads the live process table", "[linux][top]") {
+    ProcessTable table;
+    REQUIRE(table.refresh());
+    REQUIRE(table.refresh());
+    std::vector<TopProcess> rows;
+    table.topByRss(5, rows);
+    REQUIRE(!rows.empty());
+    REQUIRE(rows.size() <= 5);
+    REQUIRE(std::is_sorted(rows.begin(), rows.end(),
+                           [](const TopProcess& a, const TopProcess& b) { return a.rssKB > b.rssKB; }));
+}
+
+TEST_CASE("ProcessTable refresh cost with 10,000 processes", "[.][benchmark][top]") {
+    auto root = makeFixtureRoot("crossmon_top_bench");
+    writeSystemStat(root, 1000);
+    for (int pid = 1; pid <= 10000; ++pid) {
+        writeProcess(root, pid, "worker", static_cast<uint64_t>(pid % 97), 0, static_cast<uint64_t>(pid % 1013));
+    }
+    ProcessTable table(root.string(), 20000);
+    table.refresh();
+    std::vector<TopProcess> byCpu;
+    std::vector<TopProcess> byRss;
+    BENCHMARK("refresh and rank top 10") {
+        table.refresh();
+        table.topByCpu(10, byCpu);
+        table.topByRss(10, byRss);
+        return byCpu.size() + byRss.size();
+    };
+    BENCHMARK("rank top 10 only") {
+        table.topByCpu(10, byCpu);
+        table.topByRss(10, byRss);
+        return byCpu.size() + byRss.size();
+    };
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,199 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/process_tree.hpp"
+#include "proc_fixture.hpp"
+#include <algorithm>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+using procfixture::makeFixtureRoot;
+
+void addProcess(const std::filesystem::path& root, int pid, int parent, uint64_t startTime = 100) {
+    procfixture::PidStat fields;
+    fields.ppid = parent;
+    fields.startTime = startTime;
+    procfixture::writePidStat(root, pid, "proc " + std::to_string(pid), fields);
+}
+
+void writeLastPid(const std::filesystem::path& root, int pid) {
+    std::ofstream(root / "loadavg") << "0.10 0.20 0.30 1/250 " << pid << "\n";
+}
+
+void removeProcess(const std::filesystem::path& root, int pid) {
+    std::filesystem::remove_all(root / std::to_string(pid));
+}
+}
+
+TEST_CASE("ProcessTree follows descendants and reads only new PIDs", "[linux][tree]") {
+    auto root = makeFixtureRoot("crossmon_tree_fixture");
+    addProcess(root, 1, 0);
+    addProcess(root, 100, 1);   // Root
+    addProcess(root, 101, 100);
+    addProcess(root, 102, 100);
+    addProcess(root, 103, 101); // Grandchild
+    addProcess(root, 200, 1);   // Unrelated
+    addProcess(root, 201, 200);
+    std::filesystem::create_directories(root / "self");
+
+    ProcessTree tree(root.string());
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.members() == std::vector<int>{100, 101, 102, 103});
+    REQUIRE(tree.knownProcesses() == 7);
+    REQUIRE(tree.lastStatReads() == 7);
+
+    // Nothing changed: no stat is read and the members stay
+    REQUIRE_FALSE(tree.refresh({100}));
+    REQUIRE(tree.lastStatReads() == 0);
+
+    // A new great-grandchild and a new unrelated process: only those two are read
+    addProcess(root, 104, 103);
+    addProcess(root, 202, 200);
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.lastStatReads() == 2);
+    REQUIRE(tree.members() == std::vector<int>{100, 101, 102, 103, 104});
+
+    // A child with a lower PID than its parent (after PID wrap-around)
+    addProcess(root, 50, 104);
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.members() == std::vector<int>{50, 100, 101, 102, 103, 104});
+
+    // The parent exits; its orphaned child keeps counting
+    removeProcess(root, 101);
+    addProcess(root, 103, 1);
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.members() == std::vector<int>{50, 100, 102, 103, 104});
+    REQUIRE(tree.lastStatReads() == 0);
+
+    // A reused PID is a new process and is re-resolved
+    removeProcess(root, 102);
+    REQUIRE(tree.refresh({100}));
+    addProcess(root, 102, 200, 999);
+    REQUIRE_FALSE(tree.refresh({100}));
+    REQUIRE(tree.lastStatReads() == 1);
+    REQUIRE(tree.members() == std::vector<int>{50, 100, 103, 104});
+
+    // Switching roots recomputes membership from the cached parents
+    REQUIRE(tree.refresh({200}));
+    REQUIRE(tree.members() == std::vector<int>{102, 200, 201, 202});
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("ProcessTree skips the listing while no PID was allocated", "[linux][tree]") {
+    auto root = makeFixtureRoot("crossmon_tree_loadavg");
+    addProcess(root, 1, 0);
+    addProcess(root, 100, 1);
+    writeLastPid(root, 100);
+
+    ProcessTree tree(root.string());
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.lastListed());
+    REQUIRE_FALSE(tree.refresh({100}));
+    REQUIRE_FALSE(tree.lastListed());
+
+    // A new root is resolved even without a new PID
+    REQUIRE(tree.refresh({1}));
+    REQUIRE(tree.lastListed());
+    REQUIRE(tree.members() == std::vector<int>{1, 100});
+
+    addProcess(root, 101, 100);
+    writeLastPid(root, 101);
+    REQUIRE(tree.refresh({1}));
+    REQUIRE(tree.lastListed());
+    REQUIRE(tree.lastStatReads() == 1);
+    REQUIRE(tree.members() == std::vector<int>{1, 100, 101});
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("ProcessTree re-resolves a PID reused between two listings", "[linux][tree]") {
+    auto root = makeFixtureRoot("crossmon_tree_reuse");
+    addProcess(root, 1, 0);
+    addProcess(root, 100, 1); // Root
+    addProcess(root, 101, 100);
+    addProcess(root, 102, 100);
+    addProcess(root, 200, 1);
+    addProcess(root, 201, 200);
+    writeLastPid(root, 201);
+
+    ProcessTree tree(root.string());
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.members() == std::vector<int>{100, 101, 102});
+
+    // The counter wrapped and handed 101 to an unrelated process before the
+    // next listing; only the cached PIDs in the wrapped range are re-read
+    addProcess(root, 101, 200, 999);
+    writeLastPid(root, 101);
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.lastStatReads() == 3); // 1, 100 and 101
+    REQUIRE(tree.members() == std::vector<int>{100, 102});
+
+    // An unrelated PID reused by a child of the root joins the tree
+    addProcess(root, 201, 100, 1000);
+    writeLastPid(root, 201);
+    REQUIRE(tree.refresh({100}));
+    REQUIRE(tree.lastStatReads() == 3); // 102, 200 and 201
+    REQUIRE(tree.members() == std::vector<int>{100, 102, 201});
+
+    REQUIRE(tree.refresh({200}));
+    REQUIRE(tree.members() == std::vector<int>{101, 200});
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("ProcessTree finds this process's children", "[linux][tree]") {
+    auto spawn = [] {
+        pid_t pid = fork();
+        if (pid == 0) {
+            pause();
+            _exit(0);
+        }
+        return static_cast<int>(pid);
+    };
+    const int self = static_cast<int>(getpid());
+    int first = spawn();
+    REQUIRE(first > 0);
+    ProcessTree tree;
+    REQUIRE(tree.refresh({self}));
+    REQUIRE(tree.members() == std::vector<int>{std::min(self, first), std::max(self, first)});
+
+    // The exit is picked up with the listing the next fork triggers
+    kill(first, SIGKILL);
+    waitpid(first, nullptr, 0);
+    int second = spawn();
+    REQUIRE(second > 0);
+    REQUIRE(tree.refresh({self}));
+    REQUIRE(tree.members() == std::vector<int>{std::min(self, second), std::max(self, second)});
+    kill(second, SIGKILL);
+    waitpid(second, nullptr, 0);
+}
+
+TEST_CASE("ProcessTree refresh cost with 5,000 processes", "[.][benchmark][tree]") {
+    auto root = makeFixtureRoot("crossmon_tree_bench");
+    // A few hundred independent trees, three levels deep
+    for (int pid = 2; pid < 5002; ++pid) {
+        addProcess(root, pid, pid % 16 == 2 ? 1 : pid - 1);
+    }
+    writeLastPid(root, 5001);
+    ProcessTree tree(root.string());
+    tree.refresh({2});
+    BENCHMARK("refresh, no PID allocated") {
+        return tree.refresh({2});
+    };
+    int next = 6000;
+    BENCHMARK("refresh, one process started and one exited") {
+        addProcess(root, next, 2);
+        removeProcess(root, next - 1);
+        writeLastPid(root, next);
+        ++next;
+        return tree.refresh({2});
+    };
+    std::filesystem::remove_all(root);
+}
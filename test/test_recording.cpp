@@ -0,0 +1,395 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "utils/recording.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::string tempPath(const char* name) {
+    return std::string(P_tmpdir) + "/" + name;
+}
+
+std::vector<char> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+constexpr std::size_t kTraceCores = 8;
+
+// A mostly idle 8-core machine sampled every second: per-core busy values come
+// from 100 Hz tick counters (whole percentages), memory drifts, the schedule jitters
+void writeTrace(const std::string& path, RecordingEncoding encoding, int count, bool lossy = false) {
+    RecordingHeader header = makeRecordingHeader(1000, kTraceCores, 1, "", encoding);
+    header.quantized = lossy ? 1 : 0;
+    RecordingWriter writer(1 << 20, count + 1);
+    REQUIRE(writer.open(path, header));
+    std::mt19937 rng(1234);
+    int cores[kTraceCores] = {};
+    uint64_t memory = 6000;
+    for (int i = 0; i < count; ++i) {
+        double coreValues[kTraceCores];
+        int busy = 0;
+        for (std::size_t c = 0; c < kTraceCores; ++c) {
+            if (rng() % 3 == 0) cores[c] = static_cast<int>(rng() % (c < 2 ? 40 : 4));
+            coreValues[c] = cores[c];
+            busy += cores[c];
+        }
+        if (rng() % 5 == 0) memory += rng() % 9 - 4;
+        SampleRecord record;
+        record.timestampNs = 1700000000000000000LL + i * 1000000000LL + static_cast<int64_t>(rng() % 200000);
+        record.cpuPercent = busy / static_cast<double>(kTraceCores);
+        record.memoryUsedMB = memory;
+        record.memoryTotalMB = 16384;
+        record.memoryUsedPercent = 100.0 * memory / 16384.0;
+        record.cpuLatencyMs = 0.05f + (rng() % 8) / 1024.0f;
+        record.memoryLatencyMs = 0.02f;
+        double gpuValue = 0.0;
+        REQUIRE(writer.append(record, coreValues, &gpuValue));
+    }
+    writer.close();
+    REQUIRE(writer.recordsWritten() == static_cast<uint64_t>(count));
+}
+}
+
+TEST_CASE("makeRecordingHeader describes the host and record layout", "[recording]") {
+    RecordingHeader header = makeRecordingHeader(250, 8, 2, "Test NPU");
+    REQUIRE(std::memcmp(header.magic, kRecordingMagic, sizeof(header.magic)) == 0);
+    REQUIRE(header.version == kRecordingVersion);
+    REQUIRE(header.intervalMs == 250);
+    REQUIRE(header.coreCount == 8);
+    REQUIRE(header.gpuCount == 2);
+    REQUIRE(header.recordBytes == sizeof(SampleRecord) + 10 * sizeof(double));
+    REQUIRE(std::string(header.npuName) == "Test NPU");
+    REQUIRE(std::strlen(header.host) > 0);
+    REQUIRE(std::strlen(header.kernel) > 0);
+}
+
+TEST_CASE("RecordingWriter appends fixed-width records across chunk growth", "[recording]") {
+    const std::string path = tempPath("crossmon_recording_test.bin");
+    const std::size_t cores = 4;
+    const std::size_t gpus = 1;
+    const int count = 2000; // Several 4 KB chunks
+    RecordingHeader header = makeRecordingHeader(100, cores, gpus, "");
+
+    RecordingWriter writer(4096, 4096);
+    REQUIRE(writer.open(path, header));
+    for (int i = 0; i < count; ++i) {
+        SampleRecord record;
+        record.timestampNs = 1000000000LL + i;
+        record.cpuPercent = i % 100;
+        record.memoryUsedMB = 1000 + i;
+        double coreValues[cores] = {1.0 * i, 2.0 * i, 3.0 * i, 4.0 * i};
+        double gpuValues[gpus] = {0.5 * i};
+        REQUIRE(writer.append(record, coreValues, gpuValues));
+    }
+    writer.close();
+    REQUIRE(writer.recordsWritten() == static_cast<uint64_t>(count));
+    REQUIRE(writer.recordsDropped() == 0);
+
+    std::vector<char> file = readFile(path);
+    REQUIRE(file.size() == kRecordingHeaderBytes + count * header.recordBytes); // Zero tail trimmed
+
+    RecordingHeader stored;
+    std::memcpy(&stored, file.data(), sizeof(stored));
+    REQUIRE(stored.recordBytes == header.recordBytes);
+    REQUIRE(stored.coreCount == cores);
+
+    for (int i : {0, 1, count / 2, count - 1}) {
+        const char* p = file.data() + kRecordingHeaderBytes + static_cast<std::size_t>(i) * header.recordBytes;
+        SampleRecord record;
+        std::memcpy(&record, p, sizeof(record));
+        REQUIRE(record.timestampNs == 1000000000LL + i);
+        REQUIRE(record.memoryUsedMB == static_cast<uint64_t>(1000 + i));
+        double values[cores + gpus];
+        std::memcpy(values, p + sizeof(record), sizeof(values));
+        REQUIRE(values[3] == 4.0 * i);
+        REQUIRE(values[4] == 0.5 * i);
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("RecordingWriter refuses samples when not open", "[recording]") {
+    RecordingWriter writer;
+    SampleRecord record;
+    REQUIRE_FALSE(writer.isOpen());
+    REQUIRE_FALSE(writer.append(record, nullptr, nullptr));
+    writer.close();
+}
+
+TEST_CASE("RecordingReader round-trips every sample written", "[recording]") {
+    const std::string path = tempPath("crossmon_reader_test.bin");
+    const std::size_t cores = 2;
+    RecordingHeader header = makeRecordingHeader(50, cores, 0, "");
+    {
+        RecordingWriter writer(4096, 2048);
+        REQUIRE(writer.open(path, header));
+        for (int i = 0; i < 1000; ++i) {
+            SampleRecord record;
+            record.timestampNs = (i + 1) * 50000000LL;
+            record.cpuPercent = i * 0.1;
+            record.memoryUsedMB = 4096 + i;
+            record.gpuLatencyMs = 0.25f;
+            double coreValues[cores] = {static_cast<double>(i), 100.0 - i};
+            REQUIRE(writer.append(record, coreValues, nullptr));
+        }
+    }
+
+    RecordingReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.header().intervalMs == 50);
+    REQUIRE(reader.header().coreCount == cores);
+
+    SampleRecord record;
+    double coreValues[cores];
+    int count = 0;
+    while (reader.next(record, coreValues, nullptr)) {
+        REQUIRE(record.timestampNs == (count + 1) * 50000000LL);
+        REQUIRE(record.cpuPercent == count * 0.1);
+        REQUIRE(record.memoryUsedMB == static_cast<uint64_t>(4096 + count));
+        REQUIRE(record.gpuLatencyMs == 0.25f);
+        REQUIRE(coreValues[1] == 100.0 - count);
+        ++count;
+    }
+    REQUIRE(count == 1000);
+
+    reader.rewind();
+    REQUIRE(reader.next(record, coreValues, nullptr));
+    REQUIRE(record.timestampNs == 50000000LL);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("RecordingReader keeps the sampled sources and still reads version 1", "[recording]") {
+    const std::string path = tempPath("crossmon_sampled_test.bin");
+    RecordingHeader header = makeRecordingHeader(100, 0, 0, "");
+    header.sampledSlots = 0x5;
+    {
+        RecordingWriter writer;
+        REQUIRE(writer.open(path, header));
+        SampleRecord record;
+        record.timestampNs = 1;
+        REQUIRE(writer.append(record, nullptr, nullptr));
+    }
+    RecordingReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.header().version == kRecordingVersion);
+    REQUIRE(reader.header().sampledSlots == 0x5);
+    reader.close();
+
+    // Version 1 files have no sampledSlots and must stay readable
+    std::vector<char> bytes = readFile(path);
+    uint32_t version = 1;
+    std::memcpy(bytes.data() + offsetof(RecordingHeader, version), &version, sizeof(version));
+    std::ofstream(path, std::ios::binary | std::ios::trunc)
+        .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.header().version == 1);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("RecordingReader stops at a truncated or zero-filled tail", "[recording]") {
+    const std::string path = tempPath("crossmon_truncated_test.bin");
+    RecordingHeader header = makeRecordingHeader(100, 0, 0, "");
+    {
+        std::ofstream out(path, std::ios::binary);
+        char block[kRecordingHeaderBytes] = {};
+        std::memcpy(block, &header, sizeof(header));
+        out.write(block, sizeof(block));
+        SampleRecord record;
+        record.timestampNs = 42;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        SampleRecord zero; // Unwritten space at the end of a chunk
+        out.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record) / 2); // Torn write
+    }
+
+    RecordingReader reader;
+    REQUIRE(reader.open(path));
+    SampleRecord record;
+    REQUIRE(reader.next(record, nullptr, nullptr));
+    REQUIRE(record.timestampNs == 42);
+    REQUIRE_FALSE(reader.next(record, nullptr, nullptr));
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("RecordingReader rejects files that are not recordings", "[recording]") {
+    const std::string path = tempPath("crossmon_not_a_recording.txt");
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 100; ++i) out << "CPU Usage Statistics\n";
+    }
+    RecordingReader reader;
+    REQUIRE_FALSE(reader.open(path));
+    REQUIRE_FALSE(reader.error().empty());
+    REQUIRE_FALSE(reader.open(tempPath("crossmon_missing_recording.bin")));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Gorilla recordings decode to exactly the raw samples", "[recording]") {
+    const std::string rawPath = tempPath("crossmon_trace_raw.bin");
+    const std::string packedPath = tempPath("crossmon_trace_gorilla.bin");
+    const int count = 20000;
+    writeTrace(rawPath, RecordingEncoding::Raw, count);
+    writeTrace(packedPath, RecordingEncoding::Gorilla, count);
+
+    std::size_t rawBytes = readFile(rawPath).size() - kRecordingHeaderBytes;
+    std::size_t packedBytes = readFile(packedPath).size() - kRecordingHeaderBytes;
+    INFO("raw " << rawBytes << " bytes, gorilla " << packedBytes << " bytes");
+    REQUIRE(packedBytes * 4 < rawBytes);
+
+    RecordingReader raw;
+    RecordingReader packed;
+    REQUIRE(raw.open(rawPath));
+    REQUIRE(packed.open(packedPath));
+    REQUIRE(packed.header().quantized == 0);
+    REQUIRE(packed.blockCount() == (count + kRecordingBlockSamples - 1) / kRecordingBlockSamples);
+
+    SampleRecord expected;
+    SampleRecord actual;
+    double expectedValues[kTraceCores + 1];
+    double actualValues[kTraceCores + 1];
+    int decoded = 0;
+    while (raw.next(expected, expectedValues, expectedValues + kTraceCores)) {
+        REQUIRE(packed.next(actual, actualValues, actualValues + kTraceCores));
+        REQUIRE(std::memcmp(&actual, &expected, sizeof(SampleRecord)) == 0);
+        for (std::size_t c = 0; c < kTraceCores + 1; ++c) REQUIRE(actualValues[c] == expectedValues[c]);
+        ++decoded;
+    }
+    REQUIRE(decoded == count);
+    REQUIRE_FALSE(packed.next(actual, actualValues, actualValues + kTraceCores));
+    std::remove(rawPath.c_str());
+    std::remove(packedPath.c_str());
+}
+
+TEST_CASE("Lossy Gorilla recordings round values and are far smaller", "[recording]") {
+    const std::string rawPath = tempPath("crossmon_trace_raw_lossy.bin");
+    const std::string packedPath = tempPath("crossmon_trace_lossy.bin");
+    const int count = 20000;
+    writeTrace(rawPath, RecordingEncoding::Raw, count);
+    writeTrace(packedPath, RecordingEncoding::Gorilla, count, true);
+
+    std::size_t rawBytes = readFile(rawPath).size() - kRecordingHeaderBytes;
+    std::size_t packedBytes = readFile(packedPath).size() - kRecordingHeaderBytes;
+    INFO("raw " << rawBytes << " bytes, lossy gorilla " << packedBytes << " bytes");
+    REQUIRE(packedBytes * 8 < rawBytes);
+
+    RecordingReader raw;
+    RecordingReader packed;
+    REQUIRE(raw.open(rawPath));
+    REQUIRE(packed.open(packedPath));
+    REQUIRE(packed.header().quantized == 1);
+
+    SampleRecord expected;
+    SampleRecord actual;
+    double expectedValues[kTraceCores + 1];
+    double actualValues[kTraceCores + 1];
+    int decoded = 0;
+    while (raw.next(expected, expectedValues, expectedValues + kTraceCores)) {
+        REQUIRE(packed.next(actual, actualValues, actualValues + kTraceCores));
+        REQUIRE(actual.timestampNs == expected.timestampNs);
+        REQUIRE(actual.memoryUsedMB == expected.memoryUsedMB);
+        REQUIRE(actual.memoryTotalMB == expected.memoryTotalMB);
+        REQUIRE(actual.cpuPercent == expected.cpuPercent);
+        REQUIRE(actual.memoryUsedPercent == Catch::Approx(expected.memoryUsedPercent).margin(1.0 / 256));
+        REQUIRE(actual.cpuLatencyMs == Catch::Approx(expected.cpuLatencyMs).margin(1.0 / 2048));
+        for (std::size_t c = 0; c < kTraceCores; ++c) REQUIRE(actualValues[c] == expectedValues[c]);
+        ++decoded;
+    }
+    REQUIRE(decoded == count);
+    REQUIRE_FALSE(packed.next(actual, actualValues, actualValues + kTraceCores));
+    packed.close();
+
+    // Compressed files from before version 3 were always rounded
+    std::vector<char> bytes = readFile(packedPath);
+    uint32_t version = 2;
+    uint32_t quantized = 0;
+    std::memcpy(bytes.data() + offsetof(RecordingHeader, version), &version, sizeof(version));
+    std::memcpy(bytes.data() + offsetof(RecordingHeader, quantized), &quantized, sizeof(quantized));
+    std::ofstream(packedPath, std::ios::binary | std::ios::trunc)
+        .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    REQUIRE(packed.open(packedPath));
+    REQUIRE(packed.header().quantized == 1);
+    std::remove(rawPath.c_str());
+    std::remove(packedPath.c_str());
+}
+
+TEST_CASE("Gorilla recordings support block-level random access", "[recording]") {
+    const std::string path = tempPath("crossmon_trace_seek.bin");
+    const int count = 2000;
+    writeTrace(path, RecordingEncoding::Gorilla, count);
+
+    RecordingReader reader;
+    REQUIRE(reader.open(path));
+    SampleRecord record;
+    double values[kTraceCores + 1];
+
+    REQUIRE(reader.seekBlock(3));
+    REQUIRE(reader.next(record, values, values + kTraceCores));
+    int64_t blockStart = record.timestampNs;
+    REQUIRE(blockStart >= 1700000000000000000LL + 3LL * kRecordingBlockSamples * 1000000000LL);
+    REQUIRE(blockStart < 1700000000000000000LL + (3LL * kRecordingBlockSamples + 1) * 1000000000LL);
+
+    // Any timestamp inside block 5 lands on the start of block 5
+    REQUIRE(reader.seekTime(1700000000000000000LL + (5LL * kRecordingBlockSamples + 17) * 1000000000LL));
+    REQUIRE(reader.next(record, values, values + kTraceCores));
+    REQUIRE(record.timestampNs / 1000000000LL == 1700000000LL + 5LL * kRecordingBlockSamples);
+
+    REQUIRE_FALSE(reader.seekBlock(reader.blockCount()));
+    REQUIRE_FALSE(reader.seekTime(1800000000000000000LL));
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Gorilla recordings keep complete blocks when the tail is torn", "[recording]") {
+    const std::string path = tempPath("crossmon_trace_torn.bin");
+    writeTrace(path, RecordingEncoding::Gorilla, 1000);
+    std::vector<char> file = readFile(path);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(file.data(), static_cast<std::streamsize>(file.size() - 10));
+    }
+
+    RecordingReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.blockCount() == 1000 / kRecordingBlockSamples);
+    SampleRecord record;
+    double values[kTraceCores + 1];
+    std::size_t count = 0;
+    while (reader.next(record, values, values + kTraceCores)) ++count;
+    REQUIRE(count == (1000 / kRecordingBlockSamples) * kRecordingBlockSamples);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Recording decode throughput, raw vs Gorilla", "[.][benchmark]") {
+    const std::string rawPath = tempPath("crossmon_bench_raw.bin");
+    const std::string packedPath = tempPath("crossmon_bench_gorilla.bin");
+    const int count = 200000;
+    writeTrace(rawPath, RecordingEncoding::Raw, count);
+    writeTrace(packedPath, RecordingEncoding::Gorilla, count);
+
+    auto decodeAll = [](const std::string& path) {
+        RecordingReader reader;
+        reader.open(path);
+        SampleRecord record;
+        double values[kTraceCores + 1];
+        double sum = 0.0;
+        while (reader.next(record, values, values + kTraceCores)) sum += record.cpuPercent + values[0];
+        return sum;
+    };
+    BENCHMARK("raw 200K samples") { return decodeAll(rawPath); };
+    BENCHMARK("gorilla 200K samples") { return decodeAll(packedPath); };
+    std::remove(rawPath.c_str());
+    std::remove(packedPath.c_str());
+}
+
@@ -0,0 +1,199 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "utils/sample_scheduler.hpp"
+#include <chrono>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std::chrono;
+
+namespace {
+// Deterministic clock: time only moves when the test or a sleep moves it
+class FakeClock : public ISchedulerClock {
+public:
+    time_point now() override { return current; }
+    bool sleepUntil(time_point deadline) override {
+        if (deadline > current) current = deadline;
+        current += wakeLatency;
+        return !interruptNext;
+    }
+    void advance(nanoseconds d) { current += d; }
+
+    time_point current{};
+    nanoseconds wakeLatency{0};
+    bool interruptNext = false;
+};
+}
+
+TEST_CASE("SampleScheduler fires on absolute deadlines without drift", "[scheduler]") {
+    FakeClock clock;
+    auto start = clock.current;
+    SampleScheduler scheduler(microseconds(250), OverrunPolicy::Skip, clock);
+
+    for (int k = 1; k <= 1000; ++k) {
+        REQUIRE(scheduler.waitNext());
+        REQUIRE(scheduler.currentDeadline() == start + k * microseconds(250));
+        clock.advance(microseconds(100)); // collection time must not push the next tick out
+    }
+    REQUIRE(scheduler.stats().ticks == 1000);
+    REQUIRE(scheduler.stats().overruns == 0);
+    REQUIRE(scheduler.stats().maxJitterUs == 0.0);
+    REQUIRE(scheduler.stats().intervalMs == Catch::Approx(0.25));
+}
+
+TEST_CASE("SampleScheduler records wake-up jitter", "[scheduler]") {
+    FakeClock clock;
+    clock.wakeLatency = microseconds(30);
+    SampleScheduler scheduler(microseconds(500), OverrunPolicy::Skip, clock);
+    for (int i = 0; i < 10; ++i) REQUIRE(scheduler.waitNext());
+    REQUIRE(scheduler.stats().meanJitterUs == Catch::Approx(30.0));
+    REQUIRE(scheduler.stats().maxJitterUs == Catch::Approx(30.0));
+    REQUIRE(scheduler.stats().overruns == 0);
+}
+
+TEST_CASE("SampleScheduler skip policy drops missed deadlines", "[scheduler]") {
+    FakeClock clock;
+    auto start = clock.current;
+    SampleScheduler scheduler(microseconds(100), OverrunPolicy::Skip, clock);
+
+    REQUIRE(scheduler.waitNext());             // deadline 100
+    clock.advance(microseconds(350));          // slow tick: now 450, deadlines 200..400 missed
+    REQUIRE(scheduler.waitNext());
+    // Runs immediately for the most recent missed deadline and stays on the grid
+    REQUIRE(scheduler.currentDeadline() == start + microseconds(400));
+    REQUIRE(scheduler.stats().overruns == 1);
+    REQUIRE(scheduler.stats().skippedTicks == 2);
+    REQUIRE(scheduler.stats().maxJitterUs == Catch::Approx(50.0));
+
+    REQUIRE(scheduler.waitNext());
+    REQUIRE(scheduler.currentDeadline() == start + microseconds(500));
+    REQUIRE(scheduler.stats().ticks == 3);
+}
+
+TEST_CASE("SampleScheduler catch-up policy replays missed deadlines", "[scheduler]") {
+    FakeClock clock;
+    auto start = clock.current;
+    SampleScheduler scheduler(microseconds(100), OverrunPolicy::CatchUp, clock);
+
+    REQUIRE(scheduler.waitNext());             // deadline 100
+    clock.advance(microseconds(350));          // now 450
+    std::vector<nanoseconds> deadlines;
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(scheduler.waitNext());
+        deadlines.push_back(scheduler.currentDeadline() - start);
+    }
+    // 200, 300 and 400 fire back to back at t=450, then 500 waits as usual
+    REQUIRE(deadlines[0] == microseconds(200));
+    REQUIRE(deadlines[1] == microseconds(300));
+    REQUIRE(deadlines[2] == microseconds(400));
+    REQUIRE(deadlines[3] == microseconds(500));
+    REQUIRE(clock.current - start == microseconds(500));
+    REQUIRE(scheduler.stats().overruns == 3);
+    REQUIRE(scheduler.stats().skippedTicks == 0);
+    REQUIRE(scheduler.stats().maxJitterUs == Catch::Approx(250.0));
+}
+
+TEST_CASE("SampleScheduler stops when the sleep is interrupted", "[scheduler]") {
+    FakeClock clock;
+    SampleScheduler scheduler(milliseconds(1), OverrunPolicy::Skip, clock);
+    REQUIRE(scheduler.waitNext());
+    clock.interruptNext = true;
+    REQUIRE_FALSE(scheduler.waitNext());
+    REQUIRE(scheduler.stats().ticks == 1);
+}
+
+TEST_CASE("SampleScheduler setInterval moves the next deadline", "[scheduler]") {
+    FakeClock clock;
+    auto start = clock.current;
+    SampleScheduler scheduler(milliseconds(100), OverrunPolicy::Skip, clock);
+    REQUIRE(scheduler.waitNext());
+    scheduler.setInterval(milliseconds(400));
+    REQUIRE(scheduler.waitNext());
+    REQUIRE(scheduler.currentDeadline() == start + milliseconds(500));
+    scheduler.setInterval(milliseconds(100));
+    REQUIRE(scheduler.waitNext());
+    REQUIRE(scheduler.currentDeadline() == start + milliseconds(600));
+    REQUIRE(scheduler.stats().overruns == 0);
+}
+
+TEST_CASE("AdaptiveInterval backs off while flat and tightens on movement", "[scheduler][adaptive]") {
+    AdaptiveInterval adaptive(milliseconds(100), milliseconds(2000), 5.0, 2);
+    double flat[] = {3.0, 40.0};
+    // After the hold the interval doubles each flat tick, up to the maximum
+    for (int i = 0; i < AdaptiveInterval::kHoldTicks; ++i) REQUIRE(adaptive.observe(flat) == milliseconds(100));
+    REQUIRE(adaptive.observe(flat) == milliseconds(200));
+    REQUIRE(adaptive.observe(flat) == milliseconds(400));
+    for (int i = 0; i < 10; ++i) adaptive.observe(flat);
+    REQUIRE(adaptive.current() == milliseconds(2000));
+    REQUIRE(adaptive.tightenings() == 0);
+
+    // Small noise below the step keeps it backed off
+    double noisy[] = {4.0, 41.0};
+    REQUIRE(adaptive.observe(noisy) == milliseconds(2000));
+
+    // One signal stepping is enough to snap back, and the interval holds there
+    double spike[] = {4.0, 90.0};
+    REQUIRE(adaptive.observe(spike) == milliseconds(100));
+    REQUIRE(adaptive.tightenings() == 1);
+    for (int i = 0; i < AdaptiveInterval::kHoldTicks; ++i) REQUIRE(adaptive.observe(spike) == milliseconds(100));
+    REQUIRE(adaptive.observe(spike) == milliseconds(200));
+}
+
+TEST_CASE("AdaptiveInterval tightens on a drift away from the recent mean", "[scheduler][adaptive]") {
+    AdaptiveInterval adaptive(milliseconds(100), milliseconds(1600), 5.0, 1);
+    double value = 20.0;
+    for (int i = 0; i < 20; ++i) adaptive.observe(&value);
+    REQUIRE(adaptive.current() == milliseconds(1600));
+    // Each step is below 5 points, but the level leaves its three-sigma band
+    bool tightened = false;
+    for (int i = 0; i < 5 && !tightened; ++i) {
+        value += 4.0;
+        tightened = adaptive.observe(&value) == milliseconds(100);
+    }
+    REQUIRE(tightened);
+}
+
+TEST_CASE("sampleWeight measures time in shortest intervals", "[scheduler][adaptive]") {
+    REQUIRE(sampleWeight(0, 5000000000, milliseconds(100)) == 1.0);
+    REQUIRE(sampleWeight(1000000000, 1100000000, milliseconds(100)) == Catch::Approx(1.0));
+    REQUIRE(sampleWeight(1000000000, 2600000000, milliseconds(100)) == Catch::Approx(16.0));
+    REQUIRE(sampleWeight(2000000000, 1000000000, milliseconds(100)) == 1.0);
+}
+
+TEST_CASE("SampleScheduler with the steady clock keeps the cadence", "[scheduler]") {
+    SteadySchedulerClock clock;
+    auto start = steady_clock::now();
+    SampleScheduler scheduler(milliseconds(5), OverrunPolicy::Skip, clock);
+    for (int i = 0; i < 10; ++i) REQUIRE(scheduler.waitNext());
+    // Deadlines are absolute, so ten ticks end at ~50 ms regardless of loop overhead
+    REQUIRE(steady_clock::now() - start >= milliseconds(50));
+    REQUIRE(scheduler.stats().ticks == 10);
+}
+
+#ifndef _WIN32
+TEST_CASE("WakeableSchedulerClock ends the sleep when its descriptor is readable", "[scheduler]") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    WakeableSchedulerClock clock(fds[0]);
+
+    // Nothing to read: sleeps to the deadline
+    auto start = clock.now();
+    REQUIRE(clock.sleepUntil(start + milliseconds(20)));
+    REQUIRE(clock.now() >= start + milliseconds(20));
+
+    // Readable: returns early, and so does the scheduler
+    char byte = 1;
+    REQUIRE(write(fds[1], &byte, 1) == 1);
+    start = clock.now();
+    REQUIRE_FALSE(clock.sleepUntil(start + seconds(10)));
+    REQUIRE(clock.now() < start + seconds(5));
+    SampleScheduler scheduler(seconds(10), OverrunPolicy::Skip, clock);
+    REQUIRE_FALSE(scheduler.waitNext());
+
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
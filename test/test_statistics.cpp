@@ -1,7 +1,13 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "utils/statistics.hpp"
+#include "utils/reduce_kernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
 #include <vector>
 
 TEST_CASE("Statistics: average, peak, min, max", "[statistics]") {
@@ -22,4 +28,496 @@ TEST_CASE("Statistics: empty vector", "[statistics]") {
     REQUIRE(stats.max == 0.0);
     REQUIRE(stats.min == 0.0);
     REQUIRE(stats.average == 0.0);
-} 
\ No newline at end of file
+} 
+TEST_CASE("PerCoreSeries keeps one contiguous column per core", "[statistics][percore]") {
+    PerCoreSeries series;
+    series.reset(3);
+    // Enough rows to force several re-layouts
+    for (int t = 0; t < 200; ++t) {
+        double row[3] = {static_cast<double>(t), 100.0, 0.5 * t};
+        series.append(row);
+    }
+    REQUIRE(series.coreCount() == 3);
+    REQUIRE(series.sampleCount() == 200);
+    for (int t = 0; t < 200; ++t) {
+        REQUIRE(series.column(0)[t] == t);
+        REQUIRE(series.column(1)[t] == 100.0);
+        REQUIRE(series.column(2)[t] == 0.5 * t);
+    }
+}
+
+TEST_CASE("Statistics: per-core peak, average and imbalance", "[statistics][percore]") {
+    // Four cores, one of them pegged: the aggregate hides it, the breakdown must not
+    PerCoreSeries series;
+    series.reset(4);
+    std::vector<double> aggregate;
+    for (int t = 0; t < 10; ++t) {
+        double row[4] = {0.0, 100.0, 0.0, t % 2 ? 20.0 : 0.0};
+        series.append(row);
+        aggregate.push_back((row[0] + row[1] + row[2] + row[3]) / 4.0);
+    }
+    CpuStats stats = computeCpuStats(aggregate, series);
+    REQUIRE(stats.samples == 10);
+    REQUIRE(stats.coreAverage.size() == 4);
+    REQUIRE(stats.busiestCore == 1);
+    REQUIRE(stats.corePeak[1] == 100.0);
+    REQUIRE(stats.coreAverage[1] == Catch::Approx(100.0));
+    REQUIRE(stats.corePeak[3] == 20.0);
+    REQUIRE(stats.coreAverage[3] == Catch::Approx(10.0));
+    // Busiest core is always 100; the per-sample mean alternates 25 and 30
+    REQUIRE(stats.imbalance == Catch::Approx(100.0 - 27.5));
+}
+
+TEST_CASE("Statistics: per-core breakdown absent without per-core samples", "[statistics][percore]") {
+    PerCoreSeries series;
+    CpuStats stats = computeCpuStats({10.0, 20.0}, series);
+    REQUIRE(stats.samples == 2);
+    REQUIRE(stats.coreAverage.empty());
+    REQUIRE(stats.imbalance == 0.0);
+}
+
+TEST_CASE("Statistics: collector latency average and max", "[statistics][latency]") {
+    std::vector<CollectorLatency> latencies(2);
+    latencies[0].cpuMs = 100.0;
+    latencies[0].gpuMs = 4.0;
+    latencies[1].cpuMs = 110.0;
+    latencies[1].gpuMs = 2.0;
+    latencies[1].memoryMs = 0.5;
+    LatencyStats stats = computeLatencyStats(latencies);
+    REQUIRE(stats.samples == 2);
+    REQUIRE(stats.average.cpuMs == Catch::Approx(105.0));
+    REQUIRE(stats.max.cpuMs == 110.0);
+    REQUIRE(stats.average.gpuMs == Catch::Approx(3.0));
+    REQUIRE(stats.max.memoryMs == 0.5);
+    REQUIRE(computeLatencyStats({}).samples == 0);
+}
+
+TEST_CASE("Statistics: monitor overhead averages and budget", "[statistics][overhead]") {
+    OverheadStats stats;
+    stats.intervalMs = 100.0;
+    stats.budgetPercent = 1.0; // 1 ms of CPU per 100 ms tick
+
+    TickOverhead cheap;
+    cheap.collectorCpu.cpuMs = 0.2;
+    cheap.collectCpuMs = 0.4;
+    cheap.outputCpuMs = 0.1;
+    cheap.outputWallMs = 0.3;
+    cheap.rssKB = 4096;
+    cheap.syscalls = 10;
+    REQUIRE(accumulateOverhead(stats, cheap));
+
+    TickOverhead costly = cheap;
+    costly.collectCpuMs = 1.4;
+    costly.outputWallMs = 0.9;
+    costly.rssKB = 6144;
+    costly.syscalls = 20;
+    REQUIRE_FALSE(accumulateOverhead(stats, costly));
+
+    REQUIRE(stats.ticks == 2);
+    REQUIRE(stats.overBudgetTicks == 1);
+    REQUIRE(stats.averageTickCpuMs == Catch::Approx(1.0));
+    REQUIRE(stats.maxTickCpuMs == Catch::Approx(1.5));
+    REQUIRE(stats.tickCpuPercent(stats.averageTickCpuMs) == Catch::Approx(1.0));
+    REQUIRE(stats.averageCollectorCpu.cpuMs == Catch::Approx(0.2));
+    REQUIRE(stats.averageOutputWallMs == Catch::Approx(0.6));
+    REQUIRE(stats.maxOutputWallMs == Catch::Approx(0.9));
+    REQUIRE(stats.averageRssKB == Catch::Approx(5120.0));
+    REQUIRE(stats.peakRssKB == 6144);
+    REQUIRE(stats.averageSyscalls == Catch::Approx(15.0));
+
+    // Without a budget every tick is within it
+    OverheadStats unlimited;
+    unlimited.intervalMs = 100.0;
+    REQUIRE(accumulateOverhead(unlimited, costly));
+    REQUIRE(unlimited.overBudgetTicks == 0);
+}
+
+TEST_CASE("RunningStats matches two-pass statistics", "[statistics][streaming]") {
+    std::vector<double> values = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    RunningStats stats;
+    for (double v : values) stats.add(v);
+    REQUIRE(stats.count() == 8);
+    REQUIRE(stats.min() == 2.0);
+    REQUIRE(stats.max() == 9.0);
+    REQUIRE(stats.mean() == Catch::Approx(5.0));
+    REQUIRE(stats.variance() == Catch::Approx(4.0));
+    REQUIRE(stats.stddev() == Catch::Approx(2.0));
+}
+
+TEST_CASE("RunningStats stays stable for large offsets", "[statistics][streaming]") {
+    // Naive sum-of-squares loses all precision here; Welford does not
+    RunningStats stats;
+    for (int i = 0; i < 1000; ++i) stats.add(1e9 + (i % 2));
+    REQUIRE(stats.mean() == Catch::Approx(1e9 + 0.5));
+    REQUIRE(stats.variance() == Catch::Approx(0.25));
+}
+
+TEST_CASE("RunningStats merge equals a single accumulator", "[statistics][streaming]") {
+    RunningStats all, left, right;
+    for (int i = 0; i < 100; ++i) {
+        double v = (i * 37) % 101;
+        all.add(v);
+        (i < 30 ? left : right).add(v);
+    }
+    left.merge(right);
+    REQUIRE(left.count() == all.count());
+    REQUIRE(left.mean() == Catch::Approx(all.mean()));
+    REQUIRE(left.variance() == Catch::Approx(all.variance()));
+    REQUIRE(left.min() == all.min());
+    REQUIRE(left.max() == all.max());
+
+    RunningStats empty;
+    empty.merge(all);
+    REQUIRE(empty.count() == all.count());
+}
+
+TEST_CASE("RunningStats weights a sample as if it were repeated", "[statistics][streaming]") {
+    RunningStats weighted, repeated;
+    double values[] = {10.0, 40.0, 25.0};
+    double weights[] = {1.0, 3.0, 2.0};
+    for (int i = 0; i < 3; ++i) {
+        weighted.add(values[i], weights[i]);
+        for (int k = 0; k < static_cast<int>(weights[i]); ++k) repeated.add(values[i]);
+    }
+    REQUIRE(weighted.count() == 3);
+    REQUIRE(weighted.mean() == Catch::Approx(repeated.mean()));
+    REQUIRE(weighted.variance() == Catch::Approx(repeated.variance()));
+    REQUIRE(weighted.min() == 10.0);
+    REQUIRE(weighted.max() == 40.0);
+
+    // Merging keeps the weights, not just the sample counts
+    RunningStats light, heavy;
+    light.add(0.0, 1.0);
+    heavy.add(100.0, 3.0);
+    light.merge(heavy);
+    REQUIRE(light.count() == 2);
+    REQUIRE(light.mean() == Catch::Approx(75.0));
+
+    RunningStats ignored;
+    ignored.add(5.0, 0.0);
+    REQUIRE(ignored.count() == 0);
+}
+
+TEST_CASE("PerCoreAccumulator and QuantileSketch take weighted samples", "[statistics][streaming]") {
+    PerCoreAccumulator perCore;
+    perCore.reset(2);
+    double quiet[] = {0.0, 10.0};
+    double busy[] = {100.0, 10.0};
+    perCore.add(quiet, 3.0);
+    perCore.add(busy, 1.0);
+    REQUIRE(perCore.sampleCount() == 2);
+    REQUIRE(perCore.average(0) == Catch::Approx(25.0));
+    REQUIRE(perCore.average(1) == Catch::Approx(10.0));
+    REQUIRE(perCore.peak(0) == 100.0);
+    REQUIRE(perCore.averageImbalance() == Catch::Approx((3.0 * 5.0 + 45.0) / 4.0));
+
+    QuantileSketch sketch;
+    sketch.add(1.0, 9);
+    sketch.add(50.0);
+    REQUIRE(sketch.count() == 10);
+    REQUIRE(sketch.quantile(0.9) == Catch::Approx(1.0).margin(0.01));
+    REQUIRE(sketch.quantile(1.0) == Catch::Approx(50.0).epsilon(0.01));
+}
+
+TEST_CASE("Statistics: streaming stats equal the vector path", "[statistics][streaming]") {
+    std::vector<double> cpu = {10.0, 20.0, 30.0, 40.0, 50.0};
+    RunningStats running;
+    for (double v : cpu) running.add(v);
+    CpuStats fromVector = computeCpuStats(cpu);
+    CpuStats fromRunning = computeCpuStats(running);
+    REQUIRE(fromRunning.samples == fromVector.samples);
+    REQUIRE(fromRunning.peak == fromVector.peak);
+    REQUIRE(fromRunning.min == fromVector.min);
+    REQUIRE(fromRunning.average == Catch::Approx(fromVector.average));
+    REQUIRE(fromRunning.stddev == Catch::Approx(fromVector.stddev));
+
+    RunningStats usedMB, usedPercent;
+    for (uint64_t mb : {1000ULL, 2000ULL, 3000ULL}) {
+        usedMB.add(static_cast<double>(mb));
+        usedPercent.add(mb / 100.0);
+    }
+    MemoryStats memory = computeMemoryStats(usedMB, usedPercent);
+    REQUIRE(memory.samples == 3);
+    REQUIRE(memory.peakUsedMB == 3000);
+    REQUIRE(memory.minUsedMB == 1000);
+    REQUIRE(memory.avgUsedMB == 2000);
+    REQUIRE(memory.avgUsedPercent == Catch::Approx(20.0));
+}
+
+TEST_CASE("PerCoreAccumulator matches the column history", "[statistics][percore][streaming]") {
+    PerCoreSeries series;
+    PerCoreAccumulator accumulator;
+    series.reset(4);
+    accumulator.reset(4);
+    RunningStats aggregate;
+    for (int t = 0; t < 10; ++t) {
+        double row[4] = {0.0, 100.0, 0.0, t % 2 ? 20.0 : 0.0};
+        series.append(row);
+        accumulator.add(row);
+        aggregate.add((row[0] + row[1] + row[2] + row[3]) / 4.0);
+    }
+    CpuStats exact = computeCpuStats(std::vector<double>(10, 0.0), series);
+    CpuStats streaming = computeCpuStats(aggregate, accumulator);
+    REQUIRE(streaming.busiestCore == exact.busiestCore);
+    REQUIRE(streaming.imbalance == Catch::Approx(exact.imbalance));
+    for (std::size_t c = 0; c < 4; ++c) {
+        REQUIRE(streaming.corePeak[c] == exact.corePeak[c]);
+        REQUIRE(streaming.coreAverage[c] == Catch::Approx(exact.coreAverage[c]));
+    }
+}
+
+TEST_CASE("Statistics: per-GPU peak and average", "[statistics][pergpu]") {
+    PerCoreAccumulator perGpu;
+    perGpu.reset(2);
+    RunningStats average;
+    for (int t = 0; t < 4; ++t) {
+        double row[2] = {10.0 * t, 50.0};
+        perGpu.add(row);
+        average.add((row[0] + row[1]) / 2.0);
+    }
+    GpuStats stats = computeGpuStats(average, 2, perGpu);
+    REQUIRE(stats.gpuCount == 2);
+    REQUIRE(stats.devicePeak.size() == 2);
+    REQUIRE(stats.devicePeak[0] == 30.0);
+    REQUIRE(stats.deviceAverage[0] == Catch::Approx(15.0));
+    REQUIRE(stats.deviceAverage[1] == Catch::Approx(50.0));
+
+    PerCoreAccumulator none;
+    REQUIRE(computeGpuStats(average, 0, none).deviceAverage.empty());
+}
+
+TEST_CASE("Statistics: process usage keeps totals and adds peak and average", "[statistics][process]") {
+    RunningStats cpu;
+    RunningStats rssKB;
+    RunningStats pssKB;
+    ProcessStats totals;
+    totals.name = "server";
+    totals.peakProcesses = 3;
+    totals.majorFaults = 9;
+    REQUIRE(computeProcessStats(cpu, rssKB, pssKB, totals).samples == 0);
+
+    for (double v : {50.0, 150.0, 100.0}) {
+        cpu.add(v);
+        rssKB.add(v * 1024.0);
+        pssKB.add(v * 512.0);
+    }
+    ProcessStats stats = computeProcessStats(cpu, rssKB, pssKB, totals);
+    REQUIRE(stats.name == "server");
+    REQUIRE(stats.samples == 3);
+    REQUIRE(stats.peakProcesses == 3);
+    REQUIRE(stats.majorFaults == 9);
+    REQUIRE(stats.peakCpu == 150.0);
+    REQUIRE(stats.avgCpu == Catch::Approx(100.0));
+    REQUIRE(stats.peakRssKB == 153600);
+    REQUIRE(stats.avgPssKB == 51200);
+}
+
+namespace {
+// Utilisation-like mix: mostly idle, a busy mode and a heavy tail up to 100%
+std::vector<double> utilizationValues(std::size_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> idle(0.5);
+    std::normal_distribution<double> busy(65.0, 10.0);
+    std::uniform_real_distribution<double> pick(0.0, 1.0);
+    std::vector<double> values(n);
+    for (auto& v : values) {
+        double r = pick(rng);
+        v = r < 0.7 ? idle(rng) : r < 0.99 ? busy(rng) : 90.0 + 10.0 * pick(rng);
+        v = std::min(std::max(v, 0.0), 100.0);
+    }
+    return values;
+}
+
+double exactQuantile(std::vector<double>& sorted, double q) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(q * sorted.size()));
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+void requireSketchMatchesSort(std::vector<double> values, const QuantileSketch& sketch) {
+    std::sort(values.begin(), values.end());
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        double exact = exactQuantile(values, q);
+        double estimate = sketch.quantile(q);
+        // Relative error bound of the 7-bit sketch, plus one quantisation step
+        REQUIRE(std::fabs(estimate - exact) <= exact / 128.0 + 0.01);
+    }
+    // The extremes are exact, so no quantile falls outside the observed range
+    REQUIRE(sketch.quantile(0.0) == values.front());
+    REQUIRE(sketch.quantile(1.0) == values.back());
+    REQUIRE(sketch.min() == values.front());
+    REQUIRE(sketch.max() == values.back());
+}
+}
+
+TEST_CASE("QuantileSketch percentiles agree with an exact sort", "[statistics][sketch]") {
+    std::vector<double> values = utilizationValues(1000000, 42);
+    QuantileSketch sketch;
+    for (double v : values) sketch.add(v);
+    REQUIRE(sketch.count() == values.size());
+    requireSketchMatchesSort(values, sketch);
+}
+
+TEST_CASE("QuantileSketch handles large integer ranges", "[statistics][sketch]") {
+    // Memory in MB: 1 MB resolution up to 16 TB
+    QuantileSketch sketch(1.0, 16.0 * 1024 * 1024);
+    std::vector<double> values;
+    for (int i = 1; i <= 100000; ++i) values.push_back(static_cast<double>(i) * 37.0);
+    for (double v : values) sketch.add(v);
+    requireSketchMatchesSort(values, sketch);
+    REQUIRE(sketch.bucketCount() < 4096);
+}
+
+TEST_CASE("QuantileSketch small values are exact and out-of-range values clamp", "[statistics][sketch]") {
+    // Below 2^8 units (2.56 at 0.01 resolution) every unit has its own bucket
+    QuantileSketch sketch;
+    for (double v : {0.5, 1.0, 1.5, 2.0}) sketch.add(v);
+    REQUIRE(sketch.quantile(0.5) == Catch::Approx(1.0));
+    REQUIRE(sketch.quantile(1.0) == Catch::Approx(2.0));
+    REQUIRE(sketch.quantile(0.0) == Catch::Approx(0.5));
+
+    QuantileSketch clamped;
+    clamped.add(-5.0);
+    clamped.add(250.0);
+    REQUIRE(clamped.quantile(0.0) == 0.0);
+    REQUIRE(clamped.quantile(1.0) <= clamped.max());
+    REQUIRE(clamped.quantile(1.0) == 100.0);
+
+    QuantileSketch empty;
+    REQUIRE(empty.quantile(0.99) == 0.0);
+}
+
+TEST_CASE("QuantileSketch quantiles stay within the observed range", "[statistics][sketch]") {
+    // A bucket midpoint above the only value seen (the reported 100.2% on a 1-core run)
+    QuantileSketch cpu;
+    for (int i = 0; i < 10; ++i) cpu.add(100.0);
+    REQUIRE(cpu.quantile(0.5) == 100.0);
+    REQUIRE(cpu.quantile(1.0) == 100.0);
+
+    // And one below the smallest (P50 618 MB against a 619 MB minimum)
+    QuantileSketch memory(1.0, 16.0 * 1024 * 1024);
+    memory.add(619.0);
+    memory.add(620.0);
+    memory.add(621.0);
+    REQUIRE(memory.quantile(0.0) >= 619.0);
+    REQUIRE(memory.quantile(0.5) >= 619.0);
+    REQUIRE(memory.quantile(1.0) <= 621.0);
+}
+
+TEST_CASE("QuantileSketch merges runs losslessly", "[statistics][sketch]") {
+    std::vector<double> first = utilizationValues(50000, 1);
+    std::vector<double> second = utilizationValues(70000, 2);
+    QuantileSketch a, b, all;
+    for (double v : first) { a.add(v); all.add(v); }
+    for (double v : second) { b.add(v); all.add(v); }
+    REQUIRE(a.merge(b));
+    REQUIRE(a.count() == all.count());
+    for (double q : {0.1, 0.5, 0.9, 0.99, 0.999}) {
+        REQUIRE(a.quantile(q) == all.quantile(q));
+    }
+    REQUIRE(a.min() == all.min());
+    REQUIRE(a.max() == all.max());
+
+    QuantileSketch other(1.0, 1024.0);
+    REQUIRE_FALSE(a.merge(other));
+    REQUIRE(a.count() == all.count());
+}
+
+TEST_CASE("computePercentiles reads p50/p90/p99/p99.9", "[statistics][sketch]") {
+    QuantileSketch sketch;
+    for (int i = 1; i <= 1000; ++i) sketch.add(i / 10.0);
+    Percentiles p = computePercentiles(sketch);
+    REQUIRE(p.p50 == Catch::Approx(50.0).epsilon(0.01));
+    REQUIRE(p.p90 == Catch::Approx(90.0).epsilon(0.01));
+    REQUIRE(p.p99 == Catch::Approx(99.0).epsilon(0.01));
+    REQUIRE(p.p999 == Catch::Approx(99.9).epsilon(0.01));
+}
+
+TEST_CASE("QuantileSketch accuracy and throughput at 10M values", "[.][benchmark][sketch]") {
+    std::vector<double> values = utilizationValues(10000000, 7);
+    QuantileSketch sketch;
+    for (double v : values) sketch.add(v);
+    requireSketchMatchesSort(values, sketch);
+
+    BENCHMARK("QuantileSketch::add x10M") {
+        QuantileSketch s;
+        for (double v : values) s.add(v);
+        return s.count();
+    };
+
+    BENCHMARK("exact sort x10M") {
+        std::vector<double> copy = values;
+        std::sort(copy.begin(), copy.end());
+        return copy[copy.size() / 2];
+    };
+}
+
+TEST_CASE("Fused reduction kernels agree with the scalar path", "[statistics][kernel]") {
+    // Odd lengths exercise the vector tails
+    for (std::size_t n : {1u, 3u, 7u, 8u, 9u, 31u, 1000u, 4097u}) {
+        std::vector<double> values = utilizationValues(n, static_cast<unsigned>(n));
+        ReduceResult scalar = reduceFusedWith(ReduceIsa::Scalar, values.data(), n, values[0]);
+        REQUIRE(scalar.min == *std::min_element(values.begin(), values.end()));
+        REQUIRE(scalar.max == *std::max_element(values.begin(), values.end()));
+        REQUIRE(scalar.mean() == Catch::Approx(std::accumulate(values.begin(), values.end(), 0.0) / n));
+
+        for (ReduceIsa isa : {ReduceIsa::Sse2, ReduceIsa::Avx2}) {
+            if (!isReduceIsaSupported(isa)) continue;
+            ReduceResult r = reduceFusedWith(isa, values.data(), n, values[0]);
+            REQUIRE(r.count == n);
+            REQUIRE(r.min == scalar.min);
+            REQUIRE(r.max == scalar.max);
+            REQUIRE(r.mean() == Catch::Approx(scalar.mean()));
+            REQUIRE(r.variance() == Catch::Approx(scalar.variance()).margin(1e-9));
+        }
+    }
+}
+
+TEST_CASE("Fused reduction handles empty input and integer series", "[statistics][kernel]") {
+    ReduceResult empty = reduceFused(static_cast<const double*>(nullptr), 0, 0.0);
+    REQUIRE(empty.count == 0);
+    REQUIRE(empty.mean() == 0.0);
+    REQUIRE(empty.variance() == 0.0);
+
+    std::vector<uint64_t> mb = {4000, 1000, 3000, 2000};
+    uint64_t exactSum = 0;
+    ReduceResult r = reduceFused(mb.data(), mb.size(), 4000.0, exactSum);
+    REQUIRE(exactSum == 10000);
+    REQUIRE(r.min == 1000.0);
+    REQUIRE(r.max == 4000.0);
+    REQUIRE(r.mean() == Catch::Approx(2500.0));
+    REQUIRE(std::sqrt(r.variance()) == Catch::Approx(std::sqrt(1250000.0)));
+}
+
+TEST_CASE("Statistics: vector path reports standard deviation", "[statistics][kernel]") {
+    CpuStats cpu = computeCpuStats({2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0});
+    REQUIRE(cpu.stddev == Catch::Approx(2.0));
+    GpuStats gpu = computeGpuStats({2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}, 1);
+    REQUIRE(gpu.stddevUtilization == Catch::Approx(2.0));
+    MemoryStats memory = computeMemoryStats({1000, 3000}, {10.0, 30.0});
+    REQUIRE(memory.avgUsedMB == 2000);
+    REQUIRE(memory.stddevUsedMB == Catch::Approx(1000.0));
+    REQUIRE(memory.stddevUsedPercent == Catch::Approx(10.0));
+}
+
+TEST_CASE("Fused reduction versus std algorithms", "[.][benchmark][kernel]") {
+    std::vector<double> values = utilizationValues(10000000, 11);
+
+    BENCHMARK("std max/accumulate/min (3 passes)") {
+        double peak = *std::max_element(values.begin(), values.end());
+        double avg = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        double low = *std::min_element(values.begin(), values.end());
+        return peak + avg + low;
+    };
+
+    for (ReduceIsa isa : {ReduceIsa::Scalar, ReduceIsa::Sse2, ReduceIsa::Avx2}) {
+        if (!isReduceIsaSupported(isa)) continue;
+        std::string name = std::string("fused ") + reduceIsaName(isa);
+        BENCHMARK(name.c_str()) {
+            return reduceFusedWith(isa, values.data(), values.size(), values[0]).sum;
+        };
+    }
+
+    BENCHMARK("computeCpuStats (dispatched)") {
+        return computeCpuStats(values).stddev;
+    };
+}
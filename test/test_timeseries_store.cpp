@@ -0,0 +1,108 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "utils/timeseries_store.hpp"
+#include <cmath>
+#include <limits>
+
+namespace {
+TimeSeriesConfig smallConfig() {
+    TimeSeriesConfig config;
+    config.rawCapacity = 5;
+    config.tiers = {{10 * 1000, 3}, {60 * 1000, 2}};
+    return config;
+}
+
+void addAll(TimeSeriesStore& store, int64_t timestampMs, double value) {
+    double values[TimeSeriesStore::MetricCount];
+    for (double& v : values) v = value;
+    store.add(timestampMs, values);
+}
+}
+
+TEST_CASE("RingBuffer overwrites the oldest element once full", "[timeseries]") {
+    RingBuffer<int> ring(3);
+    for (int i = 1; i <= 5; ++i) ring.push(i);
+    REQUIRE(ring.size() == 3);
+    REQUIRE(ring.at(0) == 3);
+    REQUIRE(ring.at(1) == 4);
+    REQUIRE(ring.back() == 5);
+}
+
+TEST_CASE("TimeSeriesStore keeps only the last raw samples", "[timeseries]") {
+    TimeSeriesStore store(smallConfig());
+    for (int i = 0; i < 8; ++i) addAll(store, i * 1000, i);
+    REQUIRE(store.rawSize() == 5);
+    REQUIRE(store.rawTimestamp(0) == 3000);
+    REQUIRE(store.rawValue(TimeSeriesStore::Cpu, 0) == 3.0);
+    REQUIRE(store.rawValue(TimeSeriesStore::Gpu, 4) == 7.0);
+}
+
+TEST_CASE("TimeSeriesStore rolls samples into aligned buckets at insert", "[timeseries]") {
+    TimeSeriesStore store(smallConfig());
+    // One sample per second for 25 s: buckets [0,10) and [10,20) close, [20,30) stays open
+    for (int i = 0; i < 25; ++i) addAll(store, i * 1000, i);
+
+    const auto& tens = store.tier(TimeSeriesStore::Cpu, 0);
+    REQUIRE(tens.size() == 2);
+    REQUIRE(tens.at(0).startMs == 0);
+    REQUIRE(tens.at(0).count == 10);
+    REQUIRE(tens.at(0).min == 0.0);
+    REQUIRE(tens.at(0).max == 9.0);
+    REQUIRE(tens.at(0).average() == Catch::Approx(4.5));
+    REQUIRE(tens.at(1).startMs == 10000);
+    REQUIRE(tens.at(1).average() == Catch::Approx(14.5));
+
+    const RollupBucket& open = store.openBucket(TimeSeriesStore::Cpu, 0);
+    REQUIRE(open.startMs == 20000);
+    REQUIRE(open.count == 5);
+    REQUIRE(open.max == 24.0);
+
+    // Nothing has crossed a minute boundary yet
+    REQUIRE(store.tier(TimeSeriesStore::Cpu, 1).empty());
+    REQUIRE(store.openBucket(TimeSeriesStore::Cpu, 1).count == 25);
+}
+
+TEST_CASE("TimeSeriesStore tiers are bounded and buckets skip idle gaps", "[timeseries]") {
+    TimeSeriesStore store(smallConfig());
+    addAll(store, 0, 1.0);
+    addAll(store, 65 * 1000, 2.0);       // Jumps past several empty 10 s buckets
+    addAll(store, 10 * 60 * 1000, 3.0);
+
+    const auto& tens = store.tier(TimeSeriesStore::MemoryUsedMB, 0);
+    REQUIRE(tens.size() == 2); // Empty buckets are not materialized
+    REQUIRE(tens.at(1).startMs == 60000);
+
+    for (int i = 0; i < 10; ++i) addAll(store, (11 + i) * 60 * 1000, 4.0);
+    REQUIRE(store.tier(TimeSeriesStore::MemoryUsedMB, 0).size() == 3);
+    REQUIRE(store.tier(TimeSeriesStore::MemoryUsedMB, 1).size() == 2);
+    REQUIRE(store.tier(TimeSeriesStore::MemoryUsedMB, 1).back().startMs == 19 * 60 * 1000);
+}
+
+TEST_CASE("TimeSeriesStore leaves unsampled metrics out of the rollups", "[timeseries]") {
+    TimeSeriesStore store(smallConfig());
+    for (int i = 0; i < 25; ++i) {
+        double values[TimeSeriesStore::MetricCount];
+        for (double& v : values) v = std::numeric_limits<double>::quiet_NaN();
+        values[TimeSeriesStore::Cpu] = i;
+        store.add(i * 1000, values);
+    }
+    REQUIRE(store.rawSize() == 5);
+    REQUIRE(store.rawValue(TimeSeriesStore::Cpu, 4) == 24.0);
+    REQUIRE(std::isnan(store.rawValue(TimeSeriesStore::MemoryUsedMB, 4)));
+    REQUIRE(store.tier(TimeSeriesStore::Cpu, 0).size() == 2);
+    REQUIRE(store.tier(TimeSeriesStore::MemoryUsedMB, 0).empty());
+    REQUIRE(store.openBucket(TimeSeriesStore::Gpu, 0).count == 0);
+}
+
+TEST_CASE("TimeSeriesStore footprint is fixed by its configuration", "[timeseries]") {
+    TimeSeriesStore store(smallConfig());
+    std::size_t before = store.footprintBytes();
+    REQUIRE(before > 0);
+    for (int i = 0; i < 10000; ++i) addAll(store, i * 1000, i % 100);
+    REQUIRE(store.footprintBytes() == before);
+
+    // Default tiers: 6 h of 10 s, 7 days of 1 min, 90 days of 1 h across five metrics
+    TimeSeriesStore defaults;
+    REQUIRE(defaults.footprintBytes() < 4 * 1024 * 1024);
+}